@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Alpha-beta tracker: smoothed value and rate of change of a noisy signal
+// that arrives at an irregular rate. Constant time and memory per sample.
+//
+// The gains are the critically damped (fading-memory) pair for a time
+// constant tau: theta = exp(-dt / tau), alpha = 1 - theta^2,
+// beta = (1 - theta)^2. Computing them from the actual sample interval keeps
+// the response the same at 5 Hz and at 50 Hz.
+class AlphaBetaFilter
+{
+public:
+    explicit AlphaBetaFilter(float tau_s, uint32_t max_gap_ms = 2000) : tau_s_(tau_s), max_gap_ms_(max_gap_ms) {}
+
+    // A gap longer than max_gap_ms restarts the track at z with zero rate.
+    void update(float z, uint32_t t_ms)
+    {
+        const uint32_t dt_ms = t_ms - last_ms_;
+        if (!valid_ || dt_ms > max_gap_ms_)
+        {
+            x_ = z;
+            v_ = 0;
+            last_ms_ = t_ms;
+            valid_ = true;
+            return;
+        }
+        if (dt_ms == 0) return;
+        last_ms_ = t_ms;
+
+        const float dt = dt_ms * 0.001f;
+        const float theta = std::exp(-dt / tau_s_);
+        const float alpha = 1.0f - theta * theta;
+        const float beta = (1.0f - theta) * (1.0f - theta);
+
+        x_ += v_ * dt;
+        const float r = z - x_;
+        x_ += alpha * r;
+        v_ += beta / dt * r;
+    }
+
+    void reset() { valid_ = false; }
+
+    bool valid() const { return valid_; }
+    float value() const { return x_; }
+    float rate() const { return v_; } // units per second
+
+private:
+    float tau_s_;
+    uint32_t max_gap_ms_;
+    bool valid_ = false;
+    uint32_t last_ms_ = 0;
+    float x_ = 0;
+    float v_ = 0;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "can_dispatch.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Receive filters derived at compile time from can_dispatch::kSignals, so the
+// hardware (TWAI) and the kernel (CAN_RAW_FILTER) only pass frames the
+// dispatcher actually consumes.
+namespace can_acceptance
+{
+    inline constexpr std::size_t kIdCount = can_dispatch::kSignals.size();
+
+    inline constexpr std::array<uint16_t, kIdCount> kIds = []
+    {
+        std::array<uint16_t, kIdCount> ids{};
+        for (std::size_t i = 0; i < kIdCount; ++i) ids[i] = can_dispatch::kSignals[i].id;
+        return ids;
+    }();
+
+    // An 11-bit id pattern: bits set in dont_care may take any value.
+    struct IdPattern
+    {
+        uint16_t code;
+        uint16_t dont_care;
+
+        constexpr uint32_t accepted_ids() const { return 1u << std::popcount(dont_care); }
+        constexpr bool matches(uint16_t id) const { return ((id ^ code) & ~dont_care & 0x7FFu) == 0; }
+    };
+
+    // Tightest single pattern covering every id whose bit is set in subset.
+    constexpr IdPattern cover(uint32_t subset)
+    {
+        IdPattern p{0, 0};
+        bool first = true;
+        for (std::size_t i = 0; i < kIdCount; ++i)
+        {
+            if (!(subset & (1u << i))) continue;
+            if (first)
+            {
+                p.code = kIds[i];
+                first = false;
+            }
+            p.dont_care |= static_cast<uint16_t>(p.code ^ kIds[i]);
+        }
+        p.code &= static_cast<uint16_t>(~p.dont_care & 0x7FFu);
+        return p;
+    }
+
+    struct Plan
+    {
+        bool dual;
+        IdPattern first;
+        IdPattern second; // only meaningful when dual
+        uint32_t accepted_ids;
+    };
+
+    // Tries every split of the id set into two patterns (dual filter mode)
+    // and keeps it if it lets fewer foreign ids through than one pattern.
+    constexpr Plan best_plan()
+    {
+        static_assert(kIdCount < 20, "exhaustive split search is only meant for a small id set");
+        constexpr uint32_t all = (1u << kIdCount) - 1u;
+
+        const IdPattern single = cover(all);
+        Plan best{false, single, single, single.accepted_ids()};
+        for (uint32_t subset = 1; subset < all; ++subset)
+        {
+            if (!(subset & 1u)) continue; // {A,B} and {B,A} are the same split
+            const IdPattern a = cover(subset);
+            const IdPattern b = cover(all & ~subset);
+            const uint32_t accepted = a.accepted_ids() + b.accepted_ids();
+            if (accepted < best.accepted_ids) best = {true, a, b, accepted};
+        }
+        return best;
+    }
+
+    inline constexpr Plan kPlan = best_plan();
+
+    // TWAI/SJA1000 acceptance register layout for standard frames; a set mask
+    // bit means "don't care". RTR must be 0 (data frames only).
+    //   single: id [31:21], rtr [20], data bytes [19:0]
+    //   dual:   filter 1 id [31:21], rtr [20], data byte 1 [19:16] + [3:0]
+    //           filter 2 id [15:5],  rtr [4]
+    struct TwaiAcceptance
+    {
+        uint32_t code;
+        uint32_t mask;
+        bool single_filter;
+    };
+
+    inline constexpr TwaiAcceptance kTwai = []
+    {
+        if (!kPlan.dual)
+        {
+            return TwaiAcceptance{static_cast<uint32_t>(kPlan.first.code) << 21,
+                                  (static_cast<uint32_t>(kPlan.first.dont_care) << 21) | 0x000FFFFFu,
+                                  true};
+        }
+        return TwaiAcceptance{(static_cast<uint32_t>(kPlan.first.code) << 21) |
+                                  (static_cast<uint32_t>(kPlan.second.code) << 5),
+                              (static_cast<uint32_t>(kPlan.first.dont_care) << 21) | 0x000F000Fu |
+                                  (static_cast<uint32_t>(kPlan.second.dont_care) << 5),
+                              false};
+    }();
+
+    constexpr bool plan_accepts(uint16_t id)
+    {
+        return kPlan.first.matches(id) || (kPlan.dual && kPlan.second.matches(id));
+    }
+
+    static_assert([]
+    {
+        for (uint16_t id : kIds)
+            if (!plan_accepts(id)) return false;
+        return true;
+    }(), "acceptance filter must pass every consumed id");
+} // namespace can_acceptance
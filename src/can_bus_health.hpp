@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// CAN controller health, filled by the platform front-end (the TWAI alert
+// monitor on the device) and shown by the diagnostics output and the Live
+// Params screen. Published through a Seqlock by a single writer.
+struct CanBusHealth
+{
+    enum class State : uint8_t
+    {
+        Unknown,      // no controller (simulator) or not started yet
+        Running,      // error active
+        Warning,      // an error counter passed the warning limit
+        ErrorPassive,
+        BusOff,
+        Recovering,   // bus-off recovery in progress
+    };
+
+    State state = State::Unknown;
+    uint32_t tx_error_counter = 0;
+    uint32_t rx_error_counter = 0;
+    uint32_t bus_errors = 0;
+    uint32_t arbitration_lost = 0;
+    uint32_t rx_missed = 0;  // dropped because the driver RX queue was full
+    uint32_t rx_overrun = 0; // dropped by the controller FIFO
+    uint32_t error_passive_events = 0;
+    uint32_t bus_off_events = 0;
+    uint32_t recoveries = 0;
+    uint32_t last_recovery_ms = 0; // bus-off to running again
+    uint32_t max_recovery_ms = 0;
+    // Share of the bit rate used by frames this node received, in 0.1 %.
+    // The acceptance filter hides foreign traffic, so this is a lower bound.
+    uint16_t rx_load_permille = 0;
+
+    static const char* state_name(State s)
+    {
+        switch (s)
+        {
+        case State::Running: return "OK";
+        case State::Warning: return "WARN";
+        case State::ErrorPassive: return "PASSIVE";
+        case State::BusOff: return "BUS-OFF";
+        case State::Recovering: return "RECOVER";
+        default: return "n/a";
+        }
+    }
+
+    // Bits on the wire for a data frame: 47 (standard) or 67 (extended)
+    // framing bits plus the payload, with typical stuffing of one bit in ten.
+    static constexpr uint32_t frame_bits(uint8_t dlc, bool extended)
+    {
+        return ((extended ? 67u : 47u) + 8u * dlc) * 11u / 10u;
+    }
+};
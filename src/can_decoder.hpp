@@ -4,9 +4,41 @@
 #include <cstring>
 #include <bit>
 
+// CANaerospace data types (byte 1 of the frame header) used on this bus.
+enum class CanAerospaceType : uint8_t
+{
+    NoData = 0,
+    Error = 1,
+    Float = 2,
+    Long = 3,
+    ULong = 4,
+    Short = 6,
+    UShort = 7,
+    Char = 9,
+    UChar = 10,
+    Char2 = 18,
+    UChar2 = 19,
+    DoubleH = 30,
+    DoubleL = 31,
+};
+
+// First four bytes of every CANaerospace frame.
+struct CanAerospaceHeader
+{
+    uint8_t node_id;
+    CanAerospaceType data_type;
+    uint8_t service_code;
+    uint8_t message_code; // increments by one per transmission of an ID
+};
+
 class CANDecoder
 {
 public:
+    static CanAerospaceHeader decode_header(const uint8_t* data)
+    {
+        return {data[0], static_cast<CanAerospaceType>(data[1]), data[2], data[3]};
+    }
+
     static float decode_float(const uint8_t* data)
     {
         uint32_t raw;
@@ -15,12 +47,26 @@ public:
         return std::bit_cast<float>(raw);
     }
 
-    static double decode_double_l(const uint8_t* data)
+    // Heading, track, wind direction: CANaerospace allows -180..180 as well
+    // as 0..360. -180..0 is moved to 180..360; anything else is returned as
+    // sent, so the schema range still rejects it.
+    static float decode_angle(const uint8_t* data)
+    {
+        const float deg = decode_float(data);
+        return deg >= -180.0f && deg < 0.0f ? deg + 360.0f : deg;
+    }
+
+    // GPS position (1036/1037): signed 32 bits in 1e-7 degrees.
+    static int32_t decode_s32(const uint8_t* data)
     {
         uint32_t raw;
         std::memcpy(&raw, data + 4, sizeof(raw));
-        raw = __builtin_bswap32(raw);
-        return static_cast<int32_t>(raw) / 1E7;
+        return static_cast<int32_t>(__builtin_bswap32(raw));
+    }
+
+    static double decode_double_l(const uint8_t* data)
+    {
+        return decode_s32(data) / 1E7;
     }
 
     static uint16_t decode_u16(const uint8_t* data)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "can_decoder.hpp"
+#include "flight_data.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// One entry per CANaerospace ID the display consumes: which decoder to run,
+// which FlightSnapshot field receives the value, the shortest DLC that carries
+// the payload, the CANaerospace data type the sender must declare and which
+// FlightSignal receive timestamp the frame refreshes.
+//
+// apply() only writes the field if the sample passes the schema's checks.
+enum class SampleCheck : uint8_t
+{
+    Ok,
+    OutOfRange,  // outside the schema's lo..hi
+    DecodeError, // NaN or infinity
+};
+
+struct CanSignal
+{
+    uint16_t id;
+    SampleCheck (*apply)(FlightSnapshot& data, const uint8_t* frame);
+    uint8_t min_dlc;
+    CanAerospaceType data_type;
+    FlightSignal signal;
+};
+
+namespace can_dispatch
+{
+    template <auto Field, auto Decode, float Lo, float Hi>
+    SampleCheck store(FlightSnapshot& data, const uint8_t* frame)
+    {
+        const auto value = Decode(frame);
+        if constexpr (std::is_floating_point_v<decltype(value)>)
+        {
+            if (!std::isfinite(value)) return SampleCheck::DecodeError;
+        }
+        if (!(value >= Lo && value <= Hi)) return SampleCheck::OutOfRange;
+        data.*Field = value;
+        return SampleCheck::Ok;
+    }
+
+    // Frame length that carries the 4-byte header plus a payload of type t.
+    constexpr uint8_t min_dlc(CanAerospaceType t)
+    {
+        switch (t)
+        {
+        case CanAerospaceType::Char:
+        case CanAerospaceType::UChar: return 5;
+        case CanAerospaceType::Short:
+        case CanAerospaceType::UShort:
+        case CanAerospaceType::Char2:
+        case CanAerospaceType::UChar2: return 6;
+        default: return 8;
+        }
+    }
+
+    // Generated from FLIGHT_SIGNALS, then sorted by id so lookup is a binary
+    // search over a handful of entries.
+    inline constexpr std::array kSignals = []
+    {
+        auto table = std::to_array<CanSignal>({
+#define CAN_DISPATCH_ENTRY(sig, field, type, unit, scale, decimals, lo, hi, can_id, can_type, decode, staleness) \
+    {can_id, &store<&FlightSnapshot::field, &CANDecoder::decode, float(lo), float(hi)>,                          \
+     min_dlc(CanAerospaceType::can_type), CanAerospaceType::can_type, FlightSignal::sig},
+            FLIGHT_SIGNALS(CAN_DISPATCH_ENTRY)
+#undef CAN_DISPATCH_ENTRY
+        });
+        std::sort(table.begin(), table.end(), [](const CanSignal& a, const CanSignal& b) { return a.id < b.id; });
+        return table;
+    }();
+
+    static_assert(std::adjacent_find(kSignals.begin(), kSignals.end(),
+                                     [](const CanSignal& a, const CanSignal& b) { return a.id == b.id; }) ==
+                      kSignals.end(),
+                  "FLIGHT_SIGNALS lists a CAN id twice");
+
+    // Position of a signal in kSignals, for per-ID arrays indexed like the table.
+    constexpr std::size_t index_of(const CanSignal* sig) { return static_cast<std::size_t>(sig - kSignals.data()); }
+
+    constexpr const CanSignal* find(uint32_t id)
+    {
+        const auto it = std::lower_bound(kSignals.begin(), kSignals.end(), id,
+                                         [](const CanSignal& s, uint32_t v) { return s.id < v; });
+        return (it != kSignals.end() && it->id == id) ? &*it : nullptr;
+    }
+} // namespace can_dispatch
@@ -0,0 +1,153 @@
+#include "can_ingest.hpp"
+#include "can_decoder.hpp"
+#include "can_trace.hpp"
+#include "derived_quantities.hpp"
+#include "signal_history.hpp"
+
+#include <algorithm>
+
+bool CanIngest::on_frame(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms)
+{
+    frames_.bump();
+    if (recorder_) recorder_->write(id, dlc, data, timestamp_ms);
+
+    const CanSignal* sig = (id & kExtendedFlag) ? nullptr : can_dispatch::find(id);
+    if (!sig)
+    {
+        ignored_.bump();
+        return false;
+    }
+    if (dlc < sig->min_dlc)
+    {
+        short_frames_.bump();
+        flag(sig->signal, SampleCheck::DecodeError);
+        return false;
+    }
+
+    IdState& st = ids_[can_dispatch::index_of(sig)];
+    const CanAerospaceHeader header = CANDecoder::decode_header(data);
+    if (header.data_type == CanAerospaceType::NoData)
+    {
+        // Test tools and some loggers leave the header zeroed; keep decoding
+        // those, there is just no sequence to follow.
+        st.untyped.bump();
+    }
+    else if (header.data_type != sig->data_type)
+    {
+        st.type_errors.bump();
+        type_errors_.bump();
+        flag(sig->signal, SampleCheck::DecodeError);
+        return false;
+    }
+    else
+    {
+        track_sequence(st, header.message_code);
+    }
+    st.frames.bump();
+    track_rate(st, timestamp_ms);
+
+    const SampleCheck check = sig->apply(data_.pending, data);
+    if (check != SampleCheck::Ok)
+    {
+        rejected_.bump();
+        flag(sig->signal, check);
+        return false;
+    }
+    flag(sig->signal, SampleCheck::Ok);
+    data_.pending.rx_ms[static_cast<std::size_t>(sig->signal)] = static_cast<uint32_t>(timestamp_ms);
+    if (derived_) derived_->on_sample(sig->signal, data_.pending, static_cast<uint32_t>(timestamp_ms));
+    if (history_) history_->add(sig->signal, data_.pending, static_cast<uint32_t>(timestamp_ms));
+    last_frame_ms_ = static_cast<uint32_t>(timestamp_ms);
+    consumed_.bump();
+    dirty_ |= signal_mask(sig->signal);
+    accepted_ |= signal_mask(sig->signal);
+    return true;
+}
+
+void CanIngest::flag(FlightSignal signal, SampleCheck check)
+{
+    FlightSnapshot& s = data_.pending;
+    const SignalMask bit = signal_mask(signal);
+    const SignalMask out_of_range = check == SampleCheck::OutOfRange ? bit : 0;
+    const SignalMask decode_error = check == SampleCheck::DecodeError ? bit : 0;
+    // Only a change of verdict needs publishing; a good sample marks the
+    // signal dirty anyway.
+    if ((s.out_of_range & bit) == out_of_range && (s.decode_error & bit) == decode_error) return;
+    s.out_of_range = (s.out_of_range & ~bit) | out_of_range;
+    s.decode_error = (s.decode_error & ~bit) | decode_error;
+    dirty_ |= bit;
+}
+
+void CanIngest::track_sequence(IdState& st, uint8_t message_code)
+{
+    if (st.have_code)
+    {
+        const uint8_t step = static_cast<uint8_t>(message_code - st.last_code);
+        if (step == 0)
+            st.duplicates.bump();
+        else if (step > 1)
+            st.lost.add(step - 1u);
+    }
+    st.have_code = true;
+    st.last_code = message_code;
+}
+
+static uint64_t rate_window(uint32_t start_ms, uint32_t frames) { return uint64_t{start_ms} << 32 | frames; }
+
+void CanIngest::track_rate(IdState& st, uint64_t timestamp_ms)
+{
+    const uint64_t window = st.window.load(std::memory_order_relaxed);
+    const uint32_t start_ms = static_cast<uint32_t>(window >> 32);
+    const uint32_t frames = static_cast<uint32_t>(window);
+    const uint32_t now_ms = static_cast<uint32_t>(timestamp_ms);
+    if (frames == 0)
+    {
+        st.window.store(rate_window(now_ms, 1), std::memory_order_relaxed);
+        return;
+    }
+    const uint32_t elapsed = now_ms - start_ms;
+    if (elapsed < kRateWindowMs)
+    {
+        st.window.store(rate_window(start_ms, frames + 1), std::memory_order_relaxed);
+        return;
+    }
+    st.rate_mhz.store(static_cast<uint32_t>(frames * 1000000ULL / elapsed), std::memory_order_relaxed);
+    st.window.store(rate_window(now_ms, 1), std::memory_order_relaxed);
+}
+
+void CanIngest::publish()
+{
+    if (!dirty_) return;
+    // Only accepted samples count as bus values for the derived rules; a
+    // rejected bus wind must not hold off the estimate.
+    if (derived_) dirty_ |= derived_->update(data_.pending, accepted_, last_frame_ms_);
+    data_.publish(dirty_);
+    dirty_ = 0;
+    accepted_ = 0;
+    publishes_.bump();
+}
+
+CanIngest::Stats CanIngest::stats() const
+{
+    return {frames_.get(), consumed_.get(), ignored_.get(), short_frames_.get(),
+            type_errors_.get(), rejected_.get(), publishes_.get()};
+}
+
+CanIngest::IdStats CanIngest::id_stats(std::size_t index, uint64_t now_ms) const
+{
+    const IdState& st = ids_[index];
+    uint32_t rate_mhz = st.rate_mhz.load(std::memory_order_relaxed);
+    // The rate is only updated by a frame that closes the window. Past the
+    // window length without one, the open window gives the lower rate; a
+    // window left open for two lengths means the ID went silent. Negative
+    // means frames stamped ahead of now (replay at full speed).
+    const uint64_t window = st.window.load(std::memory_order_relaxed);
+    const uint32_t frames = static_cast<uint32_t>(window);
+    const int32_t open_ms = static_cast<int32_t>(static_cast<uint32_t>(now_ms) - static_cast<uint32_t>(window >> 32));
+    if (frames != 0 && open_ms >= static_cast<int32_t>(2 * kRateWindowMs))
+        rate_mhz = 0;
+    else if (frames != 0 && open_ms >= static_cast<int32_t>(kRateWindowMs))
+        rate_mhz = std::min(rate_mhz, static_cast<uint32_t>(frames * 1000000ULL / static_cast<uint32_t>(open_ms)));
+    return {can_dispatch::kSignals[index].id, st.frames.get(), st.lost.get(), st.duplicates.get(),
+            st.type_errors.get(), st.untyped.get(), rate_mhz};
+}
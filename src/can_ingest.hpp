@@ -0,0 +1,138 @@
+#pragma once
+
+#include "can_dispatch.hpp"
+#include "flight_data.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class CanTraceWriter;
+class DerivedQuantities;
+class FlightHistory;
+
+// Platform-neutral CAN receive core. The TWAI task on the device and the
+// SocketCAN thread in the simulator only fetch frames and hand them over
+// here, so decoding, staleness and statistics behave the same on both.
+//
+// Single producer: on_frame()/publish() must be called from one thread.
+// stats() may be read from anywhere.
+class CanIngest
+{
+public:
+    // Set on ids of 29-bit frames (same bit as Linux CAN_EFF_FLAG).
+    static constexpr uint32_t kExtendedFlag = 0x80000000U;
+
+    struct Stats
+    {
+        uint32_t frames;       // everything handed to on_frame()
+        uint32_t consumed;     // decoded into FlightData
+        uint32_t ignored;      // extended or not one of ours
+        uint32_t short_frames; // ours, but DLC too small for the payload
+        uint32_t type_errors;  // ours, but the header declares another data type
+        uint32_t rejected;     // decoded, but NaN or outside the schema range
+        uint32_t publishes;    // snapshot publications
+    };
+
+    // Bus quality for one consumed ID, from the CANaerospace header.
+    struct IdStats
+    {
+        uint16_t id;
+        uint32_t frames;      // accepted frames
+        uint32_t lost;        // gaps in the rolling message code
+        uint32_t duplicates;  // message code repeated
+        uint32_t type_errors; // rejected, wrong data type
+        uint32_t untyped;     // header left empty (NODATA); decoded without sequence check
+        uint32_t rate_mhz;    // receive rate over the last second, in millihertz; 0 once silent
+    };
+
+    static constexpr std::size_t kIdCount = can_dispatch::kSignals.size();
+
+    explicit CanIngest(FlightData& data) : data_(data) {}
+
+    // Decodes one frame into the pending flight state without publishing it.
+    // timestamp_ms is the receive time on the FlightData::monotonic_ms() clock.
+    // Returns true if the frame changed the pending state. Short, mistyped and
+    // rejected frames keep the last good value and set the signal's
+    // out_of_range or decode_error bit instead.
+    bool on_frame(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms);
+
+    // Makes everything staged since the last call visible to readers.
+    void publish();
+
+    // Convenience for front-ends that handle one frame at a time.
+    bool ingest(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms)
+    {
+        const bool used = on_frame(id, dlc, data, timestamp_ms);
+        publish();
+        return used;
+    }
+
+    Stats stats() const;
+
+    // Every frame handed to on_frame() is also appended to recorder, before
+    // any filtering. Pass nullptr to stop recording. Set from the ingest
+    // thread or before it starts.
+    void set_recorder(CanTraceWriter* recorder) { recorder_ = recorder; }
+
+    // Every decoded sample of a tracked signal is also added to history.
+    // Same threading rules as set_recorder().
+    void set_history(FlightHistory* history) { history_ = history; }
+
+    // Fills in derived values: the IAS trend with every frame, TAS and wind
+    // before each publish. Same threading rules as set_recorder().
+    void set_derived(DerivedQuantities* derived) { derived_ = derived; }
+
+    // index is the position of the ID in can_dispatch::kSignals. now_ms is
+    // on the FlightData::monotonic_ms() clock: an ID that has gone quiet
+    // reports a falling rate, and 0 after two seconds without a frame.
+    IdStats id_stats(std::size_t index, uint64_t now_ms) const;
+
+private:
+    struct Counter
+    {
+        std::atomic<uint32_t> value{0};
+        // Only the ingest thread writes, so a plain load/store is enough.
+        void add(uint32_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        void bump() { add(1); }
+        uint32_t get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    struct IdState
+    {
+        Counter frames;
+        Counter lost;
+        Counter duplicates;
+        Counter type_errors;
+        Counter untyped;
+        std::atomic<uint32_t> rate_mhz{0};
+        // Open rate window: start time in ms (high half) and frames counted
+        // since (low half), in one word so id_stats() reads them together.
+        std::atomic<uint64_t> window{0};
+        // Ingest thread only.
+        bool have_code = false;
+        uint8_t last_code = 0;
+    };
+
+    static constexpr uint32_t kRateWindowMs = 1000;
+
+    void flag(FlightSignal signal, SampleCheck check);
+    static void track_sequence(IdState& st, uint8_t message_code);
+    static void track_rate(IdState& st, uint64_t timestamp_ms);
+
+    FlightData& data_;
+    CanTraceWriter* recorder_ = nullptr;
+    FlightHistory* history_ = nullptr;
+    DerivedQuantities* derived_ = nullptr;
+    uint32_t last_frame_ms_ = 0; // receive time of the newest decoded frame
+    std::array<IdState, kIdCount> ids_;
+    SignalMask dirty_ = 0;    // signals staged since the last publish
+    SignalMask accepted_ = 0; // subset of dirty_ with a new value from the bus
+    Counter frames_;
+    Counter consumed_;
+    Counter ignored_;
+    Counter short_frames_;
+    Counter type_errors_;
+    Counter rejected_;
+    Counter publishes_;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "can_dispatch.hpp"
+#include "can_ingest.hpp"
+#include "seqlock.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Lock-free hand-over between the CAN receive path (producer) and the ingest
+// task (consumer).
+//
+// Every frame goes into a single-producer/single-consumer ring. Frames for
+// consumed IDs are also written to a per-ID "latest value" slot (payload,
+// timestamp, sequence). The producer never waits: when the ring is full the
+// frame is counted as an overrun and only its slot is updated, and drain()
+// picks the newest value up from there. The consumer therefore always ends a
+// drain with the freshest value of every signal, even after a burst.
+template <std::size_t Capacity>
+class CanRxQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr std::size_t kSlotCount = can_dispatch::kSignals.size();
+    static constexpr uint8_t kNoSlot = 0xFF;
+
+    struct Counters
+    {
+        uint32_t pushed;      // frames offered by the producer
+        uint32_t overruns;    // ring full, frame kept only in its latest slot
+        uint32_t recovered;   // latest values applied from a slot instead of the ring
+        uint32_t superseded;  // ring entries skipped because a newer value was already applied
+    };
+
+    // Producer side. Never blocks.
+    void push(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms)
+    {
+        Entry e;
+        e.id = id;
+        e.dlc = dlc > 8 ? 8 : dlc;
+        std::memset(e.data, 0, sizeof(e.data));
+        std::memcpy(e.data, data, e.dlc);
+        e.timestamp_ms = timestamp_ms;
+        e.slot = slot_index(id);
+        e.slot_seq = 0;
+
+        if (e.slot != kNoSlot)
+        {
+            SlotValue v;
+            std::memcpy(v.data, e.data, sizeof(v.data));
+            v.dlc = e.dlc;
+            v.timestamp_ms = timestamp_ms;
+            slots_[e.slot].store(v);
+            e.slot_seq = slots_[e.slot].sequence();
+        }
+        bump(pushed_);
+
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity)
+        {
+            bump(overruns_);
+            return;
+        }
+        ring_[head & (Capacity - 1)] = e;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Consumer side. Feeds everything queued so far into ingest, then any
+    // latest values the ring had to drop, and publishes once. Returns the
+    // number of frames handed to ingest.
+    std::size_t drain(CanIngest& ingest)
+    {
+        std::size_t n = 0;
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        while (tail != head)
+        {
+            const Entry& e = ring_[tail & (Capacity - 1)];
+            if (e.slot != kNoSlot && !newer(e.slot_seq, applied_seq_[e.slot]))
+            {
+                bump(superseded_);
+            }
+            else
+            {
+                if (e.slot != kNoSlot) applied_seq_[e.slot] = e.slot_seq;
+                ingest.on_frame(e.id, e.dlc, e.data, e.timestamp_ms);
+                ++n;
+            }
+            ++tail;
+        }
+        tail_.store(tail, std::memory_order_release);
+
+        for (std::size_t i = 0; i < kSlotCount; ++i)
+        {
+            if (slots_[i].sequence() == applied_seq_[i]) continue;
+            uint32_t seq;
+            const SlotValue v = slots_[i].load(&seq);
+            if (!newer(seq, applied_seq_[i])) continue;
+            applied_seq_[i] = seq;
+            ingest.on_frame(can_dispatch::kSignals[i].id, v.dlc, v.data, v.timestamp_ms);
+            bump(recovered_);
+            ++n;
+        }
+
+        ingest.publish();
+        return n;
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Safe to call from any thread.
+    Counters counters() const
+    {
+        return {pushed_.load(std::memory_order_relaxed), overruns_.load(std::memory_order_relaxed),
+                recovered_.load(std::memory_order_relaxed), superseded_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    struct Entry
+    {
+        uint32_t id;
+        uint32_t slot_seq;
+        uint64_t timestamp_ms;
+        uint8_t data[8];
+        uint8_t dlc;
+        uint8_t slot;
+    };
+
+    struct SlotValue
+    {
+        uint64_t timestamp_ms;
+        uint8_t data[8];
+        uint8_t dlc;
+    };
+
+    static uint8_t slot_index(uint32_t id)
+    {
+        if (id & CanIngest::kExtendedFlag) return kNoSlot;
+        const CanSignal* sig = can_dispatch::find(id);
+        return sig ? static_cast<uint8_t>(can_dispatch::index_of(sig)) : kNoSlot;
+    }
+
+    // Wrap-safe "a is a later sequence than b".
+    static bool newer(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+
+    // Each counter has exactly one writing side.
+    static void bump(std::atomic<uint32_t>& c)
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<Entry, Capacity> ring_{};
+    alignas(64) std::atomic<uint32_t> head_{0};
+    alignas(64) std::atomic<uint32_t> tail_{0};
+
+    std::array<Seqlock<SlotValue>, kSlotCount> slots_{};
+    std::array<uint32_t, kSlotCount> applied_seq_{}; // consumer only
+
+    std::atomic<uint32_t> pushed_{0};
+    std::atomic<uint32_t> overruns_{0};
+    std::atomic<uint32_t> recovered_{0};
+    std::atomic<uint32_t> superseded_{0};
+};
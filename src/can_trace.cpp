@@ -0,0 +1,221 @@
+#include "can_trace.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+constexpr std::size_t kWriteBuffer = 4096;
+}
+
+CanTraceWriter::~CanTraceWriter()
+{
+    close();
+}
+
+bool CanTraceWriter::open(const char* path, uint32_t max_records)
+{
+    close();
+    file_ = std::fopen(path, "wb");
+    if (!file_) return false;
+
+    // Frames arrive one at a time; let stdio batch them into block writes.
+    buffer_ = static_cast<char*>(std::malloc(kWriteBuffer));
+    if (buffer_) std::setvbuf(file_, buffer_, _IOFBF, kWriteBuffer);
+
+    CanTraceHeader header{};
+    std::memcpy(header.magic, CanTraceHeader::kMagic, sizeof(header.magic));
+    header.version = CanTraceHeader::kVersion;
+    header.record_size = sizeof(CanTraceRecord);
+    header.index_offset = 0;
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1)
+    {
+        close();
+        return false;
+    }
+    max_records_ = max_records;
+    records_ = 0;
+    dropped_ = 0;
+    last_ts_ = 0;
+    index_interval_ms_ = 0;
+    next_index_ms_ = 0;
+    index_.clear();
+    return true;
+}
+
+void CanTraceWriter::close()
+{
+    if (file_)
+    {
+        if (index_interval_ms_ != 0)
+        {
+            const long offset = std::ftell(file_);
+            const CanTraceIndexHeader ih{index_interval_ms_, static_cast<uint32_t>(index_.size())};
+            const uint64_t index_offset = static_cast<uint64_t>(offset);
+            const bool ok = offset > 0 && std::fwrite(&ih, sizeof(ih), 1, file_) == 1 &&
+                std::fwrite(index_.data(), sizeof(CanTraceIndexEntry), index_.size(), file_) == index_.size();
+            // Only point the header at a complete index.
+            if (ok && std::fseek(file_, offsetof(CanTraceHeader, index_offset), SEEK_SET) == 0)
+                std::fwrite(&index_offset, sizeof(index_offset), 1, file_);
+        }
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    std::free(buffer_);
+    buffer_ = nullptr;
+}
+
+bool CanTraceWriter::write(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms)
+{
+    if (!file_) return false;
+    if (max_records_ != 0 && records_ >= max_records_)
+    {
+        ++dropped_;
+        return false;
+    }
+    if (records_ == 0) first_ms_ = timestamp_ms;
+
+    CanTraceRecord rec{};
+    // Clamp clock steps backwards so timestamps stay sorted for seek().
+    rec.timestamp_ms = timestamp_ms > first_ms_ ? static_cast<uint32_t>(timestamp_ms - first_ms_) : 0;
+    rec.timestamp_ms = std::max(rec.timestamp_ms, last_ts_);
+    rec.id = id;
+    rec.dlc = dlc > 8 ? 8 : dlc;
+    std::memcpy(rec.data, data, rec.dlc);
+
+    if (std::fwrite(&rec, sizeof(rec), 1, file_) != 1)
+    {
+        ++dropped_;
+        return false;
+    }
+    if (index_interval_ms_ != 0 && rec.timestamp_ms >= next_index_ms_)
+    {
+        index_.push_back({rec.timestamp_ms, records_});
+        next_index_ms_ = (rec.timestamp_ms / index_interval_ms_ + 1) * index_interval_ms_;
+    }
+    last_ts_ = rec.timestamp_ms;
+    ++records_;
+    return true;
+}
+
+void CanTraceWriter::flush()
+{
+    if (file_) std::fflush(file_);
+}
+
+CanTraceReader::~CanTraceReader()
+{
+    close();
+}
+
+bool CanTraceReader::open(const char* path)
+{
+    close();
+    file_ = std::fopen(path, "rb");
+    if (!file_) return false;
+
+    if (std::fread(&header_, sizeof(header_), 1, file_) != 1 ||
+        std::memcmp(header_.magic, CanTraceHeader::kMagic, sizeof(header_.magic)) != 0 ||
+        header_.version != CanTraceHeader::kVersion ||
+        header_.record_size != sizeof(CanTraceRecord))
+    {
+        std::fprintf(stderr, "trace: %s is not a version %u CAN trace\n", path, CanTraceHeader::kVersion);
+        close();
+        return false;
+    }
+
+    std::fseek(file_, 0, SEEK_END);
+    const uint64_t file_size = static_cast<uint64_t>(std::ftell(file_));
+    // An index offset outside the file is damage, not the end of the
+    // records: read up to the end of the file instead.
+    const bool index_in_file =
+        header_.index_offset >= sizeof(CanTraceHeader) && header_.index_offset <= file_size;
+    const uint64_t end = index_in_file ? header_.index_offset : file_size;
+    record_count_ = (end - sizeof(CanTraceHeader)) / sizeof(CanTraceRecord);
+    if (header_.index_offset != 0 && (!index_in_file || !load_index(file_size)))
+    {
+        std::fprintf(stderr, "trace: %s has a damaged index, seeking by scan\n", path);
+        index_.clear();
+    }
+    return rewind();
+}
+
+void CanTraceReader::close()
+{
+    if (file_)
+    {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    record_count_ = 0;
+    position_ = 0;
+    index_.clear();
+    has_peeked_ = false;
+}
+
+bool CanTraceReader::load_index(uint64_t file_size)
+{
+    CanTraceIndexHeader ih{};
+    if (std::fseek(file_, static_cast<long>(header_.index_offset), SEEK_SET) != 0 ||
+        std::fread(&ih, sizeof(ih), 1, file_) != 1)
+        return false;
+    // Checked against what is left of the file before allocating for it.
+    const uint64_t room = file_size - header_.index_offset - sizeof(ih);
+    if (ih.entry_count > room / sizeof(CanTraceIndexEntry)) return false;
+    index_.resize(ih.entry_count);
+    if (std::fread(index_.data(), sizeof(CanTraceIndexEntry), index_.size(), file_) != index_.size()) return false;
+    return std::all_of(index_.begin(), index_.end(),
+                       [this](const CanTraceIndexEntry& e) { return e.record < record_count_; });
+}
+
+bool CanTraceReader::next(CanTraceRecord& out)
+{
+    if (has_peeked_)
+    {
+        out = peeked_;
+        has_peeked_ = false;
+        return true;
+    }
+    if (!file_ || position_ >= record_count_) return false;
+    if (std::fread(&out, sizeof(out), 1, file_) != 1) return false;
+    ++position_;
+    return true;
+}
+
+bool CanTraceReader::rewind()
+{
+    return seek_record(0);
+}
+
+bool CanTraceReader::seek_record(uint64_t record)
+{
+    if (!file_) return false;
+    has_peeked_ = false;
+    position_ = record;
+    const uint64_t offset = sizeof(CanTraceHeader) + record * sizeof(CanTraceRecord);
+    return std::fseek(file_, static_cast<long>(offset), SEEK_SET) == 0;
+}
+
+bool CanTraceReader::seek(uint32_t timestamp_ms)
+{
+    uint64_t start = 0;
+    const auto it = std::upper_bound(index_.begin(), index_.end(), timestamp_ms,
+                                     [](uint32_t t, const CanTraceIndexEntry& e) { return t < e.timestamp_ms; });
+    if (it != index_.begin()) start = std::prev(it)->record;
+    if (!seek_record(start)) return false;
+
+    // At most one index interval of records to skip.
+    CanTraceRecord rec;
+    while (next(rec))
+    {
+        if (rec.timestamp_ms >= timestamp_ms)
+        {
+            peeked_ = rec;
+            has_peeked_ = true;
+            return true;
+        }
+    }
+    return false;
+}
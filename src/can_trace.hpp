@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Compact binary CAN trace, written by the recorder on both platforms and
+// read by the simulator's replay.
+//
+// Layout (little-endian, as on both the ESP32-S3 and the host):
+//   CanTraceHeader
+//   CanTraceRecord * n          in receive order
+//   optional index (see index_offset)
+//
+// Record timestamps are milliseconds since the first recorded frame, which
+// covers about 49 days of trace, and never decrease.
+struct CanTraceHeader
+{
+    static constexpr char kMagic[4] = {'F', 'S', 'C', 'T'};
+    static constexpr uint16_t kVersion = 1;
+
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    // File offset of the trailing time index, 0 if the trace has none.
+    uint64_t index_offset;
+};
+
+struct CanTraceRecord
+{
+    uint32_t timestamp_ms;
+    uint32_t id; // CanIngest::kExtendedFlag set for 29-bit frames
+    uint8_t dlc;
+    uint8_t reserved[3];
+    uint8_t data[8];
+};
+
+// Sparse time index behind the records: a CanTraceIndexHeader followed by
+// entry_count entries, one per interval_ms of trace time that has frames.
+struct CanTraceIndexHeader
+{
+    uint32_t interval_ms;
+    uint32_t entry_count;
+};
+
+struct CanTraceIndexEntry
+{
+    uint32_t timestamp_ms; // of the record below
+    uint32_t record;       // first record at or after the interval start
+};
+
+static_assert(sizeof(CanTraceHeader) == 16, "CanTraceHeader layout");
+static_assert(sizeof(CanTraceRecord) == 20, "CanTraceRecord layout");
+static_assert(sizeof(CanTraceIndexEntry) == 8, "CanTraceIndexEntry layout");
+
+// Appends frames to a trace file through a stdio buffer. Not thread-safe;
+// the ingest thread owns it.
+class CanTraceWriter
+{
+public:
+    CanTraceWriter() = default;
+    ~CanTraceWriter();
+
+    CanTraceWriter(const CanTraceWriter&) = delete;
+    CanTraceWriter& operator=(const CanTraceWriter&) = delete;
+
+    // max_records caps the file size (0 = unlimited); frames beyond it are
+    // counted as dropped.
+    bool open(const char* path, uint32_t max_records = 0);
+    // Finishes the trace; writes the time index if one was enabled.
+    void close();
+    bool is_open() const { return file_ != nullptr; }
+
+    // timestamp_ms is on any monotonic clock; the first frame becomes t = 0.
+    bool write(uint32_t id, uint8_t dlc, const uint8_t* data, uint64_t timestamp_ms);
+    void flush();
+
+    // Collect one index entry per interval_ms, written by close(). Call
+    // right after open(). Costs 8 bytes of RAM per interval.
+    void enable_index(uint32_t interval_ms) { index_interval_ms_ = interval_ms; }
+
+    uint32_t records() const { return records_; }
+    uint32_t index_entries() const { return static_cast<uint32_t>(index_.size()); }
+    // Frames not written: over max_records or a failed write (file system full).
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    char* buffer_ = nullptr;
+    uint64_t first_ms_ = 0;
+    uint32_t last_ts_ = 0;
+    uint32_t index_interval_ms_ = 0;
+    uint32_t next_index_ms_ = 0;
+    std::vector<CanTraceIndexEntry> index_;
+    uint32_t max_records_ = 0;
+    uint32_t records_ = 0;
+    uint32_t dropped_ = 0;
+};
+
+// Sequential reader for CanTraceWriter output.
+class CanTraceReader
+{
+public:
+    CanTraceReader() = default;
+    ~CanTraceReader();
+
+    CanTraceReader(const CanTraceReader&) = delete;
+    CanTraceReader& operator=(const CanTraceReader&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    // Returns false at the end of the records (or on a truncated record).
+    bool next(CanTraceRecord& out);
+
+    // Restarts at the first record.
+    bool rewind();
+
+    // Positions at the first record with timestamp >= timestamp_ms. Uses the
+    // time index if the trace has one, otherwise scans from the start.
+    // Returns false if no record is that late.
+    bool seek(uint32_t timestamp_ms);
+
+    const CanTraceHeader& header() const { return header_; }
+    uint64_t record_count() const { return record_count_; }
+    const std::vector<CanTraceIndexEntry>& index() const { return index_; }
+
+private:
+    bool seek_record(uint64_t record);
+    bool load_index(uint64_t file_size);
+
+    std::FILE* file_ = nullptr;
+    CanTraceHeader header_{};
+    uint64_t record_count_ = 0;
+    uint64_t position_ = 0;
+    std::vector<CanTraceIndexEntry> index_;
+    // One record read ahead by seek().
+    CanTraceRecord peeked_{};
+    bool has_peeked_ = false;
+};
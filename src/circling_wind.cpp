@@ -0,0 +1,112 @@
+#include "circling_wind.hpp"
+#include "fast_trig.hpp"
+
+#include <cmath>
+
+namespace
+{
+// Samples further apart than this break the track rate.
+constexpr uint32_t kMaxGapMs = 5000;
+constexpr uint32_t kMinFitSamples = 8;
+constexpr float kMinRadius = 8.0f;
+constexpr float kMaxRadius = 90.0f;
+constexpr double kInitialCovariance = 1e6;
+} // namespace
+
+void CirclingWind::restart_fit()
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        theta_[i] = 0;
+        for (int j = 0; j < 3; ++j) p_[i][j] = i == j ? kInitialCovariance : 0;
+    }
+    residual_sq_ = 0;
+    fit_samples_ = 0;
+    turned_deg_ = 0;
+}
+
+void CirclingWind::add(float ground_speed, float track_deg, uint32_t t_ms)
+{
+    const uint32_t dt_ms = t_ms - last_ms_;
+    if (!have_last_ || dt_ms > kMaxGapMs)
+    {
+        have_last_ = true;
+        last_track_ = track_deg;
+        last_ms_ = t_ms;
+        rate_deg_s_ = 0;
+        circling_ = false;
+        return;
+    }
+    if (dt_ms == 0) return;
+
+    const float dt_s = dt_ms * 0.001f;
+    float step = track_deg - last_track_;
+    if (step > 180.0f) step -= 360.0f;
+    if (step < -180.0f) step += 360.0f;
+    last_track_ = track_deg;
+    last_ms_ = t_ms;
+    rate_deg_s_ += (dt_s < 2.0f ? dt_s / 2.0f : 1.0f) * (step / dt_s - rate_deg_s_);
+
+    if (std::fabs(rate_deg_s_) >= kCirclingRateDegS)
+    {
+        // A reversal after more than a quarter turn starts a new circle.
+        const bool reversed = turned_deg_ * rate_deg_s_ < 0 && std::fabs(turned_deg_) > 90.0f;
+        if (!circling_ || reversed) restart_fit();
+        circling_ = true;
+        turning_ms_ = t_ms;
+    }
+    else if (circling_ && t_ms - turning_ms_ >= kStraightMs)
+    {
+        circling_ = false;
+    }
+    if (!circling_) return;
+    // Only compared against two turns; the clamp keeps float steps exact.
+    turned_deg_ = std::fmax(-3600.0f, std::fmin(3600.0f, turned_deg_ + step));
+
+    // RLS update with phi = (x, y, 1), z = x^2 + y^2.
+    const double x = ground_speed * fast_trig::cos_deg(track_deg);
+    const double y = ground_speed * fast_trig::sin_deg(track_deg);
+    const double phi[3] = {x, y, 1.0};
+    const double lambda = std::exp(-dt_s / kTimeConstantS);
+
+    double p_phi[3];
+    for (int i = 0; i < 3; ++i) p_phi[i] = p_[i][0] * phi[0] + p_[i][1] * phi[1] + p_[i][2] * phi[2];
+    const double denom = lambda + phi[0] * p_phi[0] + phi[1] * p_phi[1] + phi[2] * p_phi[2];
+    const double err = x * x + y * y - (theta_[0] * phi[0] + theta_[1] * phi[1] + theta_[2]);
+    for (int i = 0; i < 3; ++i) theta_[i] += p_phi[i] / denom * err;
+    // P -= P phi phi' P / denom, written out symmetric so rounding cannot
+    // make it indefinite over hours of circling.
+    for (int i = 0; i < 3; ++i)
+        for (int j = i; j < 3; ++j) p_[i][j] = p_[j][i] = (p_[i][j] - p_phi[i] * p_phi[j] / denom) / lambda;
+    ++fit_samples_;
+
+    const double a = theta_[0] / 2;
+    const double b = theta_[1] / 2;
+    const double r2 = theta_[2] + a * a + b * b;
+    if (r2 <= 0) return;
+    const double r = std::sqrt(r2);
+    const double radial = std::sqrt((x - a) * (x - a) + (y - b) * (y - b)) - r;
+    residual_sq_ = fit_samples_ == 1 ? radial * radial : lambda * residual_sq_ + (1 - lambda) * radial * radial;
+
+    if (fit_samples_ < kMinFitSamples || std::fabs(turned_deg_) < 360.0f) return;
+    if (r < kMinRadius || r > kMaxRadius) return;
+
+    const float coverage = std::fmin(std::fabs(turned_deg_) / 720.0f, 1.0f);
+    const float fit = std::fmax(0.0f, 1.0f - static_cast<float>(std::sqrt(residual_sq_) / (0.1 * r)));
+    held_.valid = true;
+    held_.speed = static_cast<float>(std::sqrt(a * a + b * b));
+    held_.direction = fast_trig::atan2_deg(static_cast<float>(-b), static_cast<float>(-a));
+    held_.quality = static_cast<uint8_t>(std::lround(100.0f * coverage * fit));
+    held_.radius = static_cast<float>(r);
+    held_ms_ = t_ms;
+}
+
+CirclingWind::Estimate CirclingWind::estimate(uint32_t now_ms) const
+{
+    if (!held_.valid) return {};
+    const uint32_t age = now_ms - held_ms_;
+    if (age >= kHoldMs) return {};
+    Estimate e = held_;
+    e.quality = static_cast<uint8_t>(e.quality * (kHoldMs - age) / kHoldMs);
+    return e;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+// Wind from GPS ground speed and track while circling.
+//
+// At constant airspeed the ground velocity vectors of a full turn lie on a
+// circle around the wind vector, with the TAS as radius. Each GPS sample
+// feeds a recursive least-squares fit of x^2 + y^2 = 2ax + 2by + c (Kasa
+// circle fit, three parameters, exponential forgetting), so memory and time
+// per sample are constant and no heading or airspeed is needed.
+//
+// Quality grows with the angle turned since the circling started (full
+// value after two turns) and drops with the fit residual relative to the
+// radius. Once the glider straightens out the last estimate is kept, with its
+// quality decaying over kHoldMs.
+//
+// Single-threaded, owned by DerivedQuantities.
+class CirclingWind
+{
+public:
+    struct Estimate
+    {
+        bool valid;
+        float speed;     // m/s
+        float direction; // deg, where the wind comes from
+        uint8_t quality; // 0..100
+        float radius;    // fitted circle radius, the mean TAS in m/s
+    };
+
+    // Track rate that counts as circling.
+    static constexpr float kCirclingRateDegS = 6.0f;
+    // Track rate below the threshold for this long ends a circling phase.
+    static constexpr uint32_t kStraightMs = 5000;
+    // Memory of the fit; about two turns of a typical thermal circle.
+    static constexpr float kTimeConstantS = 40.0f;
+    static constexpr uint32_t kHoldMs = 600000;
+
+    // One GPS sample, ground speed in m/s and true track in degrees.
+    void add(float ground_speed, float track_deg, uint32_t t_ms);
+
+    bool circling() const { return circling_; }
+    float turned_deg() const { return turned_deg_; }
+    Estimate estimate(uint32_t now_ms) const;
+
+private:
+    void restart_fit();
+
+    // RLS state, theta = (2a, 2b, c). Double: the normal equations mix
+    // speeds with their squares.
+    double theta_[3] = {};
+    double p_[3][3] = {};
+    double residual_sq_ = 0; // smoothed squared radial residual, (m/s)^2
+    uint32_t fit_samples_ = 0;
+
+    bool have_last_ = false;
+    float last_track_ = 0;
+    uint32_t last_ms_ = 0;
+    float rate_deg_s_ = 0; // smoothed track rate
+    bool circling_ = false;
+    uint32_t turning_ms_ = 0; // last sample at circling track rate
+    float turned_deg_ = 0; // signed, since the current circling phase started
+
+    Estimate held_{};
+    uint32_t held_ms_ = 0;
+};
@@ -0,0 +1,220 @@
+#include "derived_quantities.hpp"
+#include "fast_trig.hpp"
+
+#include <cmath>
+
+namespace
+{
+constexpr float kTableMinAlt = -1000.0f;
+constexpr float kTableStep = 250.0f;
+constexpr std::size_t kTableSize = 65; // up to 15000 m
+
+// 1 / sqrt(sigma), sigma = (1 - 2.25577e-5 h)^4.2559 below the tropopause
+// and an exponential decay above it (11000 m).
+const std::array<float, kTableSize> kTasFactor = [] {
+    std::array<float, kTableSize> t{};
+    for (std::size_t i = 0; i < kTableSize; ++i)
+    {
+        const double h = kTableMinAlt + kTableStep * static_cast<double>(i);
+        const double sigma = h <= 11000.0 ? std::pow(1.0 - 2.25577e-5 * h, 4.2559)
+                                          : 0.29708 * std::exp(-(h - 11000.0) / 6341.62);
+        t[i] = static_cast<float>(1.0 / std::sqrt(sigma));
+    }
+    return t;
+}();
+
+constexpr SignalMask kTasOut = signal_mask(FlightSignal::Tas);
+constexpr SignalMask kWindOut = signal_mask(FlightSignal::WindSpeed, FlightSignal::WindDirection);
+constexpr SignalMask kGpsIn = signal_mask(FlightSignal::GpsGroundSpeed, FlightSignal::GpsTrueTrack);
+constexpr SignalMask kTriangleIn = signal_mask(FlightSignal::Tas, FlightSignal::Heading);
+constexpr SignalMask kPositionIn = signal_mask(FlightSignal::Lat, FlightSignal::Lon);
+
+// All of `signals` received, fresh and not rejected.
+bool present(const FlightSnapshot& snap, SignalMask signals, uint32_t now_ms)
+{
+    return snap.is_valid(signals, now_ms);
+}
+
+// Receivers without a fix tend to send 0/0.
+bool has_fix(geo::Position p) { return p.lat_e7 != 0 || p.lon_e7 != 0; }
+} // namespace
+
+// In dependency order: a rule may only read outputs of rules above it.
+const std::array<DerivedQuantities::Rule, 3> DerivedQuantities::kRules = {{
+    {signal_mask(FlightSignal::Ias, FlightSignal::Alt), signal_mask(FlightSignal::Ias, FlightSignal::Alt), kTasOut,
+     &DerivedQuantities::compute_tas},
+    {kPositionIn, kPositionIn, kGpsIn, &DerivedQuantities::compute_ground_vector},
+    {kTriangleIn | kGpsIn, kGpsIn, kWindOut, &DerivedQuantities::compute_wind},
+}};
+
+float DerivedQuantities::tas_factor(float pressure_alt_m)
+{
+    float f = (pressure_alt_m - kTableMinAlt) / kTableStep;
+    if (f <= 0) return kTasFactor.front();
+    if (f >= kTableSize - 1) return kTasFactor.back();
+    const std::size_t i = static_cast<std::size_t>(f);
+    return kTasFactor[i] + (kTasFactor[i + 1] - kTasFactor[i]) * (f - static_cast<float>(i));
+}
+
+void DerivedQuantities::wind_vector(float tas, float heading, float ground_speed, float track, float& north,
+                                    float& east)
+{
+    using namespace fast_trig;
+    north = ground_speed * cos_deg(track) - tas * cos_deg(heading);
+    east = ground_speed * sin_deg(track) - tas * sin_deg(heading);
+}
+
+DerivedQuantities::Wind DerivedQuantities::wind_triangle(float tas, float heading, float ground_speed, float track)
+{
+    float north, east;
+    wind_vector(tas, heading, ground_speed, track, north, east);
+    return {std::sqrt(north * north + east * east), fast_trig::atan2_deg(-east, -north)};
+}
+
+bool DerivedQuantities::from_bus(SignalMask outputs, uint32_t now_ms) const
+{
+    for (std::size_t i = 0; i < kFlightSignalCount; ++i)
+    {
+        if (!(outputs & (SignalMask{1} << i))) continue;
+        if (bus_ms_[i] == 0) return false;
+        const uint32_t timeout = kDefaultSignalTimeouts.ms[i];
+        if (timeout != SignalTimeouts::kNoTimeout && now_ms - bus_ms_[i] >= timeout) return false;
+    }
+    return true;
+}
+
+SignalMask DerivedQuantities::update(FlightSnapshot& snap, SignalMask from_bus_mask, uint32_t now_ms)
+{
+    for (std::size_t i = 0; i < kFlightSignalCount; ++i)
+        if (from_bus_mask & (SignalMask{1} << i)) bus_ms_[i] = now_ms;
+    if (from_bus_mask & kWindOut)
+    {
+        snap.wind_source = WindSource::Bus;
+        snap.wind_quality = 100;
+    }
+    if (!snap.has_home && (from_bus_mask & kPositionIn) && present(snap, kPositionIn, now_ms) &&
+        has_fix({snap.lat, snap.lon}))
+    {
+        snap.home_lat = snap.lat;
+        snap.home_lon = snap.lon;
+        snap.has_home = true;
+    }
+
+    SignalMask changed = from_bus_mask;
+    SignalMask computed = 0;
+    for (const Rule& rule : kRules)
+    {
+        if (!(changed & rule.inputs)) continue;
+        if (from_bus(rule.outputs, now_ms))
+        {
+            active_ &= ~rule.outputs;
+            if (rule.outputs & kWindOut) have_wind_ = false;
+            continue;
+        }
+        if (!present(snap, rule.required, now_ms) || !(this->*rule.compute)(snap, now_ms)) continue;
+
+        for (std::size_t i = 0; i < kFlightSignalCount; ++i)
+            if (rule.outputs & (SignalMask{1} << i)) snap.rx_ms[i] = now_ms;
+        // A computed value replaces whatever the bus got wrong.
+        snap.out_of_range &= ~rule.outputs;
+        snap.decode_error &= ~rule.outputs;
+        changed |= rule.outputs;
+        computed |= rule.outputs;
+        active_ |= rule.outputs;
+    }
+    return computed;
+}
+
+void DerivedQuantities::on_sample(FlightSignal signal, FlightSnapshot& snap, uint32_t t_ms)
+{
+    if (signal != FlightSignal::Ias) return;
+    ias_trend_.update(snap.ias, t_ms);
+    snap.ias_rate = ias_trend_.rate();
+}
+
+bool DerivedQuantities::compute_tas(FlightSnapshot& snap, uint32_t)
+{
+    snap.tas = snap.ias * tas_factor(snap.alt);
+    return true;
+}
+
+bool DerivedQuantities::compute_ground_vector(FlightSnapshot& snap, uint32_t)
+{
+    // Latitude and longitude come in separate frames; a fix is complete once
+    // both have been received after the previous one.
+    const uint32_t lat_ms = snap.received_ms(FlightSignal::Lat);
+    const uint32_t lon_ms = snap.received_ms(FlightSignal::Lon);
+    if (lat_ms <= fix_ms_ || lon_ms <= fix_ms_) return false;
+
+    const geo::Position fix{snap.lat, snap.lon};
+    const uint32_t fix_ms = lat_ms > lon_ms ? lat_ms : lon_ms;
+    const uint32_t dt_ms = fix_ms - fix_ms_;
+    if (fix_ms_ == 0 || dt_ms > kFixGapMs || !has_fix(fix_))
+    {
+        fix_ = fix;
+        fix_ms_ = fix_ms;
+        return false;
+    }
+    if (dt_ms < kFixBaselineMs) return false;
+
+    const geo::Vector leg = geo::distance_bearing(fix_, fix);
+    fix_ = fix;
+    fix_ms_ = fix_ms;
+    const float ground_speed = leg.distance_m * 1000.0f / static_cast<float>(dt_ms);
+    // A receiver losing its fix, or getting one, jumps.
+    if (!has_fix(fix) || ground_speed > kMaxGroundSpeed) return false;
+    snap.gps_ground_speed = ground_speed;
+    if (ground_speed >= kMinTrackSpeed) snap.gps_true_track = leg.bearing_deg;
+    return true;
+}
+
+bool DerivedQuantities::compute_wind(FlightSnapshot& snap, uint32_t now_ms)
+{
+    const uint32_t track_ms = snap.received_ms(FlightSignal::GpsTrueTrack);
+    if (track_ms != fed_track_ms_)
+    {
+        circling_.add(snap.gps_ground_speed, snap.gps_true_track, track_ms);
+        fed_track_ms_ = track_ms;
+    }
+
+    // Heading and track disagree in a turn, so the triangle is only trusted
+    // over the circle fit when flying straight.
+    const bool triangle = present(snap, kTriangleIn, now_ms);
+    const CirclingWind::Estimate circle = circling_.estimate(now_ms);
+    if (circle.valid && (circling_.circling() || !triangle))
+    {
+        // Also seeds the triangle smoothing for when the glider straightens out.
+        wind_north_ = -circle.speed * fast_trig::cos_deg(circle.direction);
+        wind_east_ = -circle.speed * fast_trig::sin_deg(circle.direction);
+        have_wind_ = true;
+        set_wind(snap, WindSource::Circling, circle.quality);
+        return true;
+    }
+    if (!triangle) return false;
+
+    float north, east;
+    wind_vector(snap.tas, snap.heading, snap.gps_ground_speed, snap.gps_true_track, north, east);
+    // Smooth the vector, not speed and direction, so a wind around north
+    // does not average to south.
+    if (!have_wind_)
+    {
+        wind_north_ = north;
+        wind_east_ = east;
+        have_wind_ = true;
+    }
+    else
+    {
+        wind_north_ += kWindSmoothing * (north - wind_north_);
+        wind_east_ += kWindSmoothing * (east - wind_east_);
+    }
+    set_wind(snap, WindSource::Triangle, kTriangleQuality);
+    return true;
+}
+
+void DerivedQuantities::set_wind(FlightSnapshot& snap, WindSource source, uint8_t quality) const
+{
+    snap.wind_speed = std::sqrt(wind_north_ * wind_north_ + wind_east_ * wind_east_);
+    snap.wind_direction = fast_trig::atan2_deg(-wind_east_, -wind_north_);
+    snap.wind_source = source;
+    snap.wind_quality = quality;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "alpha_beta_filter.hpp"
+#include "circling_wind.hpp"
+#include "flight_data.hpp"
+#include "geo.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Flight values computed from other flight values when no box on the bus
+// sends them: TAS from IAS and pressure altitude (ISA density), GPS ground
+// speed and track from successive position fixes (geo.hpp), and wind from
+// a circle fit of the GPS ground speed while circling (CirclingWind) or the
+// triangle of TAS/heading against GPS ground speed/track. The circling
+// estimate wins while circling and when there is no heading or TAS; wind_source
+// and wind_quality in the snapshot say which one is shown.
+//
+// Per-sample estimates (the IAS trend) go through on_sample() instead, which
+// CanIngest calls for every decoded frame rather than once per publish.
+//
+// The rules form a small dependency graph over FlightSignal bits. update()
+// walks it once in dependency order and only re-runs a rule when one of its
+// inputs changed, so a vario frame costs one mask test per rule. A rule is
+// skipped while its outputs are still fresh from the bus, and while any input
+// is missing or stale; its outputs then go stale on their own.
+//
+// The first valid position fix is also latched as home (FlightSnapshot::
+// home_lat/home_lon) for the distance/bearing-to-home readout.
+//
+// Single-threaded: called by CanIngest on the ingest thread.
+class DerivedQuantities
+{
+public:
+    // from_bus are the signals decoded from frames since the last call.
+    // Writes the derived values and their rx_ms into snap and returns the
+    // signals it recomputed.
+    SignalMask update(FlightSnapshot& snap, SignalMask from_bus, uint32_t now_ms);
+
+    // One decoded sample of `signal`, already stored in snap.
+    void on_sample(FlightSignal signal, FlightSnapshot& snap, uint32_t t_ms);
+
+    // Outputs computed by the last update() that ran their rule.
+    SignalMask active() const { return active_; }
+
+    const CirclingWind& circling() const { return circling_; }
+
+    // TAS / IAS at a pressure altitude in the standard atmosphere, from a
+    // table in 250 m steps between -1000 and 15000 m.
+    static float tas_factor(float pressure_alt_m);
+
+    struct Wind
+    {
+        float speed;     // same unit as the inputs
+        float direction; // deg, where the wind comes from
+    };
+
+    // Ground vector minus air vector. Angles in degrees.
+    static Wind wind_triangle(float tas, float heading, float ground_speed, float track);
+
+private:
+    struct Rule
+    {
+        SignalMask inputs;   // a change in any of these re-runs the rule
+        SignalMask required; // all of these must be present and fresh
+        SignalMask outputs;
+        // Returns false if it had nothing to output.
+        bool (DerivedQuantities::*compute)(FlightSnapshot&, uint32_t now_ms);
+    };
+
+    // Exponential smoothing of the wind vector per computed sample; the
+    // triangle is noisy while heading and track disagree in turns.
+    static constexpr float kWindSmoothing = 0.1f;
+    // Time constant of the IAS trend; a 5 s trend vector shows rate * 5.
+    static constexpr float kIasTrendTauS = 1.5f;
+
+    // Reported for the triangle, which has no residual to judge it by.
+    static constexpr uint8_t kTriangleQuality = 40;
+
+    // Ground vector from positions: shortest baseline between the two fixes
+    // (GPS noise of a few metres over 1 s is still a few m/s), the longest gap
+    // before the previous fix is dropped, and the ground speed under which the
+    // track keeps its last value. Legs faster than kMaxGroundSpeed (the
+    // schema limit of 1039) are position jumps and are dropped.
+    static constexpr uint32_t kFixBaselineMs = 1000;
+    static constexpr uint32_t kFixGapMs = 5000;
+    static constexpr float kMinTrackSpeed = 2.0f;
+    static constexpr float kMaxGroundSpeed = 300.0f;
+
+    static const std::array<Rule, 3> kRules;
+
+    static void wind_vector(float tas, float heading, float ground_speed, float track, float& north, float& east);
+
+    bool compute_tas(FlightSnapshot& snap, uint32_t now_ms);
+    bool compute_ground_vector(FlightSnapshot& snap, uint32_t now_ms);
+    bool compute_wind(FlightSnapshot& snap, uint32_t now_ms);
+    void set_wind(FlightSnapshot& snap, WindSource source, uint8_t quality) const;
+    bool from_bus(SignalMask outputs, uint32_t now_ms) const;
+
+    std::array<uint32_t, kFlightSignalCount> bus_ms_{}; // last frame per signal, 0 = never
+    SignalMask active_ = 0;
+    bool have_wind_ = false;
+    float wind_north_ = 0; // smoothed wind vector, blowing towards
+    float wind_east_ = 0;
+    CirclingWind circling_;
+    AlphaBetaFilter ias_trend_{kIasTrendTauS};
+    uint32_t fed_track_ms_ = 0; // receive time of the GPS sample last given to circling_
+    geo::Position fix_{};       // previous position fix for the ground vector
+    uint32_t fix_ms_ = 0;       // its receive time, 0 = none
+};
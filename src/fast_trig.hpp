@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Table-driven trigonometry in degrees for code that runs at CAN rate.
+// Tables are built at compile time and interpolated linearly; the error is
+// below 2e-5 for sin/cos and 0.001 deg for atan2, far under what any of the
+// flight values carry.
+namespace fast_trig
+{
+    namespace detail
+    {
+        constexpr double kPi = 3.14159265358979323846;
+
+        // Taylor series, used for the tables only (|x| <= pi/2 there).
+        constexpr double sin_series(double x)
+        {
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 12; ++n)
+            {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double atan_series(double x) // |x| <= 1
+        {
+            // atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))) brings x under 0.42,
+            // where the series converges quickly.
+            double s = 1 + x * x;
+            double r = s;
+            for (int i = 0; i < 30; ++i) r = 0.5 * (r + s / r);
+            const double y = x / (1 + r);
+            double term = y;
+            double sum = y;
+            for (int n = 1; n < 40; ++n)
+            {
+                term *= -y * y;
+                sum += term / (2 * n + 1);
+            }
+            return 2 * sum;
+        }
+
+        // Quarter wave, kSinSteps + 1 points from 0 to 90 deg.
+        inline constexpr std::size_t kSinSteps = 128;
+        inline constexpr auto kSin = [] {
+            std::array<float, kSinSteps + 1> t{};
+            for (std::size_t i = 0; i <= kSinSteps; ++i) t[i] = static_cast<float>(sin_series(kPi / 2 * i / kSinSteps));
+            return t;
+        }();
+
+        // atan(x) in degrees for x in [0, 1].
+        inline constexpr std::size_t kAtanSteps = 256;
+        inline constexpr auto kAtan = [] {
+            std::array<float, kAtanSteps + 2> t{};
+            for (std::size_t i = 0; i <= kAtanSteps; ++i)
+                t[i] = static_cast<float>(atan_series(static_cast<double>(i) / kAtanSteps) * 180.0 / kPi);
+            t[kAtanSteps + 1] = t[kAtanSteps]; // x == 1 interpolates without a branch
+            return t;
+        }();
+
+        inline float atan_unit_deg(float x)
+        {
+            const float f = x * kAtanSteps;
+            const std::size_t i = static_cast<std::size_t>(f);
+            return kAtan[i] + (kAtan[i + 1] - kAtan[i]) * (f - static_cast<float>(i));
+        }
+    } // namespace detail
+
+    // Any angle to [0, 360).
+    inline float wrap_deg(float deg)
+    {
+        if (deg >= 0 && deg < 360) return deg;
+        deg = std::fmod(deg, 360.0f);
+        return deg < 0 ? deg + 360.0f : deg;
+    }
+
+    inline float sin_deg(float deg)
+    {
+        using namespace detail;
+        const float f = wrap_deg(deg) * (kSinSteps / 90.0f);
+        std::size_t i = static_cast<std::size_t>(f);
+        const float frac = f - static_cast<float>(i);
+        const std::size_t quadrant = (i / kSinSteps) & 3;
+        i %= kSinSteps;
+        float v;
+        if (quadrant & 1) // mirrored: 90..180 and 270..360
+            v = kSin[kSinSteps - i] + (kSin[kSinSteps - i - 1] - kSin[kSinSteps - i]) * frac;
+        else
+            v = kSin[i] + (kSin[i + 1] - kSin[i]) * frac;
+        return quadrant & 2 ? -v : v;
+    }
+
+    inline float cos_deg(float deg) { return sin_deg(deg + 90.0f); }
+
+    // Angle of (x, y) from the x axis, counter-clockwise, in [0, 360).
+    // Navigation callers pass (north, east) as (x, y) to get a bearing.
+    inline float atan2_deg(float y, float x)
+    {
+        const float ax = std::fabs(x);
+        const float ay = std::fabs(y);
+        if (ax == 0 && ay == 0) return 0;
+        float a = ay <= ax ? detail::atan_unit_deg(ay / ax) : 90.0f - detail::atan_unit_deg(ax / ay);
+        if (x < 0) a = 180.0f - a;
+        if (y < 0) a = 360.0f - a;
+        return a >= 360.0f ? a - 360.0f : a;
+    }
+} // namespace fast_trig
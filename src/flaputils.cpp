@@ -1,20 +1,30 @@
 #include "flaputils.hpp"
+#include "polar_format.hpp"
+#include "units.hpp"
 
 #include <string>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
 #include <dirent.h>
 #include <cstring>
-#if __has_include(<cjson/cJSON.h>)
-#include <cjson/cJSON.h>
-#else
-#include "cJSON.h"
-#endif
 #ifndef NATIVE_TEST_BUILD
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "nvs_flash.h"
 #include "nvs.h"
+#include "esp_partition.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 #endif
 
 #ifdef NATIVE_TEST_BUILD
@@ -23,17 +33,12 @@
 
 namespace flaputils
 {
-    struct FlapEntry
-    {
-        std::string symbol;
-    };
+    static constexpr SpeedLimits kDefaultSpeedLimits = {75.0f, 180.0f, 90.0f, 200.0f, 280.0f};
 
-    static std::vector<FlapEntry> kFlapTable;
-    static std::vector<int> kWeights;
-    static float kEmptyMassKg = 0.0f;
-    static std::string kLowSpeedWk;
-    static std::string kCurrentPolar;
-    static SpeedLimits kSpeedLimits = {75.0f, 180.0f, 90.0f, 200.0f, 280.0f};
+    // Weights within one quantum share a band cache entry.
+    static constexpr float kWeightQuantumKg = 0.5f;
+    // Weights beyond this are not a glider; they bypass the cache.
+    static constexpr float kMaxCachedWeightKg = 100000.0f;
 
     struct Range
     {
@@ -41,352 +46,776 @@ namespace flaputils
         float vmax;
     };
 
-    struct Bereich
-    {
-        std::string wk;
-        std::vector<Range> ranges;
-    };
+    static inline bool has_range(const Range& r) { return r.vmin >= 0.0f && r.vmax >= 0.0f; }
 
-    static std::vector<Bereich> kBereiche;
-    static Range kLowSpeedRange{-1.0f, -1.0f};
+    static bool cacheable(float gewicht_kg) { return std::fabs(gewicht_kg) < kMaxCachedWeightKg; }
 
-    static int find_flap_index_by_symbol(const std::string& symbol)
+    static int32_t weight_key(float gewicht_kg)
     {
-        for (std::size_t i = 0; i < kFlapTable.size(); ++i)
-        {
-            if (kFlapTable[i].symbol == symbol)
-            {
-                return static_cast<int>(i);
-            }
-        }
-        return -1;
+        return static_cast<int32_t>(std::lround(gewicht_kg / kWeightQuantumKg));
     }
 
-    bool load_data(const char* filepath)
+    // The weight the bands are interpolated at, cached or not.
+    static float quantize(float gewicht_kg)
     {
-        FILE* f = fopen(filepath, "rb");
-        if (!f)
-        {
-            printf("flaputils: Failed to open %s\n", filepath);
-            return false;
-        }
+        return cacheable(gewicht_kg) ? static_cast<float>(weight_key(gewicht_kg)) * kWeightQuantumKg : gewicht_kg;
+    }
+
+    // Bands interpolated for one weight, plus the answer of first_match() as
+    // a step function of speed: answers[i] holds for edges[i-1] <= v <
+    // edges[i]. Band ends are inclusive, so each end is its own step
+    // [end, nextafter(end)). Weight changes only with ballast, so this is
+    // rebuilt rarely and a lookup is one std::upper_bound.
+    struct BandCache
+    {
+        static constexpr std::size_t kMaxEdges = 4 * (kMaxFlapBands + 1);
+
+        bool built = false;
+        int32_t key = 0;
+        std::size_t range_count = 0;
+        std::array<FlapSpeedRange, kMaxFlapBands> ranges{};
+        std::size_t edge_count = 0;
+        std::array<float, kMaxEdges> edges{};
+        std::array<int16_t, kMaxEdges + 1> answers{};
+    };
+
+    // What a model's view points into: a mapping (a .fpol file on the host, a
+    // slot of the "polar" flash partition on the device) or a JSON conversion
+    // held in RAM. Released with the model.
+    struct PolarStorage
+    {
+        std::vector<uint8_t> owned;
+#ifdef NATIVE_TEST_BUILD
+        void* map_addr = nullptr;
+        std::size_t map_len = 0;
 
-        fseek(f, 0, SEEK_END);
-        long len = ftell(f);
-        fseek(f, 0, SEEK_SET);
+        ~PolarStorage() { release(); }
 
-        if (len <= 0)
+        void release()
         {
-            printf("flaputils: File %s is empty\n", filepath);
-            fclose(f);
-            return false;
+            if (map_addr) munmap(map_addr, map_len);
+            map_addr = nullptr;
+            owned.clear();
         }
+#else
+        esp_partition_mmap_handle_t map_handle = 0;
+        bool mapped = false;
+        int slot = -1; // partition slot, -1 = not in flash
+
+        ~PolarStorage() { release(); }
 
-        char* buffer = static_cast<char*>(malloc(len + 1));
-        if (!buffer)
+        void release()
         {
-            printf("flaputils: Failed to allocate %ld bytes\n", len + 1);
-            fclose(f);
-            return false;
+            if (mapped) esp_partition_munmap(map_handle);
+            mapped = false;
+            slot = -1;
+            owned.clear();
         }
-        size_t read_len = fread(buffer, 1, len, f);
-        fclose(f);
-        buffer[read_len] = '\0';
+#endif
+    };
 
-        cJSON* root = cJSON_Parse(buffer);
-        if (!root)
+    // One loaded polar. Filled in by the loader, then published and never
+    // changed again: lookups on any task read it without locks while the
+    // next one is built. Only the band cache changes, under its own flag.
+    struct PolarModel
+    {
+        PolarStorage storage;
+        fpol::View polar;
+        char name[64] = "";  // file it was loaded from, without directory
+        uint32_t serial = 0; // set on publish; tells derived caches apart
+
+        mutable BandCache cache;
+        // Held while cache is read or rebuilt. The print task and the LVGL
+        // task both look up flaps; whoever finds it taken computes uncached
+        // instead of waiting.
+        mutable std::atomic_flag cache_busy = ATOMIC_FLAG_INIT;
+
+        SpeedLimits speed_limits() const
         {
-            printf("flaputils: Failed to parse JSON\n");
-            free(buffer);
-            return false;
+            const fpol::Header& h = *polar.header;
+            return {h.vso, h.vfe, h.vs1, h.vno, h.vne};
         }
 
-        // Clear existing data
-        kFlapTable.clear();
-        kWeights.clear();
-        kBereiche.clear();
-        kLowSpeedWk.clear();
-        kLowSpeedRange = {-1.0f, -1.0f};
-
-        // Extract filename from path
-        std::string path(filepath);
-        size_t last_slash = path.find_last_of("/\\");
-        if (last_slash != std::string::npos)
+        void weight_bracket(float w, int& i1, int& i2, float& factor) const
         {
-            kCurrentPolar = path.substr(last_slash + 1);
+            const float* weights = polar.weights;
+            const std::size_t n = polar.weight_count();
+            if (n == 0)
+            {
+                i1 = i2 = 0;
+                factor = 0.0f;
+                return;
+            }
+            if (w <= weights[0])
+            {
+                i1 = i2 = 0;
+                factor = 0.0f;
+                return;
+            }
+            if (w >= weights[n - 1])
+            {
+                i1 = i2 = static_cast<int>(n - 1);
+                factor = 0.0f;
+                return;
+            }
+            for (std::size_t i = 0; i + 1 < n; ++i)
+            {
+                if (w >= weights[i] && w <= weights[i + 1])
+                {
+                    i1 = static_cast<int>(i);
+                    i2 = static_cast<int>(i + 1);
+                    factor = (w - weights[i1]) / (weights[i2] - weights[i1]);
+                    return;
+                }
+            }
+            i1 = i2 = 0;
+            factor = 0.0f;
         }
-        else
+
+        // Bands whose JSON listed no range up to the heavier bracket weight
+        // take no part, as before the binary format.
+        bool band_covers(std::size_t band, int i1, int i2) const
         {
-            kCurrentPolar = path;
+            return polar.band_range_counts[band] > static_cast<std::size_t>(std::max(i1, i2));
         }
 
-        // 1. meta (previously partially in speedpolar)
-        if (const cJSON* meta = cJSON_GetObjectItem(root, "meta"))
+        Range band_range(std::size_t band, int w) const
         {
-            if (cJSON* em = cJSON_GetObjectItem(meta, "empty_mass_kg")) kEmptyMassKg = static_cast<float>(em->valuedouble);
+            const float* r = polar.range(band, static_cast<std::size_t>(w));
+            return {r[0], r[1]};
         }
 
-        // 2. weights
-        if (const cJSON* w_arr = cJSON_GetObjectItem(root, "weights"))
+        // Every band interpolated at weight w, in band order, as
+        // get_flap_speed_ranges() returns them; {-1, -1} where a band has no
+        // range at either bracket weight.
+        std::size_t interpolate_bands(float w, FlapSpeedRange* out) const
         {
-            if (cJSON_IsArray(w_arr))
+            if (polar.band_count() == 0 || polar.weight_count() == 0) return 0;
+
+            int i1 = 0, i2 = 0;
+            float f = 0.0f;
+            weight_bracket(w, i1, i2, f);
+
+            std::size_t n = 0;
+            for (std::size_t idx = 0; idx < polar.band_count(); ++idx)
             {
-                int sz = cJSON_GetArraySize(w_arr);
-                for (int i = 0; i < sz; i++)
+                if (!band_covers(idx, i1, i2)) continue;
+
+                const Range r1 = band_range(idx, i1);
+                const Range r2 = band_range(idx, i2);
+
+                float vmin = -1.0f;
+                float vmax = -1.0f;
+
+                if (has_range(r1) && has_range(r2))
+                {
+                    vmin = r1.vmin + f * (r2.vmin - r1.vmin);
+                    vmax = r1.vmax + f * (r2.vmax - r1.vmax);
+                }
+                else if (has_range(r1))
+                {
+                    vmin = r1.vmin;
+                    vmax = r1.vmax;
+                }
+                else if (has_range(r2))
                 {
-                    kWeights.push_back(cJSON_GetArrayItem(w_arr, i)->valueint);
+                    vmin = r2.vmin;
+                    vmax = r2.vmax;
                 }
+
+                out[n++] = {static_cast<int>(idx), vmin, vmax};
             }
+            return n;
         }
 
-        // 3. flaps (previously flap2symbol)
-        if (const cJSON* flaps = cJSON_GetObjectItem(root, "flaps"))
+        // The flap for speed v: the low-speed band first, then the first band
+        // whose range contains v. Runs only while building the band cache and
+        // when the cache is busy.
+        int first_match(const FlapSpeedRange* ranges, std::size_t n, float v) const
         {
-            cJSON* lab_arr = cJSON_GetObjectItem(flaps, "labels");
-            if (lab_arr && cJSON_IsArray(lab_arr))
-            {
-                int sz = cJSON_GetArraySize(lab_arr);
-                for (int i = 0; i < sz; i++)
-                {
-                    cJSON* lab_item = cJSON_GetArrayItem(lab_arr, i);
-                    if (lab_item && lab_item->valuestring)
-                    {
-                        kFlapTable.push_back({lab_item->valuestring});
-                    }
-                }
-            }
+            const fpol::Header& h = *polar.header;
+            if (has_range({h.lowspeed_vmin, h.lowspeed_vmax}) && v >= h.lowspeed_vmin && v <= h.lowspeed_vmax)
+                return h.lowspeed_flap;
+            for (std::size_t i = 0; i < n; ++i)
+                if (has_range({ranges[i].lower_speed, ranges[i].upper_speed}) && v >= ranges[i].lower_speed &&
+                    v <= ranges[i].upper_speed)
+                    return ranges[i].index;
+            return -1;
         }
 
-        // 4. speedpolar
-        if (const cJSON* sp_arr = cJSON_GetObjectItem(root, "speedpolar"))
+        void build_band_cache(int32_t key) const
         {
-            if (cJSON_IsArray(sp_arr))
+            BandCache& c = cache;
+            c.built = true;
+            c.key = key;
+            c.range_count = interpolate_bands(static_cast<float>(key) * kWeightQuantumKg, c.ranges.data());
+
+            std::array<float, 2 * (kMaxFlapBands + 1)> ends;
+            std::size_t n = 0;
+            const fpol::Header& h = *polar.header;
+            if (has_range({h.lowspeed_vmin, h.lowspeed_vmax}))
             {
-                int b_sz = cJSON_GetArraySize(sp_arr);
-                for (int i = 0; i < b_sz; i++)
-                {
-                    cJSON* b_item = cJSON_GetArrayItem(sp_arr, i);
-                    Bereich b;
-                    cJSON* wk = cJSON_GetObjectItem(b_item, "wk");
-                    if (wk && wk->valuestring) b.wk = wk->valuestring;
-
-                    if (cJSON* r_arr_outer = cJSON_GetObjectItem(b_item, "ranges"))
-                    {
-                        if (cJSON_IsArray(r_arr_outer))
-                        {
-                            int r_sz = cJSON_GetArraySize(r_arr_outer);
-                            for (int j = 0; j < r_sz; j++)
-                            {
-                                cJSON* r_pair = cJSON_GetArrayItem(r_arr_outer, j);
-                                if (cJSON_IsArray(r_pair) && cJSON_GetArraySize(r_pair) >= 2)
-                                {
-                                    b.ranges.push_back({
-                                        static_cast<float>(cJSON_GetArrayItem(r_pair, 0)->valuedouble),
-                                        static_cast<float>(cJSON_GetArrayItem(r_pair, 1)->valuedouble)
-                                    });
-                                }
-                            }
-                        }
-                    }
-                    kBereiche.push_back(b);
-                }
+                ends[n++] = h.lowspeed_vmin;
+                ends[n++] = h.lowspeed_vmax;
+            }
+            for (std::size_t i = 0; i < c.range_count; ++i)
+            {
+                if (!has_range({c.ranges[i].lower_speed, c.ranges[i].upper_speed})) continue;
+                ends[n++] = c.ranges[i].lower_speed;
+                ends[n++] = c.ranges[i].upper_speed;
+            }
+            std::sort(ends.begin(), ends.begin() + n);
+            n = static_cast<std::size_t>(std::unique(ends.begin(), ends.begin() + n) - ends.begin());
+
+            // The answer is constant on each end and on each open gap between
+            // ends; one sample per piece, and a new edge only where it changes.
+            c.edge_count = 0;
+            c.answers[0] = -1;
+            auto step = [&](float from)
+            {
+                const int16_t answer = static_cast<int16_t>(first_match(c.ranges.data(), c.range_count, from));
+                if (answer == c.answers[c.edge_count]) return;
+                c.edges[c.edge_count++] = from;
+                c.answers[c.edge_count] = answer;
+            };
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                step(ends[i]);
+                const float after = std::nextafter(ends[i], INFINITY);
+                if (i + 1 == n || after < ends[i + 1]) step(after);
             }
         }
 
-        // 5. lowspeed
-        if (const cJSON* ls = cJSON_GetObjectItem(root, "lowspeed"))
+        // Caller holds cache_busy.
+        const BandCache& band_cache(float gewicht_kg) const
         {
-            if (const cJSON* wk = cJSON_GetObjectItem(ls, "wk"); wk && wk->valuestring)
-            {
-                kLowSpeedWk = wk->valuestring;
-            }
+            const int32_t key = weight_key(gewicht_kg);
+            if (!cache.built || cache.key != key) build_band_cache(key);
+            return cache;
+        }
 
-            if (const cJSON* r_pair = cJSON_GetObjectItem(ls, "range"))
+        int optimal_flap(float gewicht_kg, float geschwindigkeit_kmh) const
+        {
+            if (!cacheable(gewicht_kg) || cache_busy.test_and_set(std::memory_order_acquire))
             {
-                if (cJSON_IsArray(r_pair) && cJSON_GetArraySize(r_pair) >= 2)
-                {
-                    kLowSpeedRange = {
-                        static_cast<float>(cJSON_GetArrayItem(r_pair, 0)->valuedouble),
-                        static_cast<float>(cJSON_GetArrayItem(r_pair, 1)->valuedouble)
-                    };
-                }
+                std::array<FlapSpeedRange, kMaxFlapBands> ranges;
+                const std::size_t n = interpolate_bands(quantize(gewicht_kg), ranges.data());
+                return first_match(ranges.data(), n, geschwindigkeit_kmh);
             }
+
+            const BandCache& c = band_cache(gewicht_kg);
+            const float* end = c.edges.data() + c.edge_count;
+            const int answer = c.answers[std::upper_bound(c.edges.data(), end, geschwindigkeit_kmh) - c.edges.data()];
+            cache_busy.clear(std::memory_order_release);
+            return answer;
         }
 
-        // 6. speedlimits
-        if (const cJSON* sl = cJSON_GetObjectItem(root, "speedlimits"))
+        std::size_t speed_ranges(float gewicht_kg, std::span<FlapSpeedRange> out) const
         {
-            if (cJSON* v = cJSON_GetObjectItem(sl, "vso")) kSpeedLimits.vso = static_cast<float>(v->valuedouble);
-            if (cJSON* v = cJSON_GetObjectItem(sl, "vfe")) kSpeedLimits.vfe = static_cast<float>(v->valuedouble);
-            if (cJSON* v = cJSON_GetObjectItem(sl, "vs1")) kSpeedLimits.vs1 = static_cast<float>(v->valuedouble);
-            if (cJSON* v = cJSON_GetObjectItem(sl, "vno")) kSpeedLimits.vno = static_cast<float>(v->valuedouble);
-            if (cJSON* v = cJSON_GetObjectItem(sl, "vne")) kSpeedLimits.vne = static_cast<float>(v->valuedouble);
+            if (!cacheable(gewicht_kg) || cache_busy.test_and_set(std::memory_order_acquire))
+            {
+                std::array<FlapSpeedRange, kMaxFlapBands> ranges;
+                const std::size_t n = std::min(interpolate_bands(quantize(gewicht_kg), ranges.data()), out.size());
+                std::copy_n(ranges.begin(), n, out.begin());
+                return n;
+            }
+
+            const BandCache& c = band_cache(gewicht_kg);
+            const std::size_t n = std::min(c.range_count, out.size());
+            std::copy_n(c.ranges.begin(), n, out.begin());
+            cache_busy.clear(std::memory_order_release);
+            return n;
         }
+    };
 
-        cJSON_Delete(root);
-        free(buffer);
-        return true;
+    // RCU-style publication. kModel is the current model; a lookup reaches it
+    // with one atomic load inside a ReadSection, which also counts the lookup
+    // as in flight. A load builds the next model beside the current one and
+    // publishes it with one exchange. The model it replaces is retired and
+    // freed once no lookup is in flight. Nothing outside a ReadSection points
+    // into a model: symbol names and get_polar() are copies.
+    static std::atomic<const PolarModel*> kModel{nullptr};
+    static std::atomic<uint32_t> kReaders{0};
+    // Serializes loads. Also guards kPool, kRetired and kNextSerial.
+    static std::mutex kLoadMutex;
+    // Models live here rather than on the heap: at most the current one, the
+    // retired one and the one being built.
+    static std::array<std::optional<PolarModel>, 3> kPool;
+    static const PolarModel* kRetired = nullptr;
+    static uint32_t kNextSerial = 1;
+
+    // Caller holds kLoadMutex and has reclaimed the retired model, so a
+    // pool entry is free.
+    static PolarModel& new_model()
+    {
+        for (std::optional<PolarModel>& entry : kPool)
+            if (!entry) return entry.emplace();
+        std::abort();
     }
 
-    float get_empty_mass() { return kEmptyMassKg; }
+    static void free_model(const PolarModel* model)
+    {
+        for (std::optional<PolarModel>& entry : kPool)
+            if (entry && &*entry == model) entry.reset();
+    }
 
-    SpeedLimits get_speed_limits() { return kSpeedLimits; }
+    class ReadSection
+    {
+    public:
+        ReadSection()
+        {
+            kReaders.fetch_add(1, std::memory_order_seq_cst);
+            model_ = kModel.load(std::memory_order_seq_cst);
+        }
+        ~ReadSection() { kReaders.fetch_sub(1, std::memory_order_release); }
+        ReadSection(const ReadSection&) = delete;
+        ReadSection& operator=(const ReadSection&) = delete;
 
-    FlapSymbolResult get_flap_symbol(int flapIdx)
+        explicit operator bool() const { return model_ != nullptr; }
+        const PolarModel* operator->() const { return model_; }
+
+    private:
+        const PolarModel* model_;
+    };
+
+    // Frees the retired model once no lookup can still be reading it.
+    // Lookups take microseconds; on the device this sleeps a tick per round
+    // so a preempted lower-priority reader can finish.
+    static void reclaim_retired()
     {
-        if (flapIdx >= 0 && static_cast<std::size_t>(flapIdx) < kFlapTable.size())
+        if (!kRetired) return;
+        while (kReaders.load(std::memory_order_seq_cst) != 0)
         {
-            return {flapIdx};
+#ifdef NATIVE_TEST_BUILD
+            std::this_thread::yield();
+#else
+            vTaskDelay(1);
+#endif
         }
-        return {-1};
+        free_model(kRetired);
+        kRetired = nullptr;
     }
 
-    static inline void weight_bracket(float w, int& i1, int& i2, float& factor)
+    // Caller holds kLoadMutex and has reclaimed the retired model.
+    static void publish(PolarModel& next)
     {
-        if (kWeights.empty())
+        next.serial = kNextSerial++;
+        kRetired = kModel.exchange(&next, std::memory_order_seq_cst);
+    }
+
+    // get_speed_limits() in the display unit, for the model with
+    // kDisplayLimitsSerial and units::generation() kDisplayLimitsGen. Only
+    // the LVGL task asks for it. Gen 0 forces the first conversion.
+    static SpeedLimits kDisplayLimits = kDefaultSpeedLimits;
+    static uint32_t kDisplayLimitsGen = 0;
+    static uint32_t kDisplayLimitsSerial = 0;
+
+    // fpol::open() plus what flaputils needs on top: the band lookups use
+    // fixed tables of kMaxFlapBands, as many as the bus has flap positions.
+    static bool open_polar(const void* data, std::size_t size, fpol::View& out, const char* what)
+    {
+        const fpol::Error e = fpol::open(data, size, out);
+        if (e != fpol::Error::None)
         {
-            i1 = i2 = 0;
-            factor = 0.0f;
-            return;
+            printf("flaputils: %s: %s\n", what, fpol::error_name(e));
+            return false;
         }
-        if (w <= kWeights.front())
+        if (out.band_count() > kMaxFlapBands)
         {
-            i1 = i2 = 0;
-            factor = 0.0f;
-            return;
+            printf("flaputils: %s: %zu flap bands, at most %zu supported\n", what, out.band_count(), kMaxFlapBands);
+            out = {};
+            return false;
         }
-        if (w >= kWeights.back())
+        return true;
+    }
+
+    static const char* base_name(const char* path)
+    {
+        const char* slash = std::strrchr(path, '/');
+        return slash ? slash + 1 : path;
+    }
+
+    static bool ends_with(const char* s, const char* suffix)
+    {
+        const std::size_t n = std::strlen(s), m = std::strlen(suffix);
+        return n >= m && std::strcmp(s + n - m, suffix) == 0;
+    }
+
+    // Same polar name if the file names match without extension: a .fpol
+    // keeps the name of the JSON it was converted from.
+    [[maybe_unused]] static bool same_polar(const char* a, const char* b)
+    {
+        if (!a || !b) return false;
+        a = base_name(a);
+        b = base_name(b);
+        const char* dot_a = std::strrchr(a, '.');
+        const char* dot_b = std::strrchr(b, '.');
+        const std::size_t len_a = dot_a ? static_cast<std::size_t>(dot_a - a) : std::strlen(a);
+        const std::size_t len_b = dot_b ? static_cast<std::size_t>(dot_b - b) : std::strlen(b);
+        return len_a == len_b && std::strncmp(a, b, len_a) == 0;
+    }
+
+#ifndef NATIVE_TEST_BUILD
+    // Data partition holding converted polars, read through the flash
+    // cache; the SPIFFS copy of a file cannot be mapped. Two slots: the next
+    // model is written to the one the current model does not use.
+    static constexpr esp_partition_subtype_t kPolarSubtype = static_cast<esp_partition_subtype_t>(0x40);
+    static constexpr std::size_t kSlotSize = 0x10000;
+    static constexpr int kSlotCount = 2;
+    // Programmed a page per call, so one write stalls the flash cache for
+    // one page program.
+    static constexpr std::size_t kPageSize = 256;
+
+    // Bytes from the start of each slot known to be erased. Guarded by
+    // kLoadMutex; 0 until erase_slot() checks, and cut back by every write.
+    static std::array<std::size_t, kSlotCount> kSlotErased{};
+
+    static const esp_partition_t* polar_partition()
+    {
+        const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, kPolarSubtype, "polar");
+        return part && part->size >= kSlotCount * kSlotSize ? part : nullptr;
+    }
+
+    // The slot neither the current nor a retired model is mapped from.
+    // Caller holds kLoadMutex and has reclaimed the retired model.
+    static int free_slot()
+    {
+        const PolarModel* current = kModel.load(std::memory_order_relaxed);
+        return current && current->storage.slot == 0 ? 1 : 0;
+    }
+
+    // Maps one slot into model and opens the blob at its start.
+    static bool map_slot(const esp_partition_t* part, int slot, PolarModel& model)
+    {
+        const void* addr = nullptr;
+        if (esp_partition_mmap(part, slot * kSlotSize, kSlotSize, ESP_PARTITION_MMAP_DATA, &addr,
+                               &model.storage.map_handle) != ESP_OK)
+            return false;
+        model.storage.mapped = true;
+        model.storage.slot = slot;
+        return open_polar(addr, kSlotSize, model.polar, part->label);
+    }
+
+    static bool sector_blank(const esp_partition_t* part, std::size_t offset)
+    {
+        uint8_t page[kPageSize];
+        for (std::size_t at = 0; at < SPI_FLASH_SEC_SIZE; at += sizeof(page))
         {
-            i1 = i2 = static_cast<int>(kWeights.size() - 1);
-            factor = 0.0f;
-            return;
+            if (esp_partition_read(part, offset + at, page, sizeof(page)) != ESP_OK) return false;
+            for (const uint8_t b : page)
+                if (b != 0xFF) return false;
         }
-        for (std::size_t i = 0; i + 1 < kWeights.size(); ++i)
+        return true;
+    }
+
+    // Erases the sectors covering the first len bytes of a slot. Flash
+    // operations stop the cache on both cores, so the LVGL task cannot draw
+    // while one runs: sectors are erased one at a time with a tick in
+    // between (one call for the whole range would be a 64 KB block erase),
+    // and sectors already blank are skipped.
+    static bool erase_slot(const esp_partition_t* part, int slot, std::size_t len)
+    {
+        if (len > kSlotSize) return false;
+        for (std::size_t at = kSlotErased[slot]; at < len; at += SPI_FLASH_SEC_SIZE)
         {
-            if (w >= kWeights[i] && w <= kWeights[i + 1])
+            const std::size_t offset = slot * kSlotSize + at;
+            if (!sector_blank(part, offset))
             {
-                i1 = static_cast<int>(i);
-                i2 = static_cast<int>(i + 1);
-                factor = (w - static_cast<float>(kWeights[i1])) /
-                         static_cast<float>(kWeights[i2] - kWeights[i1]);
-                return;
+                if (esp_partition_erase_range(part, offset, SPI_FLASH_SEC_SIZE) != ESP_OK) return false;
+                vTaskDelay(1);
             }
+            kSlotErased[slot] = at + SPI_FLASH_SEC_SIZE;
         }
-        i1 = i2 = 0;
-        factor = 0.0f;
+        return true;
     }
 
-    static inline bool has_range(const Range& r) { return r.vmin >= 0.0f && r.vmax >= 0.0f; }
-
-    FlapSymbolResult get_optimal_flap(float gewicht_kg, float geschwindigkeit_kmh)
+    // Programs len bytes at offset at of an erased slot, a page per call
+    // and a tick after each sector, for the same reason.
+    static bool write_slot(const esp_partition_t* part, int slot, std::size_t at, const void* data,
+                           std::size_t len)
     {
-        if (has_range(kLowSpeedRange) &&
-            geschwindigkeit_kmh >= kLowSpeedRange.vmin &&
-            geschwindigkeit_kmh <= kLowSpeedRange.vmax)
+        kSlotErased[slot] = std::min(kSlotErased[slot], at);
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        while (len > 0)
         {
-            return {find_flap_index_by_symbol(kLowSpeedWk)};
+            const std::size_t n = std::min(len, kPageSize - at % kPageSize);
+            if (esp_partition_write(part, slot * kSlotSize + at, src, n) != ESP_OK) return false;
+            at += n;
+            src += n;
+            len -= n;
+            if (at % SPI_FLASH_SEC_SIZE == 0) vTaskDelay(1);
         }
+        return true;
+    }
 
-        if (kBereiche.empty() || kWeights.empty()) return {-1};
+    // Install number for a copy about to be written: above both slots', so
+    // the newest copy of a polar wins at boot.
+    static uint32_t next_install(const esp_partition_t* part)
+    {
+        uint32_t newest = 0;
+        for (int slot = 0; slot < kSlotCount; ++slot)
+        {
+            fpol::Header h{};
+            if (esp_partition_read(part, slot * kSlotSize, &h, sizeof(h)) == ESP_OK && h.magic == fpol::kMagic &&
+                h.version == fpol::kVersion)
+                newest = std::max(newest, h.install);
+        }
+        return newest + 1;
+    }
 
-        int i1 = 0, i2 = 0;
-        float f = 0.0f;
-        weight_bracket(gewicht_kg, i1, i2, f);
+    // Whether a slot holds what loading `path` would produce: for a JSON,
+    // its size and CRC-32 must match the ones recorded at conversion; for a
+    // .fpol, the slot must be a copy of that very file.
+    static bool matches_source(const fpol::View& slot, const char* path)
+    {
+        if (!same_polar(slot.name(), path)) return false;
+        const fpol::Header& h = *slot.header;
+        if (ends_with(path, ".fpol"))
+        {
+            FILE* f = fopen(path, "rb");
+            if (!f) return false;
+            fpol::Header file{};
+            const bool read = fread(&file, 1, sizeof(file), f) == sizeof(file);
+            fclose(f);
+            return read && file.file_size == h.file_size && file.crc32 == h.crc32;
+        }
+        uint32_t size = 0, crc = 0;
+        return fpol::source_fingerprint(path, size, crc) && size == h.source_size && crc == h.source_crc32;
+    }
 
-        for (std::size_t idx = 0; idx < kBereiche.size(); ++idx)
+    // Publishes the newest slot holding the polar in `path` as it is now.
+    // Reads the source once for its CRC but does not parse it: the boot
+    // path for a persisted polar. False if no slot matches, e.g. after the
+    // file was replaced; the caller then loads it afresh.
+    static bool map_persisted(const char* path)
+    {
+        const std::lock_guard<std::mutex> lock(kLoadMutex);
+        const esp_partition_t* part = polar_partition();
+        if (!part) return false;
+        reclaim_retired();
+        PolarModel* best = nullptr;
+        for (int slot = 0; slot < kSlotCount; ++slot)
         {
-            const auto& b = kBereiche[idx];
-            if (b.ranges.size() <= static_cast<std::size_t>(std::max(i1, i2))) continue;
-            const Range r1 = b.ranges[i1];
-            const Range r2 = b.ranges[i2];
-            if (has_range(r1) && has_range(r2))
-            {
-                const float vmin = r1.vmin + f * (r2.vmin - r1.vmin);
-                const float vmax = r1.vmax + f * (r2.vmax - r1.vmax);
-                if (geschwindigkeit_kmh >= vmin && geschwindigkeit_kmh <= vmax)
-                    return {
-                        static_cast<int>(idx)
-                    };
-            }
-            else if (has_range(r1))
+            PolarModel& model = new_model();
+            if (!map_slot(part, slot, model) || !matches_source(model.polar, path) ||
+                (best && best->polar.header->install >= model.polar.header->install))
             {
-                if (geschwindigkeit_kmh >= r1.vmin && geschwindigkeit_kmh <= r1.vmax)
-                    return {
-                        static_cast<int>(idx)
-                    };
-            }
-            else if (has_range(r2))
-            {
-                if (geschwindigkeit_kmh >= r2.vmin && geschwindigkeit_kmh <= r2.vmax)
-                    return {
-                        static_cast<int>(idx)
-                    };
+                free_model(&model);
+                continue;
             }
+            if (best) free_model(best);
+            best = &model;
         }
-        return {-1};
+        if (!best) return false;
+        std::snprintf(best->name, sizeof(best->name), "%s", base_name(path));
+        publish(*best);
+        return true;
     }
+#endif
 
-    std::vector<FlapSpeedRange> get_flap_speed_ranges(float gewicht_kg)
+    static bool build_from_fpol(const char* filepath, PolarModel& model)
     {
-        std::vector<FlapSpeedRange> result;
-        if (kBereiche.empty() || kWeights.empty()) return result;
+#ifdef NATIVE_TEST_BUILD
+        const int fd = ::open(filepath, O_RDONLY);
+        if (fd < 0)
+        {
+            printf("flaputils: Failed to open %s\n", filepath);
+            return false;
+        }
+        struct stat st{};
+        void* addr = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED)
+        {
+            printf("flaputils: Failed to map %s\n", filepath);
+            return false;
+        }
+        model.storage.map_addr = addr;
+        model.storage.map_len = static_cast<std::size_t>(st.st_size);
+        if (!open_polar(addr, model.storage.map_len, model.polar, filepath)) return false;
+        return true;
+#else
+        // Copied into the free slot in stack-sized pieces, so a large polar
+        // never sits in RAM.
+        const esp_partition_t* part = polar_partition();
+        if (!part)
+        {
+            printf("flaputils: No polar partition for %s\n", filepath);
+            return false;
+        }
+        FILE* f = fopen(filepath, "rb");
+        if (!f)
+        {
+            printf("flaputils: Failed to open %s\n", filepath);
+            return false;
+        }
+        fpol::Header h{};
+        if (fread(&h, 1, sizeof(h), f) != sizeof(h) || h.magic != fpol::kMagic || h.version != fpol::kVersion ||
+            h.file_size < sizeof(h) || h.file_size > kSlotSize)
+        {
+            printf("flaputils: %s is not a usable .fpol file\n", filepath);
+            fclose(f);
+            return false;
+        }
 
-        int i1 = 0, i2 = 0;
-        float f = 0.0f;
-        weight_bracket(gewicht_kg, i1, i2, f);
+        h.install = next_install(part);
+        const int slot = free_slot();
+        bool ok = erase_slot(part, slot, h.file_size) && write_slot(part, slot, 0, &h, sizeof(h));
+        uint8_t chunk[kPageSize];
+        for (std::size_t at = sizeof(h); ok && at < h.file_size;)
+        {
+            const std::size_t n = fread(chunk, 1, std::min(sizeof(chunk), h.file_size - at), f);
+            ok = n > 0 && write_slot(part, slot, at, chunk, n);
+            at += n;
+        }
+        fclose(f);
+        if (!ok || !map_slot(part, slot, model))
+        {
+            printf("flaputils: Failed to install %s\n", filepath);
+            return false;
+        }
+        return true;
+#endif
+    }
 
-        result.reserve(kBereiche.size());
-        for (std::size_t idx = 0; idx < kBereiche.size(); ++idx)
+    static bool build_from_json(const char* filepath, PolarModel& model)
+    {
+        std::string error;
+        std::vector<uint8_t> blob = fpol::from_json_file(filepath, &error);
+        if (blob.empty())
+        {
+            printf("flaputils: Failed to load %s: %s\n", filepath, error.c_str());
+            return false;
+        }
+        if (!open_polar(blob.data(), blob.size(), model.polar, filepath)) return false;
+#ifndef NATIVE_TEST_BUILD
+        // Converted once; from the next boot on it is mapped, not parsed.
+        if (const esp_partition_t* part = polar_partition())
         {
-            const auto& b = kBereiche[idx];
-            if (b.ranges.size() <= static_cast<std::size_t>(std::max(i1, i2))) continue;
-            
-            const Range r1 = b.ranges[i1];
-            const Range r2 = b.ranges[i2];
-            
-            float vmin = -1.0f;
-            float vmax = -1.0f;
+            const uint32_t install = next_install(part);
+            std::memcpy(blob.data() + offsetof(fpol::Header, install), &install, sizeof(install));
+            const int slot = free_slot();
+            if (erase_slot(part, slot, blob.size()) && write_slot(part, slot, 0, blob.data(), blob.size()) &&
+                map_slot(part, slot, model))
+                return true;
+            printf("flaputils: Polar partition not written, keeping %s in RAM\n", filepath);
+            model.storage.release();
+        }
+#endif
+        model.storage.owned = std::move(blob);
+        return open_polar(model.storage.owned.data(), model.storage.owned.size(), model.polar, filepath);
+    }
 
-            if (has_range(r1) && has_range(r2))
-            {
-                vmin = static_cast<float>(r1.vmin + f * (r2.vmin - r1.vmin));
-                vmax = static_cast<float>(r1.vmax + f * (r2.vmax - r1.vmax));
-            }
-            else if (has_range(r1))
-            {
-                vmin = static_cast<float>(r1.vmin);
-                vmax = static_cast<float>(r1.vmax);
-            }
-            else if (has_range(r2))
-            {
-                vmin = static_cast<float>(r2.vmin);
-                vmax = static_cast<float>(r2.vmax);
-            }
+    bool load_data(const char* filepath)
+    {
+        const std::lock_guard<std::mutex> lock(kLoadMutex);
+        // Frees the model before the current one first: on the device its
+        // partition slot is where the new one goes.
+        reclaim_retired();
+        PolarModel& model = new_model();
+        if (!(ends_with(filepath, ".fpol") ? build_from_fpol(filepath, model) : build_from_json(filepath, model)))
+        {
+            free_model(&model);
+            return false;
+        }
+        std::snprintf(model.name, sizeof(model.name), "%s", base_name(filepath));
+        publish(model);
+        return true;
+    }
 
-            result.push_back({
-                static_cast<int>(idx),
-                vmin,
-                vmax
-            });
+#ifndef NATIVE_TEST_BUILD
+    void prepare_polar_slot()
+    {
+        const std::lock_guard<std::mutex> lock(kLoadMutex);
+        const esp_partition_t* part = polar_partition();
+        // Without a current model, the free slot may be the one
+        // load_persisted_data() wants.
+        if (!part || !kModel.load(std::memory_order_relaxed)) return;
+        // The retired model is mapped from the free slot.
+        reclaim_retired();
+        erase_slot(part, free_slot(), kSlotSize);
+    }
+#endif
+
+    float get_empty_mass()
+    {
+        const ReadSection m;
+        return m ? m->polar.header->empty_mass_kg : 0.0f;
+    }
+
+    SpeedLimits get_speed_limits()
+    {
+        const ReadSection m;
+        return m ? m->speed_limits() : kDefaultSpeedLimits;
+    }
+
+    const SpeedLimits& get_display_speed_limits()
+    {
+        const ReadSection m;
+        const uint32_t serial = m ? m->serial : 0;
+        if (kDisplayLimitsGen != units::generation() || kDisplayLimitsSerial != serial)
+        {
+            const SpeedLimits sl = m ? m->speed_limits() : kDefaultSpeedLimits;
+            const float k = units::speed().per_kmh;
+            kDisplayLimits = {sl.vso * k, sl.vfe * k, sl.vs1 * k, sl.vno * k, sl.vne * k};
+            kDisplayLimitsGen = units::generation();
+            kDisplayLimitsSerial = serial;
         }
-        return result;
+        return kDisplayLimits;
+    }
+
+    FlapSymbolResult get_flap_symbol(int flapIdx)
+    {
+        const ReadSection m;
+        if (m && flapIdx >= 0 && static_cast<std::size_t>(flapIdx) < m->polar.flap_count())
+        {
+            return {flapIdx};
+        }
+        return {-1};
+    }
+
+    FlapSymbolResult get_optimal_flap(float gewicht_kg, float geschwindigkeit_kmh)
+    {
+        const ReadSection m;
+        return {m ? m->optimal_flap(gewicht_kg, geschwindigkeit_kmh) : -1};
+    }
+
+    std::size_t get_flap_speed_ranges(float gewicht_kg, std::span<FlapSpeedRange> out)
+    {
+        const ReadSection m;
+        return m ? m->speed_ranges(gewicht_kg, out) : 0;
+    }
+
+    // Copies a symbol while the ReadSection keeps its model alive.
+    static bool copy_symbol(const char* symbol, char* out, std::size_t cap)
+    {
+        if (cap == 0) return false;
+        std::snprintf(out, cap, "%s", symbol ? symbol : "");
+        return symbol != nullptr;
     }
 
-    const char* get_flap_symbol_name(int index)
+    bool get_flap_symbol_name(int index, char* out, std::size_t cap)
     {
-        if (index < 0 || static_cast<std::size_t>(index) >= kFlapTable.size()) return nullptr;
-        return kFlapTable[index].symbol.c_str();
+        const ReadSection m;
+        if (!m || index < 0 || static_cast<std::size_t>(index) >= m->polar.flap_count())
+            return copy_symbol(nullptr, out, cap);
+        return copy_symbol(m->polar.symbol(m->polar.flap_labels[index]), out, cap);
     }
 
-    const char* get_range_symbol_name(int index)
+    bool get_range_symbol_name(int index, char* out, std::size_t cap)
     {
-        if (index < 0 || static_cast<std::size_t>(index) >= kBereiche.size()) return nullptr;
-        return kBereiche[index].wk.c_str();
+        const ReadSection m;
+        if (!m || index < 0 || static_cast<std::size_t>(index) >= m->polar.band_count())
+            return copy_symbol(nullptr, out, cap);
+        return copy_symbol(m->polar.symbol(m->polar.band_symbols[index]), out, cap);
     }
 
-    const char* get_polar()
+    std::string get_polar()
     {
-        return kCurrentPolar.c_str();
+        const ReadSection m;
+        return m ? m->name : "";
     }
 
     bool save_polar_path(const char* filepath)
@@ -424,7 +853,7 @@ namespace flaputils
         nvs_close(my_handle);
 
         if (err == ESP_OK) {
-            return load_data(path);
+            return map_persisted(path) || load_data(path);
         }
         return false;
 #else
@@ -458,7 +887,7 @@ namespace flaputils
         {
             if (ent->d_name[0] == '.') continue;
             std::string filename = ent->d_name;
-            if (filename.length() > 5 && filename.substr(filename.length() - 5) == ".json")
+            if (ends_with(filename.c_str(), ".json") || ends_with(filename.c_str(), ".fpol"))
             {
                 //if (filename == "ventus3_defaut.json") continue;
                 first_file = std::string(dir_path) + "/" + filename;
@@ -1,16 +1,31 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
+#include <span>
 #include <string>
 
 namespace flaputils
 {
+    // Most flap bands a polar may have: the bus reports flap positions 0..31.
+    inline constexpr std::size_t kMaxFlapBands = 32;
+    // Buffer size for a flap symbol ("L", "+2", "S1"); longer ones are cut.
+    inline constexpr std::size_t kSymbolSize = 8;
+
     // Returns the empty mass of the aircraft in kg (taken from ventus3_defaut.json)
     float get_empty_mass();
 
-    // Loads the flap data from a JSON file. Returns true on success.
+    // Loads the flap data from a JSON or .fpol file. Returns true on success;
+    // on failure the previous polar stays active. Safe while other tasks look
+    // up flaps: they see the old polar until the new one is switched in whole.
+    // Loads are serialized with each other.
     bool load_data(const char* filepath);
 
+#ifndef NATIVE_TEST_BUILD
+    // Erases the partition slot the next load_data() writes to, so that
+    // load only programs it. For the loader task, when idle.
+    void prepare_polar_slot();
+#endif
+
     // Returns the flap symbol for a given raw position and the index in the table.
     // If no match is found within tolerance, returns {nullptr, -1}.
     struct FlapSymbolResult
@@ -27,14 +42,16 @@ namespace flaputils
     // Returns {nullptr, -1} if no matching range is found or data is unavailable.
     FlapSymbolResult get_optimal_flap(float gewicht_kg, float geschwindigkeit_kmh);
 
-    // Returns the symbol for a given flap index.
-    const char* get_flap_symbol_name(int index);
+    // Copies the symbol for a given flap index into out (cap bytes, NUL
+    // terminated). Returns false, with out empty, if there is no such flap.
+    // Copied because a load on another task may free the polar right after.
+    bool get_flap_symbol_name(int index, char* out, std::size_t cap);
 
-    // Returns the symbol for a given speed range index.
-    const char* get_range_symbol_name(int index);
+    // Same for a given speed range index.
+    bool get_range_symbol_name(int index, char* out, std::size_t cap);
 
-    // Returns the current loaded polar filename.
-    const char* get_polar();
+    // Returns the current loaded polar filename, "" if none.
+    std::string get_polar();
 
     // Persists the current polar path to NVS.
     bool save_polar_path(const char* filepath);
@@ -54,8 +71,12 @@ namespace flaputils
         float upper_speed;
     };
 
-    std::vector<FlapSpeedRange> get_flap_speed_ranges(float gewicht_kg);
-    
+    // Fills out with the speed range of each flap band at the given weight,
+    // in band order, and returns how many were written; at most out.size(),
+    // so a shorter buffer keeps the first bands. Copies from the band cache
+    // and does not allocate.
+    std::size_t get_flap_speed_ranges(float gewicht_kg, std::span<FlapSpeedRange> out);
+
     struct SpeedLimits
     {
         float vso;
@@ -65,6 +86,11 @@ namespace flaputils
         float vne;
     };
 
+    // Speed limits from the polar, in km/h.
     SpeedLimits get_speed_limits();
 
+    // The same limits in the display speed unit (units::speed()). Converted
+    // once per unit change or polar load, not per call.
+    const SpeedLimits& get_display_speed_limits();
+
 } // namespace flaputils
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "flight_data.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Encoders generated from FLIGHT_SIGNALS (flight_schema.hpp). Each one
+// expands to straight-line code over the schema rows; nothing is looked up
+// at run time.
+namespace flight_codec
+{
+    // ---------------- binary log records ----------------
+    //
+    // Layout (little-endian, as on both the ESP32-S3 and the host):
+    //   uint32_t timestamp_ms
+    //   uint32_t received       SignalMask of signals received at least once
+    //   uint32_t out_of_range   FlightSnapshot validity masks
+    //   uint32_t decode_error
+    //   every schema field      in FLIGHT_SIGNALS order, sizeof(type) bytes,
+    //                           raw (before scale)
+    //
+    // kRecordSchema changes whenever a row's name, type or scale changes, so
+    // a reader can refuse records written by another firmware.
+
+    inline constexpr std::size_t kRecordHeaderSize = 16;
+
+    inline constexpr std::size_t kRecordSize = kRecordHeaderSize
+#define FLIGHT_CODEC_SIZE(sig, field, type, ...) +sizeof(type)
+        FLIGHT_SIGNALS(FLIGHT_CODEC_SIZE)
+#undef FLIGHT_CODEC_SIZE
+        ;
+
+    constexpr uint32_t fnv1a(uint32_t h, const char* s)
+    {
+        while (*s)
+        {
+            h ^= static_cast<uint8_t>(*s++);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    inline constexpr uint32_t kRecordSchema = []
+    {
+        uint32_t h = 2166136261u;
+#define FLIGHT_CODEC_HASH(sig, field, type, unit, scale, ...) \
+    h = fnv1a(h, #field);                                   \
+    h = fnv1a(h, #type);                                    \
+    h = fnv1a(h, #scale);
+        FLIGHT_SIGNALS(FLIGHT_CODEC_HASH)
+#undef FLIGHT_CODEC_HASH
+        return h;
+    }();
+
+    // Writes kRecordSize bytes to out.
+    inline void encode_record(const FlightSnapshot& s, uint32_t timestamp_ms, uint8_t* out)
+    {
+        const SignalMask received = kAllSignals & ~s.never_received(kAllSignals);
+        std::memcpy(out, &timestamp_ms, 4);
+        std::memcpy(out + 4, &received, 4);
+        std::memcpy(out + 8, &s.out_of_range, 4);
+        std::memcpy(out + 12, &s.decode_error, 4);
+        uint8_t* p = out + kRecordHeaderSize;
+#define FLIGHT_CODEC_ENCODE(sig, field, type, ...) \
+    std::memcpy(p, &s.field, sizeof(type));        \
+    p += sizeof(type);
+        FLIGHT_SIGNALS(FLIGHT_CODEC_ENCODE)
+#undef FLIGHT_CODEC_ENCODE
+    }
+
+    // Reads kRecordSize bytes into the schema fields and validity masks of s.
+    // Returns the received mask; timestamp_ms receives the record time.
+    inline SignalMask decode_record(const uint8_t* in, FlightSnapshot& s, uint32_t& timestamp_ms)
+    {
+        SignalMask received;
+        std::memcpy(&timestamp_ms, in, 4);
+        std::memcpy(&received, in + 4, 4);
+        std::memcpy(&s.out_of_range, in + 8, 4);
+        std::memcpy(&s.decode_error, in + 12, 4);
+        const uint8_t* p = in + kRecordHeaderSize;
+#define FLIGHT_CODEC_DECODE(sig, field, type, ...) \
+    std::memcpy(&s.field, p, sizeof(type));        \
+    p += sizeof(type);
+        FLIGHT_SIGNALS(FLIGHT_CODEC_DECODE)
+#undef FLIGHT_CODEC_DECODE
+        return received;
+    }
+
+    // ---------------- telemetry ----------------
+    //
+    // One NMEA-style text line per call, for a serial or BLE link:
+    //   $FSD,<timestamp_ms>,<field>=<value>,...*<XOR checksum in hex>\r\n
+    // Values are scaled to the schema unit with the schema's decimals. Only
+    // the signals in `signals` are sent, so a caller can pass what changed.
+    //
+    // Returns the line length, or 0 if it does not fit into cap bytes.
+    inline std::size_t encode_telemetry(const FlightSnapshot& s, SignalMask signals, uint32_t timestamp_ms, char* out,
+                                        std::size_t cap)
+    {
+        std::size_t n = 0;
+        auto put = [&](int written)
+        {
+            if (written < 0 || n + static_cast<std::size_t>(written) >= cap)
+                n = cap;
+            else
+                n += static_cast<std::size_t>(written);
+        };
+        put(std::snprintf(out, cap, "$FSD,%lu", static_cast<unsigned long>(timestamp_ms)));
+#define FLIGHT_CODEC_TELEMETRY(sig, field, type, unit, scale, decimals, ...)                                  \
+    if (n < cap && (signals & signal_mask(FlightSignal::sig)))                                                  \
+        put(std::snprintf(out + n, cap - n, "," #field "=%.*f", decimals, static_cast<double>(s.field) * (scale)));
+        FLIGHT_SIGNALS(FLIGHT_CODEC_TELEMETRY)
+#undef FLIGHT_CODEC_TELEMETRY
+        if (n + 6 > cap) return 0;
+        uint8_t checksum = 0;
+        for (std::size_t i = 1; i < n; ++i) checksum ^= static_cast<uint8_t>(out[i]);
+        put(std::snprintf(out + n, cap - n, "*%02X\r\n", checksum));
+        return n < cap ? n : 0;
+    }
+
+    // ---------------- debug printer ----------------
+
+    // "ias=27.31 m/s tas=... " for every schema field, scaled to its unit.
+    inline void print_values(const FlightSnapshot& s, std::FILE* out = stdout)
+    {
+#define FLIGHT_CODEC_PRINT(sig, field, type, unit, scale, decimals, ...) \
+    std::fprintf(out, #field "=%.*f%s%s ", decimals, static_cast<double>(s.field) * (scale), *unit ? " " : "", unit);
+        FLIGHT_SIGNALS(FLIGHT_CODEC_PRINT)
+#undef FLIGHT_CODEC_PRINT
+    }
+} // namespace flight_codec
@@ -1,8 +1,12 @@
 #pragma once
 
-#include <mutex>
-#include <string>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include "flight_schema.hpp"
+#include "seqlock.hpp"
 
 #ifdef NATIVE_TEST_BUILD
 #include <chrono>
@@ -10,25 +14,188 @@
 #include "esp_timer.h"
 #endif
 
+// Signals received over CAN (FLIGHT_SIGNALS), one bit each in a SignalMask.
+// Every signal has its own receive timestamp and staleness timeout.
+enum class FlightSignal : uint8_t
+{
+#define FLIGHT_SIGNAL_ENUM(sig, ...) sig,
+    FLIGHT_SIGNALS(FLIGHT_SIGNAL_ENUM)
+#undef FLIGHT_SIGNAL_ENUM
+    Count
+};
+
+inline constexpr std::size_t kFlightSignalCount = static_cast<std::size_t>(FlightSignal::Count);
+
+using SignalMask = uint32_t;
+
+constexpr SignalMask signal_mask(FlightSignal s) { return SignalMask{1} << static_cast<unsigned>(s); }
+
+inline constexpr SignalMask kAllSignals = (SignalMask{1} << kFlightSignalCount) - 1;
+
+template <typename... Signals>
+constexpr SignalMask signal_mask(FlightSignal first, Signals... rest)
+{
+    return (signal_mask(first) | ... | signal_mask(rest));
+}
+
+// Per-signal staleness timeout in milliseconds. kNoTimeout marks values that
+// are only sent on change (ballast, QNH correction): they go stale only if
+// they were never received.
+struct SignalTimeouts
+{
+    static constexpr uint32_t kNoTimeout = UINT32_MAX;
+    static constexpr uint32_t kPeriodicTimeoutMs = 10000;
+    // Grace period after boot before a never-received signal counts as stale.
+    static constexpr uint32_t kBootGraceMs = 10000;
+
+    std::array<uint32_t, kFlightSignalCount> ms;
+};
+
+constexpr uint32_t staleness_timeout_ms(FlightStaleness s)
+{
+    return s == FlightStaleness::OnChange ? SignalTimeouts::kNoTimeout : SignalTimeouts::kPeriodicTimeoutMs;
+}
+
+inline constexpr SignalTimeouts kDefaultSignalTimeouts = {{
+#define FLIGHT_SIGNAL_TIMEOUT(sig, field, type, unit, scale, decimals, lo, hi, can_id, can_type, decode, staleness) \
+    staleness_timeout_ms(FlightStaleness::staleness),
+    FLIGHT_SIGNALS(FLIGHT_SIGNAL_TIMEOUT)
+#undef FLIGHT_SIGNAL_TIMEOUT
+}};
+
+// Origin of FlightSnapshot::wind_speed and wind_direction.
+enum class WindSource : uint8_t
+{
+    None,
+    Bus,      // IDs 333/334 from the flight computer
+    Triangle, // TAS/heading against GPS ground speed/track
+    Circling, // circle fit of the GPS ground speed while circling
+};
+
+// Plain copy of all flight values, consumed by the screens once per frame.
+struct FlightSnapshot
+{
+    // One member per FLIGHT_SIGNALS row, in schema units (SI, mass in 0.1 kg,
+    // position in 1e-7 deg).
+#define FLIGHT_SNAPSHOT_FIELD(sig, field, type, ...) type field = 0;
+    FLIGHT_SIGNALS(FLIGHT_SNAPSHOT_FIELD)
+#undef FLIGHT_SNAPSHOT_FIELD
+
+    // Not on the bus.
+    float ias_rate = 0; // smoothed IAS trend in m/s per second, updated with every IAS sample
+    int32_t home_lat = 0; // first position fix after power-on, 1e-7 deg; valid if has_home
+    int32_t home_lon = 0;
+    bool has_home = false;
+    WindSource wind_source = WindSource::None;
+    uint8_t wind_quality = 0; // 0..100, 100 for wind from the bus
+
+    // Receive time per signal on the FlightData::monotonic_ms() clock, 0 = never.
+    // Kept as 32 bits (wraps after 49 days) to keep the published copy small.
+    std::array<uint32_t, kFlightSignalCount> rx_ms{};
+
+    // Signals whose latest sample was rejected: outside the schema range, or
+    // not a number. The field keeps the last good value and its rx_ms, so it
+    // also goes stale on its own if the bad samples continue. Cleared by the
+    // next good sample.
+    SignalMask out_of_range = 0;
+    SignalMask decode_error = 0;
+
+    // Per-signal validity, see field_flags().
+    enum FieldFlag : uint8_t
+    {
+        kNeverReceived = 1 << 0,
+        kStale = 1 << 1,
+        kOutOfRange = 1 << 2,
+        kDecodeError = 1 << 3,
+    };
+
+    uint32_t received_ms(FlightSignal s) const { return rx_ms[static_cast<std::size_t>(s)]; }
+
+    // Subset of `signals` that was never received.
+    SignalMask never_received(SignalMask signals) const
+    {
+        SignalMask missing = 0;
+        for (SignalMask m = signals & kAllSignals; m; m &= m - 1)
+        {
+            const unsigned i = static_cast<unsigned>(std::countr_zero(m));
+            if (rx_ms[i] == 0) missing |= SignalMask{1} << i;
+        }
+        return missing;
+    }
+
+    // Subset of `signals` received at least once whose timeout has run out.
+    SignalMask timed_out(SignalMask signals, uint64_t now_ms,
+                         const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        SignalMask late = 0;
+        for (SignalMask m = signals & kAllSignals; m; m &= m - 1)
+        {
+            const unsigned i = static_cast<unsigned>(std::countr_zero(m));
+            if (rx_ms[i] != 0 && timeouts.ms[i] != SignalTimeouts::kNoTimeout &&
+                static_cast<uint32_t>(now_ms) - rx_ms[i] >= timeouts.ms[i])
+                late |= SignalMask{1} << i;
+        }
+        return late;
+    }
+
+    // Subset of `signals` that is stale at now_ms. Never-received signals
+    // only count after the boot grace period, so the screens do not flash
+    // their stale overlay while the bus comes up.
+    SignalMask stale_signals(SignalMask signals, uint64_t now_ms,
+                             const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        SignalMask stale = timed_out(signals, now_ms, timeouts);
+        if (now_ms >= SignalTimeouts::kBootGraceMs) stale |= never_received(signals);
+        return stale;
+    }
+
+    // Subset of `signals` that must not be computed with: never received,
+    // timed out, or last sample rejected. No boot grace.
+    SignalMask invalid_signals(SignalMask signals, uint64_t now_ms,
+                               const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        const SignalMask rejected = (out_of_range | decode_error) & signals;
+        return rejected | never_received(signals & ~rejected) | timed_out(signals & ~rejected, now_ms, timeouts);
+    }
+
+    bool is_valid(SignalMask signals, uint64_t now_ms, const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        return invalid_signals(signals, now_ms, timeouts) == 0;
+    }
+
+    // FieldFlag bits for one signal, 0 if valid.
+    uint8_t field_flags(FlightSignal s, uint64_t now_ms, const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        const SignalMask bit = signal_mask(s);
+        uint8_t flags = 0;
+        if (never_received(bit)) flags |= kNeverReceived;
+        if (timed_out(bit, now_ms, timeouts)) flags |= kStale;
+        if (out_of_range & bit) flags |= kOutOfRange;
+        if (decode_error & bit) flags |= kDecodeError;
+        return flags;
+    }
+
+    bool is_stale(SignalMask signals, uint64_t now_ms,
+                  const SignalTimeouts& timeouts = kDefaultSignalTimeouts) const
+    {
+        return stale_signals(signals, now_ms, timeouts) != 0;
+    }
+};
+
+// Shared flight state. The CAN task is the only writer: it edits `pending`
+// and calls publish(); every other thread reads through snapshot(), which
+// never takes a lock.
+//
+// publish() also ORs the signals that changed into a dirty mask, so the UI
+// can skip ticks without new data (take_changes()) and be woken when a
+// watched signal arrives (set_change_listener()).
 struct FlightData
 {
-    mutable std::mutex mtx;
-    float ias = 0;
-    float tas = 0;
-    float alt = 0;
-    float alt_corr = 0;
-    float vario = 0;
-    int flapIdx = 0;
-    double lat = 0;
-    double lon = 0;
-    float gps_ground_speed = 0;
-    float gps_true_track = 0;
-    uint16_t dry_and_ballast_mass = 0;
-    uint16_t enl = 0;
-    float wind_speed = 0;
-    float wind_direction = 0;
-    float heading = 0;
-    uint64_t last_relevant_rx_ms = 0;
+    // Runs on the writer thread after a publish that changed a watched
+    // signal. Must not block.
+    using ChangeListener = void (*)();
+
+    FlightSnapshot pending;
 
     static uint64_t monotonic_ms()
     {
@@ -40,61 +207,41 @@ struct FlightData
 #endif
     }
 
-    void update_float(const std::string& key, float value)
+    void publish(SignalMask changed = kAllSignals)
     {
-        std::lock_guard<std::mutex> lock(mtx);
-        if (key == "ias")
-        {
-            ias = value;
-            last_relevant_rx_ms = monotonic_ms();
-        }
-        else if (key == "tas") tas = value;
-        else if (key == "alt") alt = value;
-        else if (key == "alt_corr") alt_corr = value;
-        else if (key == "vario") vario = value;
-        else if (key == "gps_ground_speed")
-        {
-            gps_ground_speed = value;
-            last_relevant_rx_ms = monotonic_ms();
-        }
-        else if (key == "gps_true_track") gps_true_track = value;
-        else if (key == "wind_speed") wind_speed = value;
-        else if (key == "wind_direction") wind_direction = value;
-        else if (key == "heading") heading = value;
+        published.store(pending);
+        // Sequentially consistent, pairs with the UI arming its wake-up and
+        // then peeking at the mask.
+        changed_.fetch_or(changed);
+        if (listener_ && (changed & watched_.load())) listener_();
     }
 
-    void update_double(const std::string& key, double value)
-    {
-        std::lock_guard lock(mtx);
-        if (key == "lat") lat = value;
-        else if (key == "lon") lon = value;
-    }
+    FlightSnapshot snapshot() const { return published.load(); }
 
-    void update_int(const std::string& key, int value)
+    // Subset of `signals` published since it was last taken; clears those bits.
+    // Meant for a single consumer per signal (the visible screen).
+    SignalMask take_changes(SignalMask signals)
     {
-        std::lock_guard lock(mtx);
-        if (key == "flap")
-        {
-            flapIdx = value;
-            last_relevant_rx_ms = monotonic_ms();
-        }
+        return changed_.fetch_and(~signals) & signals;
     }
 
-    void update_uint16(const std::string& key, uint16_t value)
+    // Same without clearing.
+    SignalMask peek_changes(SignalMask signals) const
     {
-        std::lock_guard lock(mtx);
-        if (key == "dry_and_ballast_mass") dry_and_ballast_mass = value;
-        else if (key == "enl") enl = value;
+        return changed_.load() & signals;
     }
 
-    bool is_stale() const
-    {
-        std::lock_guard lock(mtx);
-        const uint64_t now_ms = monotonic_ms();
-        if (last_relevant_rx_ms == 0)
-        {
-            return now_ms >= 10000ULL; // STALE_TIMEOUT_MS
-        }
-        return (now_ms - last_relevant_rx_ms) >= 10000ULL;
-    }
+    // Set once, before the writer starts.
+    void set_change_listener(ChangeListener listener) { listener_ = listener; }
+
+    // Signals whose publication calls the listener; may change at any time.
+    void watch(SignalMask signals) { watched_.store(signals); }
+
+    bool is_stale(SignalMask signals) const { return snapshot().is_stale(signals, monotonic_ms()); }
+
+private:
+    Seqlock<FlightSnapshot> published;
+    std::atomic<SignalMask> changed_{0};
+    std::atomic<SignalMask> watched_{0};
+    ChangeListener listener_ = nullptr;
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+// The one list of flight values received over CAN. Everything that needs
+// per-signal knowledge expands this macro instead of repeating the list:
+//
+//   FlightSignal, kDefaultSignalTimeouts, FlightSnapshot fields  flight_data.hpp
+//   CAN decoder table (can_dispatch::kSignals)                   can_dispatch.hpp
+//   binary log records, telemetry lines, debug printer          flight_codec.hpp
+//
+// Columns:
+//   Signal     FlightSignal enumerator; also the bit in a SignalMask
+//   field      FlightSnapshot member
+//   type       C++ type of the member, copied as is into log records
+//   unit       physical unit of field * scale
+//   scale      field * scale is the value in unit
+//   decimals   digits after the point in text output
+//   lo, hi     plausible range of the raw field; samples outside it are
+//              rejected and flagged (FlightSnapshot::out_of_range).
+//              Angles may be sent as -180..180 or 0..360; decode_angle
+//              stores them as 0..360
+//   can_id     CANaerospace ID
+//   can_type   CanAerospaceType the sender declares; sets the minimum DLC
+//   decode     CANDecoder function that extracts the payload
+//   staleness  FlightStaleness class
+//
+// Adding a row is all a new CAN value needs. Rows are in FlightSignal order,
+// not CAN ID order; can_dispatch sorts its copy.
+#define FLIGHT_SIGNALS(X)                                                                                     \
+    X(Ias, ias, float, "m/s", 1.0f, 2, -20, 200, 315, Float, decode_float, Periodic)                          \
+    X(Tas, tas, float, "m/s", 1.0f, 2, -20, 250, 316, Float, decode_float, Periodic)                          \
+    X(Heading, heading, float, "deg", 1.0f, 1, -180, 360, 321, Float, decode_angle, Periodic)                 \
+    X(Alt, alt, float, "m", 1.0f, 1, -1000, 20000, 322, Float, decode_float, Periodic)                        \
+    X(AltCorr, alt_corr, float, "m", 1.0f, 1, -3000, 3000, 1519, Float, decode_float, OnChange)               \
+    X(Vario, vario, float, "m/s", 1.0f, 2, -30, 30, 354, Float, decode_float, Periodic)                       \
+    X(Flap, flapIdx, int, "", 1.0f, 0, 0, 31, 340, UChar2, decode_flap_idx, Periodic)                         \
+    X(GpsGroundSpeed, gps_ground_speed, float, "m/s", 1.0f, 2, 0, 300, 1039, Float, decode_float, Periodic)   \
+    X(GpsTrueTrack, gps_true_track, float, "deg", 1.0f, 1, -180, 360, 1040, Float, decode_angle, Periodic)    \
+    X(WindSpeed, wind_speed, float, "m/s", 1.0f, 2, 0, 100, 333, Float, decode_float, Periodic)               \
+    X(WindDirection, wind_direction, float, "deg", 1.0f, 1, -180, 360, 334, Float, decode_angle, Periodic)    \
+    X(Enl, enl, uint16_t, "", 1.0f, 0, 0, 1000, 1506, UShort, decode_u16, Periodic)                           \
+    X(Mass, dry_and_ballast_mass, uint16_t, "kg", 0.1f, 1, 1000, 20000, 1515, UShort, decode_u16, OnChange)   \
+    X(Lat, lat, int32_t, "deg", 1e-7, 7, -900000000, 900000000, 1036, DoubleL, decode_s32, Periodic)          \
+    X(Lon, lon, int32_t, "deg", 1e-7, 7, -1800000000, 1800000000, 1037, DoubleL, decode_s32, Periodic)
+
+// How a signal goes stale.
+enum class FlightStaleness : uint8_t
+{
+    Periodic, // sent continuously; stale after kPeriodicTimeoutMs without a frame
+    OnChange, // sent only on change (ballast, QNH correction); stale only if never received
+};
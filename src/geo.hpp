@@ -0,0 +1,71 @@
+#pragma once
+
+#include "fast_trig.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Great-circle distance and initial bearing between two GPS positions.
+//
+// Positions stay in the fixed point the bus sends (1e-7 deg in an int32), so
+// the latitude and longitude differences are exact integer subtractions. The
+// ESP32-S3 FPU is single precision only: a float latitude near 47 deg
+// resolves about 0.4 m, and subtracting two of them loses most of what a
+// short leg needs. With the difference taken first, the rest is a float
+// haversine with a handful of trig calls and no doubles.
+namespace geo
+{
+    // Mean earth radius (IUGG).
+    inline constexpr float kEarthRadiusM = 6371008.8f;
+    inline constexpr float kDegPerE7 = 1e-7f;
+    inline constexpr float kRadPerE7 = static_cast<float>(3.14159265358979323846 / 180.0 * 1e-7);
+
+    struct Position
+    {
+        int32_t lat_e7;
+        int32_t lon_e7;
+    };
+
+    struct Vector
+    {
+        float distance_m;
+        float bearing_deg; // true, [0, 360), from `from` towards `to`
+    };
+
+    // to - from in 1e-7 deg, wrapped across the date line to [-180, 180).
+    constexpr int32_t delta_lon_e7(int32_t from, int32_t to)
+    {
+        int64_t d = static_cast<int64_t>(to) - from;
+        if (d >= 1800000000) d -= 3600000000LL;
+        else if (d < -1800000000) d += 3600000000LL;
+        return static_cast<int32_t>(d);
+    }
+
+    inline Vector distance_bearing(Position from, Position to)
+    {
+        const float dlat = static_cast<float>(static_cast<int64_t>(to.lat_e7) - from.lat_e7) * kRadPerE7;
+        const float dlon = static_cast<float>(delta_lon_e7(from.lon_e7, to.lon_e7)) * kRadPerE7;
+
+        // The latitudes themselves only enter through sin/cos, where the
+        // table error (2e-5) is far below what matters.
+        const float lat1 = static_cast<float>(from.lat_e7) * kDegPerE7;
+        const float lat2 = static_cast<float>(to.lat_e7) * kDegPerE7;
+        const float sin1 = fast_trig::sin_deg(lat1);
+        const float cos1 = fast_trig::cos_deg(lat1);
+        const float cos2 = fast_trig::cos_deg(lat2);
+
+        // The half-angle sines carry the short legs, so they use the library
+        // sinf, which keeps its relative precision near zero.
+        const float s_lat = std::sin(0.5f * dlat);
+        const float s_lon = std::sin(0.5f * dlon);
+        const float a = s_lat * s_lat + cos1 * cos2 * s_lon * s_lon;
+        const float central = 2.0f * std::asin(std::min(1.0f, std::sqrt(a)));
+
+        // Initial bearing, atan2(sin dlon cos2, cos1 sin2 - sin1 cos2 cos dlon)
+        // with the second term rewritten as sin(dlat) + 2 sin1 cos2 sin^2(dlon/2)
+        // so it does not cancel on short legs.
+        const float east = std::sin(dlon) * cos2;
+        const float north = std::sin(dlat) + 2.0f * sin1 * cos2 * s_lon * s_lon;
+        return {kEarthRadiusM * central, fast_trig::atan2_deg(east, north)};
+    }
+} // namespace geo
@@ -1,6 +1,14 @@
 #include "flight_data.hpp"
-#include "can_decoder.hpp"
+#include "can_acceptance.hpp"
+#include "can_bus_health.hpp"
+#include "can_ingest.hpp"
+#include "can_rx_queue.hpp"
+#include "can_trace.hpp"
+#include "derived_quantities.hpp"
 #include "flaputils.hpp"
+#include "polar_loader.hpp"
+#include "signal_history.hpp"
+#include "units.hpp"
 #include "ui/ui.h"
 #include "ui/ui_helpers.hpp"
 #include "ui/screens/screen1.hpp"
@@ -12,6 +20,8 @@
 #include "ui/screens/screen7.hpp"
 
 #ifndef NATIVE_TEST_BUILD
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdint>
 #include <mutex>
@@ -42,19 +52,14 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
-#include <cerrno>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
-#include <sys/ioctl.h>
-#include <sys/socket.h>
-#include <sys/time.h>
-#include <unistd.h>
-#include <linux/can.h>
-#include <linux/can/raw.h>
-#include <net/if.h>
 #include "lvgl.h"
+#include "platform/can_log_import.hpp"
+#include "platform/can_replay.hpp"
+#include "platform/can_socketcan.hpp"
 #include "platform/ui_platform.hpp"
 #include "ui/screens/screen1.hpp"
 #include "ui/screens/screen3.hpp"
@@ -70,65 +75,285 @@
 
 static const char* TAG = "main";
 static FlightData g_flight_state;
+static CanIngest g_can_ingest(g_flight_state);
+static FlightHistory g_flight_history;
+static DerivedQuantities g_derived;
+
+// Frames that got past the acceptance filter, split into those the display
+// decoded and those the (mask-based) filter could not keep out, followed by
+// the per-ID bus quality taken from the CANaerospace headers.
+static void print_can_stats()
+{
+    const CanIngest::Stats st = g_can_ingest.stats();
+    printf("CAN: accepted=%u, used=%u, not ours=%u, short=%u, type errors=%u, rejected=%u, publishes=%u\n",
+           st.frames, st.consumed, st.ignored, st.short_frames, st.type_errors, st.rejected, st.publishes);
+    for (std::size_t i = 0; i < CanIngest::kIdCount; ++i)
+    {
+        const CanIngest::IdStats id = g_can_ingest.id_stats(i, FlightData::monotonic_ms());
+        if (id.frames == 0 && id.type_errors == 0) continue;
+        printf("  ID %4u: %6.2f Hz, frames=%u, lost=%u, dup=%u, type errors=%u, untyped=%u\n",
+               id.id, id.rate_mhz / 1000.0, id.frames, id.lost, id.duplicates, id.type_errors, id.untyped);
+    }
+}
+
+// Five-minute window of the signals kept in FlightHistory.
+static void print_flight_trends()
+{
+    static constexpr struct
+    {
+        FlightSignal signal;
+        const char* name;
+    } kRows[] = {
+        {FlightSignal::Ias, "IAS"},
+        {FlightSignal::Alt, "Alt"},
+        {FlightSignal::Vario, "Vario"},
+        {FlightSignal::WindSpeed, "Wind"},
+        {FlightSignal::GpsGroundSpeed, "GS"},
+        {FlightSignal::Flap, "Flap"},
+    };
+    for (const auto& row : kRows)
+    {
+        const SignalStats s = g_flight_history.stats(row.signal);
+        if (s.count == 0) continue;
+        printf("  %-5s %3u s: min=%.2f, max=%.2f, mean=%.2f, slope=%+.3f/s\n", row.name,
+               static_cast<unsigned>(s.span_ms / 1000), s.min, s.max, s.mean, s.slope);
+    }
+}
 
 #ifndef NATIVE_TEST_BUILD
 
+// TWAI front-end split in two tasks. The receive task only moves frames from
+// the driver queue into a lock-free CanRxQueue and never waits on anything
+// else, so a slow consumer cannot make the driver drop frames. The ingest task
+// drains the queue into CanIngest and publishes once per wake-up. Both run on
+// core 0, away from the LVGL task.
 class CANReceiver
 {
 public:
-    CANReceiver(FlightData& flight_data) : flight_data(flight_data) {}
+    using Queue = CanRxQueue<128>;
+
+    CANReceiver(CanIngest& ingest) : ingest(ingest) {}
 
     void start()
     {
-        xTaskCreatePinnedToCore(receive_task, "can_rx_task", 4096, this, 5, nullptr, tskNO_AFFINITY);
+        xTaskCreatePinnedToCore(ingest_task, "can_ingest_task", 4096, this, 5, &ingest_handle, 0);
+        xTaskCreatePinnedToCore(receive_task, "can_rx_task", 3072, this, 7, nullptr, 0);
     }
 
-private:
-    FlightData& flight_data;
+    Queue::Counters queue_counters() const { return queue.counters(); }
 
-    static void receive_task(void* arg)
+    // Estimated wire bits of all received frames, for the bus load figure.
+    uint32_t received_bits() const { return rx_bits.load(std::memory_order_relaxed); }
+
+    // Records every ingested frame; call before start().
+    void record_to(CanTraceWriter& writer)
     {
-        auto self = static_cast<CANReceiver*>(arg);
-        self->run();
+        trace = &writer;
+        ingest.set_recorder(trace);
     }
 
-    [[noreturn]] void run() const
+private:
+    CanIngest& ingest;
+    Queue queue;
+    TaskHandle_t ingest_handle = nullptr;
+    CanTraceWriter* trace = nullptr;
+    std::atomic<uint32_t> rx_bits{0}; // written by the receive task only
+
+    static void receive_task(void* arg) { static_cast<CANReceiver*>(arg)->receive_loop(); }
+    static void ingest_task(void* arg) { static_cast<CANReceiver*>(arg)->ingest_loop(); }
+
+    [[noreturn]] void receive_loop()
     {
         twai_message_t message;
         while (true)
         {
-            if (twai_receive(&message, pdMS_TO_TICKS(1000)) == ESP_OK)
+            if (twai_receive(&message, portMAX_DELAY) != ESP_OK) continue;
+            const uint64_t now_ms = FlightData::monotonic_ms();
+            do
             {
-                handle_message(message);
+                push_message(message, now_ms);
             }
+            while (twai_receive(&message, 0) == ESP_OK);
+            xTaskNotifyGive(ingest_handle);
         }
     }
 
-    void handle_message(const twai_message_t& msg) const
+    [[noreturn]] void ingest_loop()
     {
-        if (!(msg.flags & TWAI_MSG_FLAG_EXTD))
+        uint64_t last_flush_ms = 0;
+        while (true)
         {
-            switch (msg.identifier)
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            queue.drain(ingest);
+            if (trace)
             {
-            case 315: flight_data.update_float("ias", CANDecoder::decode_float(msg.data)); break;
-            case 316: flight_data.update_float("tas", CANDecoder::decode_float(msg.data)); break;
-            case 321: flight_data.update_float("heading", CANDecoder::decode_float(msg.data)); break;
-            case 322: flight_data.update_float("alt", CANDecoder::decode_float(msg.data)); break;
-            case 1519: flight_data.update_float("alt_corr", CANDecoder::decode_float(msg.data)); break;
-            case 333: flight_data.update_float("wind_speed", CANDecoder::decode_float(msg.data)); break;
-            case 334: flight_data.update_float("wind_direction", CANDecoder::decode_float(msg.data)); break;
-            case 340: flight_data.update_int("flap", CANDecoder::decode_flap_idx(msg.data)); break;
-            case 1039: flight_data.update_float("gps_ground_speed", CANDecoder::decode_float(msg.data)); break;
-            case 1040: flight_data.update_float("gps_true_track", CANDecoder::decode_float(msg.data)); break;
-            case 1515: flight_data.update_uint16("dry_and_ballast_mass", CANDecoder::decode_u16(msg.data)); break;
-            case 1506: flight_data.update_uint16("enl", CANDecoder::decode_u16(msg.data)); break;
-            default: break;
+                // Bounds what a power cut loses to about a second of trace.
+                const uint64_t now_ms = FlightData::monotonic_ms();
+                if (now_ms - last_flush_ms >= 1000)
+                {
+                    trace->flush();
+                    last_flush_ms = now_ms;
+                }
             }
         }
     }
+
+    void push_message(const twai_message_t& msg, uint64_t now_ms)
+    {
+        uint32_t id = msg.identifier;
+        if (msg.flags & TWAI_MSG_FLAG_EXTD) id |= CanIngest::kExtendedFlag;
+        const uint8_t dlc = (msg.flags & TWAI_MSG_FLAG_RTR) ? 0 : msg.data_length_code;
+        queue.push(id, dlc, msg.data, now_ms);
+        rx_bits.store(rx_bits.load(std::memory_order_relaxed) +
+                          CanBusHealth::frame_bits(dlc, msg.flags & TWAI_MSG_FLAG_EXTD),
+                      std::memory_order_relaxed);
+    }
 };
 
-static CANReceiver receiver(g_flight_state);
+// Alert-driven TWAI health monitor. Sleeps in twai_read_alerts(), runs the
+// bus-off recovery sequence (initiate recovery, restart once the controller
+// reports recovered) and refreshes CanBusHealth once a second from
+// twai_get_status_info(), so recovery time is measured rather than guessed.
+class TwaiBusMonitor
+{
+public:
+    static constexpr uint32_t kAlerts = TWAI_ALERT_ERR_ACTIVE | TWAI_ALERT_ABOVE_ERR_WARN | TWAI_ALERT_ERR_PASS |
+        TWAI_ALERT_BUS_ERROR | TWAI_ALERT_BUS_OFF | TWAI_ALERT_RECOVERY_IN_PROGRESS | TWAI_ALERT_BUS_RECOVERED |
+        TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_RX_FIFO_OVERRUN;
+    static constexpr uint32_t kBitrate = 500000;
+    // Re-issue recovery (or the restart) if nothing happened for this long.
+    static constexpr uint32_t kRecoveryRetryMs = 5000;
+
+    explicit TwaiBusMonitor(const CANReceiver& receiver) : receiver(receiver) {}
+
+    void start()
+    {
+        xTaskCreatePinnedToCore(monitor_task, "can_monitor_task", 3072, this, 6, nullptr, 0);
+    }
+
+    CanBusHealth health() const { return published.load(); }
+
+private:
+    const CANReceiver& receiver;
+    Seqlock<CanBusHealth> published;
+    CanBusHealth h;
+    uint64_t bus_off_at_ms = 0; // 0 = not in bus-off
+    uint64_t last_attempt_ms = 0;
+
+    static void monitor_task(void* arg) { static_cast<TwaiBusMonitor*>(arg)->run(); }
+
+    [[noreturn]] void run()
+    {
+        uint64_t last_status_ms = FlightData::monotonic_ms();
+        uint32_t last_bits = receiver.received_bits();
+        while (true)
+        {
+            uint32_t alerts = 0;
+            const bool got_alerts = twai_read_alerts(&alerts, pdMS_TO_TICKS(250)) == ESP_OK;
+            const uint64_t now_ms = FlightData::monotonic_ms();
+            if (got_alerts) handle_alerts(alerts, now_ms);
+
+            if (bus_off_at_ms != 0 && now_ms - last_attempt_ms >= kRecoveryRetryMs) retry_recovery(now_ms);
+
+            if (now_ms - last_status_ms >= 1000)
+            {
+                const uint32_t bits = receiver.received_bits();
+                const uint64_t elapsed_ms = now_ms - last_status_ms;
+                h.rx_load_permille = static_cast<uint16_t>(
+                    std::min<uint64_t>(1000, uint64_t{bits - last_bits} * 1000000ULL / (uint64_t{kBitrate} * elapsed_ms)));
+                last_bits = bits;
+                last_status_ms = now_ms;
+                refresh_status();
+                published.store(h);
+            }
+            else if (got_alerts)
+            {
+                published.store(h);
+            }
+        }
+    }
+
+    void handle_alerts(uint32_t alerts, uint64_t now_ms)
+    {
+        if (alerts & TWAI_ALERT_ERR_PASS) ++h.error_passive_events;
+
+        if (alerts & TWAI_ALERT_BUS_OFF)
+        {
+            ++h.bus_off_events;
+            h.state = CanBusHealth::State::BusOff;
+            bus_off_at_ms = now_ms;
+            last_attempt_ms = now_ms;
+            ESP_LOGW(TAG, "TWAI bus-off, starting recovery");
+            if (twai_initiate_recovery() == ESP_OK) h.state = CanBusHealth::State::Recovering;
+        }
+        if (alerts & TWAI_ALERT_BUS_RECOVERED) restart(now_ms);
+    }
+
+    // Recovery leaves the driver stopped; start it again and book the latency.
+    void restart(uint64_t now_ms)
+    {
+        if (twai_start() != ESP_OK) return;
+        if (bus_off_at_ms != 0)
+        {
+            h.last_recovery_ms = static_cast<uint32_t>(now_ms - bus_off_at_ms);
+            h.max_recovery_ms = std::max(h.max_recovery_ms, h.last_recovery_ms);
+            ++h.recoveries;
+            ESP_LOGI(TAG, "TWAI recovered in %u ms", static_cast<unsigned>(h.last_recovery_ms));
+        }
+        bus_off_at_ms = 0;
+        h.state = CanBusHealth::State::Running;
+    }
+
+    // Covers a missed BUS_RECOVERED alert or a recovery request that was
+    // refused while the controller was still counting down.
+    void retry_recovery(uint64_t now_ms)
+    {
+        last_attempt_ms = now_ms;
+        twai_status_info_t status;
+        if (twai_get_status_info(&status) != ESP_OK) return;
+        if (status.state == TWAI_STATE_BUS_OFF)
+            twai_initiate_recovery();
+        else if (status.state == TWAI_STATE_STOPPED)
+            restart(now_ms);
+    }
+
+    void refresh_status()
+    {
+        twai_status_info_t status;
+        if (twai_get_status_info(&status) != ESP_OK) return;
+        h.tx_error_counter = status.tx_error_counter;
+        h.rx_error_counter = status.rx_error_counter;
+        h.bus_errors = status.bus_error_count;
+        h.arbitration_lost = status.arb_lost_count;
+        h.rx_missed = status.rx_missed_count;
+        h.rx_overrun = status.rx_overrun_count;
+
+        switch (status.state)
+        {
+        case TWAI_STATE_BUS_OFF: h.state = CanBusHealth::State::BusOff; break;
+        case TWAI_STATE_RECOVERING: h.state = CanBusHealth::State::Recovering; break;
+        case TWAI_STATE_STOPPED: h.state = CanBusHealth::State::Unknown; break;
+        case TWAI_STATE_RUNNING:
+        {
+            const uint32_t worst = std::max(h.tx_error_counter, h.rx_error_counter);
+            if (worst >= 128) h.state = CanBusHealth::State::ErrorPassive;
+            else if (worst >= 96) h.state = CanBusHealth::State::Warning;
+            else h.state = CanBusHealth::State::Running;
+            break;
+        }
+        default: break;
+        }
+    }
+};
+
+static CANReceiver receiver(g_can_ingest);
+static TwaiBusMonitor bus_monitor(receiver);
+
+#ifdef ENABLE_CAN_TRACE
+// Half of the SPIFFS partition, so polar files still fit next to it.
+static constexpr uint32_t kTraceMaxRecords = (512 * 1024) / sizeof(CanTraceRecord);
+static CanTraceWriter s_can_trace;
+#endif
 
 static void configure_task_wdt_for_ui(void)
 {
@@ -175,8 +400,29 @@ static void configure_task_wdt_for_ui(void)
     while (true)
     {
 #ifndef ENABLE_DIAGNOSTICS
-        print_flight_data(*data);
+        print_flight_data(data->snapshot());
 #endif
+        print_can_stats();
+        print_flight_trends();
+        const CANReceiver::Queue::Counters qc = receiver.queue_counters();
+        printf("RX queue: pushed=%u, overruns=%u, recovered=%u, superseded=%u\n",
+               qc.pushed, qc.overruns, qc.recovered, qc.superseded);
+        twai_status_info_t status;
+        if (twai_get_status_info(&status) == ESP_OK)
+        {
+            printf("TWAI: rx queued=%lu, rx missed=%lu, rx overrun=%lu\n",
+                   static_cast<unsigned long>(status.msgs_to_rx),
+                   static_cast<unsigned long>(status.rx_missed_count),
+                   static_cast<unsigned long>(status.rx_overrun_count));
+        }
+        const CanBusHealth h = bus_monitor.health();
+        printf("CAN bus: %s, tec=%lu, rec=%lu, bus errors=%lu, arb lost=%lu, load=%u.%u%%, "
+               "bus-off=%lu, recoveries=%lu (last %lu ms, max %lu ms)\n",
+               CanBusHealth::state_name(h.state), static_cast<unsigned long>(h.tx_error_counter),
+               static_cast<unsigned long>(h.rx_error_counter), static_cast<unsigned long>(h.bus_errors),
+               static_cast<unsigned long>(h.arbitration_lost), h.rx_load_permille / 10, h.rx_load_permille % 10,
+               static_cast<unsigned long>(h.bus_off_events), static_cast<unsigned long>(h.recoveries),
+               static_cast<unsigned long>(h.last_recovery_ms), static_cast<unsigned long>(h.max_recovery_ms));
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
@@ -193,6 +439,9 @@ extern "C" void app_main(void)
     }
     ESP_ERROR_CHECK(err);
 
+    if (units::load_persisted())
+        ESP_LOGI(TAG, "Display units: %s, %s", units::speed().label, units::altitude().label);
+
     vTaskDelay(pdMS_TO_TICKS(2000));
 
     esp_vfs_spiffs_conf_t conf = {
@@ -209,8 +458,10 @@ extern "C" void app_main(void)
     }
     else
     {
+        const int64_t polar_t0 = esp_timer_get_time();
         if (flaputils::load_persisted_data())
-            ESP_LOGI(TAG, "Persisted polar data loaded successfully");
+            ESP_LOGI(TAG, "Persisted polar %s loaded in %lld us", flaputils::get_polar().c_str(),
+                     static_cast<long long>(esp_timer_get_time() - polar_t0));
         else
         {
             std::string first_polar = flaputils::find_first_polar_path();
@@ -223,6 +474,7 @@ extern "C" void app_main(void)
                 }
             }
         }
+        polar_loader::start();
     }
 
     ble_ota_init();
@@ -230,11 +482,26 @@ extern "C" void app_main(void)
     twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(static_cast<gpio_num_t>(TWAI_TX_GPIO),
         static_cast<gpio_num_t>(TWAI_RX_GPIO), TWAI_MODE_NORMAL);
     twai_timing_config_t t_config = TWAI_TIMING_CONFIG_500KBITS();
-    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    twai_filter_config_t f_config = {
+        .acceptance_code = can_acceptance::kTwai.code,
+        .acceptance_mask = can_acceptance::kTwai.mask,
+        .single_filter = can_acceptance::kTwai.single_filter,
+    };
+    g_config.alerts_enabled = TwaiBusMonitor::kAlerts;
 
     if (twai_driver_install(&g_config, &t_config, &f_config) == ESP_OK && twai_start() == ESP_OK)
     {
+#ifdef ENABLE_CAN_TRACE
+        if (s_can_trace.open("/spiffs/can_trace.fct", kTraceMaxRecords))
+            receiver.record_to(s_can_trace);
+        else
+            ESP_LOGW(TAG, "Could not open /spiffs/can_trace.fct for recording");
+#endif
+        g_can_ingest.set_history(&g_flight_history);
+        g_can_ingest.set_derived(&g_derived);
+        g_flight_state.set_change_listener(ui_flight_data_changed);
         receiver.start();
+        bus_monitor.start();
         // xTaskCreate(print_task, "print_task", 4096, &g_flight_state, 2, nullptr);
         ui_init();
         set_label1(APP_NAME);
@@ -262,6 +529,14 @@ struct SimulatorConfig
     int cycle_seconds = 8;
     int splash_ms = 1500;
     std::string can_iface = "can0";
+    std::size_t can_batch = SocketCanReceiver::kDefaultBatch;
+    std::string replay_path;   // replay this trace instead of reading can_iface
+    double replay_speed = 1.0; // CanTraceReplay::kAsFastAsPossible for "max"
+    bool replay_loop = false;
+    uint32_t replay_start_ms = 0;
+    std::string import_in;     // convert this candump/ASC log ...
+    std::string import_out;    // ... to this trace and exit
+    std::string record_path;   // record ingested frames to this trace
 };
 
 static std::atomic<bool> g_running{true};
@@ -269,6 +544,22 @@ static void handle_signal(int) { g_running = false; }
 
 static int parse_int_arg(const char* value, int fallback) { return value ? std::atoi(value) : fallback; }
 
+// "90", "12:30" or "2:05:00" -> milliseconds.
+static uint32_t parse_time_ms(const char* value)
+{
+    double seconds = 0;
+    for (const char* p = value; *p;)
+    {
+        char* end;
+        const double part = std::strtod(p, &end);
+        if (end == p) break;
+        seconds = seconds * 60.0 + part;
+        p = (*end == ':') ? end + 1 : end;
+        if (*end != ':') break;
+    }
+    return static_cast<uint32_t>(std::max(0.0, seconds) * 1000.0);
+}
+
 static SimulatorConfig parse_args(int argc, char** argv)
 {
     SimulatorConfig cfg;
@@ -282,11 +573,34 @@ static SimulatorConfig parse_args(int argc, char** argv)
             cfg.cycle_seconds = std::max(1, parse_int_arg(argv[++i], cfg.cycle_seconds));
         else if (std::strcmp(argv[i], "--can-iface") == 0 && i + 1 < argc)
             cfg.can_iface = argv[++i];
+        else if (std::strcmp(argv[i], "--can-batch") == 0 && i + 1 < argc)
+            cfg.can_batch = static_cast<std::size_t>(std::clamp(parse_int_arg(argv[++i], 64), 1, 1024));
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            cfg.replay_path = argv[++i];
+        else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            const char* v = argv[++i];
+            cfg.replay_speed = std::strcmp(v, "max") == 0 ? CanTraceReplay::kAsFastAsPossible
+                                                          : std::max(0.0, std::atof(v));
+        }
+        else if (std::strcmp(argv[i], "--loop") == 0)
+            cfg.replay_loop = true;
+        else if (std::strcmp(argv[i], "--start") == 0 && i + 1 < argc)
+            cfg.replay_start_ms = parse_time_ms(argv[++i]);
+        else if (std::strcmp(argv[i], "--import") == 0 && i + 2 < argc)
+        {
+            cfg.import_in = argv[++i];
+            cfg.import_out = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            cfg.record_path = argv[++i];
         else if (std::strcmp(argv[i], "--no-splash") == 0)
             cfg.splash_ms = 0;
         else if (std::strcmp(argv[i], "--help") == 0)
         {
-            std::printf("Usage: %s [--screen 1..7] [--auto-cycle] [--cycle-seconds N] [--can-iface can0] [--no-splash]\n", argv[0]);
+            std::printf("Usage: %s [--screen 1..7] [--auto-cycle] [--cycle-seconds N] [--can-iface can0] [--can-batch N]\n"
+                        "          [--replay trace.fct [--speed x|max] [--start [h:]mm:ss] [--loop]] [--record trace.fct]\n"
+                        "          [--import log.txt|log.asc trace.fct] [--no-splash]\n", argv[0]);
             std::exit(0);
         }
     }
@@ -324,85 +638,47 @@ static void load_screen(int screen, lv_screen_load_anim_t anim)
     ui_platform_unlock();
 }
 
-static int open_can_socket(const std::string& iface)
+static void can_receiver_task(SocketCanReceiver* receiver)
 {
-    const int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
-    if (fd < 0) return -1;
-
-    ifreq ifr {};
-    std::snprintf(ifr.ifr_name, IFNAMSIZ, "%s", iface.c_str());
-    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) { close(fd); return -1; }
-
-    sockaddr_can addr {};
-    addr.can_family = AF_CAN;
-    addr.can_ifindex = ifr.ifr_ifindex;
-
-    timeval timeout { .tv_sec = 1, .tv_usec = 0 };
-    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-
-    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { close(fd); return -1; }
-    return fd;
-}
-
-static void can_receiver_task(std::string iface)
-{
-    const int fd = open_can_socket(iface);
-    if (fd < 0) { g_running = false; return; }
-
     while (g_running.load())
     {
-        can_frame frame {};
-        const ssize_t nread = read(fd, &frame, sizeof(frame));
-        if (nread < 0) { if (errno == EAGAIN || errno == EWOULDBLOCK) continue; break; }
-        if (nread != sizeof(frame) || (frame.can_id & CAN_EFF_FLAG)) continue;
-
-        std::lock_guard lock(g_flight_state.mtx);
-        switch (frame.can_id)
-        {
-        case 315:
-            g_flight_state.ias = CANDecoder::decode_float(frame.data);
-            g_flight_state.last_relevant_rx_ms = FlightData::monotonic_ms();
-            break;
-        case 316: g_flight_state.tas = CANDecoder::decode_float(frame.data); break;
-        case 321: g_flight_state.heading = CANDecoder::decode_float(frame.data); break;
-        case 322: g_flight_state.alt = CANDecoder::decode_float(frame.data); break;
-        case 1519: g_flight_state.alt_corr = CANDecoder::decode_float(frame.data); break;
-        case 333: g_flight_state.wind_speed = CANDecoder::decode_float(frame.data); break;
-        case 334: g_flight_state.wind_direction = CANDecoder::decode_float(frame.data); break;
-        case 340:
-            g_flight_state.flapIdx = CANDecoder::decode_flap_idx(frame.data);
-            g_flight_state.last_relevant_rx_ms = FlightData::monotonic_ms();
-            break;
-        case 354: g_flight_state.vario = CANDecoder::decode_float(frame.data); break;
-        case 1039:
-            g_flight_state.gps_ground_speed = CANDecoder::decode_float(frame.data);
-            g_flight_state.last_relevant_rx_ms = FlightData::monotonic_ms();
-            break;
-        case 1040: g_flight_state.gps_true_track = CANDecoder::decode_float(frame.data); break;
-        case 1515: g_flight_state.dry_and_ballast_mass = CANDecoder::decode_u16(frame.data); break;
-        case 1506: g_flight_state.enl = CANDecoder::decode_u16(frame.data); break;
-        default: break;
-        }
+        if (receiver->receive(g_can_ingest) < 0) break;
     }
-    close(fd);
     g_running = false;
 }
 
+static void can_replay_task(CanTraceReplay* replay, CanTraceReplay::Options options)
+{
+    const CanTraceReplay::Result r = replay->run(g_can_ingest, g_running, options);
+    std::printf("replay: %llu frames, %.1f s of trace in %.2f s\n",
+                static_cast<unsigned long long>(r.frames), r.trace_seconds, r.wall_seconds);
+}
+
 static void pump_ui_for(std::chrono::milliseconds duration)
 {
     const auto until = std::chrono::steady_clock::now() + duration;
     while (g_running.load() && std::chrono::steady_clock::now() < until)
     {
         const uint32_t sleep_ms = lv_timer_handler();
-        std::this_thread::sleep_for(std::chrono::milliseconds(std::clamp<uint32_t>(sleep_ms, 1, 10)));
+        ui_platform_wait(std::clamp<uint32_t>(sleep_ms, 1, 100));
     }
 }
 
-static void print_task_native(FlightData* data)
+static void print_task_native(FlightData* data, const SocketCanReceiver* receiver)
 {
     while (g_running.load())
     {
-        print_flight_data(*data);
+        print_flight_data(data->snapshot());
+        print_can_stats();
+        print_flight_trends();
+        if (receiver)
+        {
+            const SocketCanReceiver::FilterStats fs = receiver->filter_stats();
+            std::printf("SocketCAN: bus=%llu, delivered=%llu, dropped by filter=%llu\n",
+                        static_cast<unsigned long long>(fs.bus_frames),
+                        static_cast<unsigned long long>(fs.delivered),
+                        static_cast<unsigned long long>(fs.dropped));
+        }
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 }
@@ -413,7 +689,24 @@ int main(int argc, char** argv)
     std::signal(SIGTERM, handle_signal);
     const SimulatorConfig cfg = parse_args(argc, argv);
 
-    if (!flaputils::load_persisted_data())
+    if (!cfg.import_in.empty())
+    {
+        const can_log_import::Result r = can_log_import::import(cfg.import_in.c_str(), cfg.import_out.c_str());
+        std::printf("import: %llu lines, %llu frames, %llu skipped, %.0f s, %u index entries\n",
+                    static_cast<unsigned long long>(r.lines), static_cast<unsigned long long>(r.frames),
+                    static_cast<unsigned long long>(r.skipped), r.duration_s, r.index_entries);
+        return r.ok ? 0 : 1;
+    }
+
+    units::load_persisted();
+
+    const auto polar_t0 = std::chrono::steady_clock::now();
+    if (flaputils::load_persisted_data())
+    {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - polar_t0);
+        std::printf("polar: %s loaded in %lld us\n", flaputils::get_polar().c_str(), static_cast<long long>(us.count()));
+    }
+    else
     {
         std::string first_polar = flaputils::find_first_polar_path();
         if (!first_polar.empty())
@@ -429,8 +722,51 @@ int main(int argc, char** argv)
         }
     }
 
-    std::thread can_thread(can_receiver_task, cfg.can_iface);
-    std::thread print_thread(print_task_native, &g_flight_state);
+    CanTraceWriter recorder;
+    if (!cfg.record_path.empty())
+    {
+        if (!recorder.open(cfg.record_path.c_str()))
+        {
+            std::fprintf(stderr, "Cannot record to %s\n", cfg.record_path.c_str());
+            return 1;
+        }
+        g_can_ingest.set_recorder(&recorder);
+    }
+
+    SocketCanReceiver can_receiver(cfg.can_batch);
+    CanTraceReplay replay;
+    g_can_ingest.set_history(&g_flight_history);
+    g_can_ingest.set_derived(&g_derived);
+    g_flight_state.set_change_listener(ui_flight_data_changed);
+    std::thread can_thread;
+    if (!cfg.replay_path.empty())
+    {
+        if (!replay.open(cfg.replay_path))
+        {
+            std::fprintf(stderr, "Cannot replay %s\n", cfg.replay_path.c_str());
+            return 1;
+        }
+        CanTraceReplay::Options options;
+        options.speed = cfg.replay_speed;
+        options.loop = cfg.replay_loop;
+        options.batch = cfg.can_batch;
+        options.start_ms = cfg.replay_start_ms;
+        can_thread = std::thread(can_replay_task, &replay, options);
+    }
+    else
+    {
+        // Opened here, not on the CAN thread: open() sets what the print
+        // thread's filter_stats() reads.
+        if (!can_receiver.open(cfg.can_iface))
+        {
+            std::fprintf(stderr, "Cannot open CAN interface %s\n", cfg.can_iface.c_str());
+            return 1;
+        }
+        can_thread = std::thread(can_receiver_task, &can_receiver);
+    }
+    std::thread print_thread(print_task_native, &g_flight_state, cfg.replay_path.empty() ? &can_receiver : nullptr);
+    // After the last early return: a running loader must be stopped.
+    polar_loader::start();
 
     ui_init();
     set_label1(APP_NAME);
@@ -455,23 +791,25 @@ int main(int argc, char** argv)
             load_screen(current_screen, LV_SCR_LOAD_ANIM_FADE_ON);
             next_cycle = std::chrono::steady_clock::now() + std::chrono::seconds(cfg.cycle_seconds);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(std::clamp<uint32_t>(sleep_ms, 1, 10)));
+        ui_platform_wait(std::clamp<uint32_t>(sleep_ms, 1, 100));
     }
     can_thread.join();
     print_thread.join();
+    polar_loader::stop();
+    recorder.close();
     return 0;
 }
 
 #endif // NATIVE_TEST_BUILD
 
-float get_ias_kmh() { return ::get_ias_kmh(g_flight_state); }
-float get_weight_kg() { return ::get_weight_kg(g_flight_state); }
-float get_alt_m() { return ::get_alt_m(g_flight_state); }
-float get_heading() { return ::get_heading(g_flight_state); }
-float get_wind_speed_kmh() { return ::get_wind_speed_kmh(g_flight_state); }
-float get_wind_direction() { return ::get_wind_direction(g_flight_state); }
-float get_gps_ground_speed_kmh() { return ::get_gps_ground_speed_kmh(g_flight_state); }
-float get_gps_true_track() { return ::get_gps_true_track(g_flight_state); }
-flaputils::FlapSymbolResult get_flap_actual() { return ::get_flap_actual(g_flight_state); }
-flaputils::FlapSymbolResult get_flap_target() { return ::get_flap_target(g_flight_state); }
-bool is_stale() { return g_flight_state.is_stale(); }
+FlightSnapshot get_flight_snapshot() { return g_flight_state.snapshot(); }
+SignalMask take_flight_changes(SignalMask signals) { return g_flight_state.take_changes(signals); }
+SignalMask peek_flight_changes(SignalMask signals) { return g_flight_state.peek_changes(signals); }
+void watch_flight_changes(SignalMask signals) { g_flight_state.watch(signals); }
+SignalStats get_signal_stats(FlightSignal signal) { return g_flight_history.stats(signal); }
+
+#ifndef NATIVE_TEST_BUILD
+CanBusHealth get_can_bus_health() { return bus_monitor.health(); }
+#else
+CanBusHealth get_can_bus_health() { return {}; }
+#endif
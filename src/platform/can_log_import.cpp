@@ -0,0 +1,224 @@
+#include "can_log_import.hpp"
+#include "can_ingest.hpp"
+#include "can_trace.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+const char* skip_spaces(const char* p)
+{
+    while (*p == ' ' || *p == '\t') ++p;
+    return p;
+}
+
+// Reads "xx xx xx" (space separated) or "xxxxxx" (packed) hex bytes.
+uint8_t read_bytes(const char* p, bool spaced, uint8_t max, uint8_t* out)
+{
+    uint8_t n = 0;
+    while (n < max)
+    {
+        if (spaced) p = skip_spaces(p);
+        const int hi = hex_nibble(p[0]);
+        const int lo = hi < 0 ? -1 : hex_nibble(p[1]);
+        if (lo < 0) break;
+        out[n++] = static_cast<uint8_t>((hi << 4) | lo);
+        p += 2;
+    }
+    return n;
+}
+
+bool starts_with(const char* p, const char* prefix)
+{
+    return std::strncmp(p, prefix, std::strlen(prefix)) == 0;
+}
+} // namespace
+
+namespace can_log_import
+{
+    // "(1740476040.000000) can0 154#000000005E000000"
+    // "(1740476040.000000) can0 123#R"
+    // " (1740476040.000000)  can0  13B   [8]  00 00 00 00 42 9E 00 00"
+    bool parse_candump_line(const char* line, Frame& out)
+    {
+        const char* p = skip_spaces(line);
+        if (*p != '(') return false;
+        char* end;
+        out.time_s = std::strtod(p + 1, &end);
+        if (end == p + 1 || *end != ')') return false;
+
+        p = skip_spaces(end + 1);
+        while (*p && *p != ' ' && *p != '\t') ++p; // interface
+        p = skip_spaces(p);
+
+        const char* id_start = p;
+        const unsigned long id = std::strtoul(id_start, &end, 16);
+        if (end == id_start) return false;
+        out.id = static_cast<uint32_t>(id);
+        if (end - id_start > 3) out.id |= CanIngest::kExtendedFlag;
+        std::memset(out.data, 0, sizeof(out.data));
+
+        if (*end == '#')
+        {
+            p = end + 1;
+            if (*p == '#') return false; // CAN FD
+            if (*p == 'R' || *p == 'r')
+            {
+                out.dlc = 0;
+                return true;
+            }
+            out.dlc = read_bytes(p, false, 8, out.data);
+            return true;
+        }
+
+        p = skip_spaces(end);
+        if (*p != '[') return false;
+        const unsigned long dlc = std::strtoul(p + 1, &end, 10);
+        if (*end != ']' || dlc > 8) return false;
+        p = skip_spaces(end + 1);
+        if (starts_with(p, "remote")) { out.dlc = 0; return true; }
+        out.dlc = read_bytes(p, true, static_cast<uint8_t>(dlc), out.data);
+        return out.dlc == dlc;
+    }
+
+    // "   1.234567 1  13B             Rx   d 8 00 00 00 00 42 9E 00 00  Length = ..."
+    bool parse_asc_line(const char* line, AscState& state, Frame& out)
+    {
+        const char* p = skip_spaces(line);
+        if (starts_with(p, "base "))
+        {
+            state.hex_ids = std::strstr(p, " hex") != nullptr;
+            state.relative_time = std::strstr(p, "relative") != nullptr;
+            return false;
+        }
+        if (!std::isdigit(static_cast<unsigned char>(*p))) return false;
+
+        char* end;
+        const double t = std::strtod(p, &end);
+        if (end == p) return false;
+        p = skip_spaces(end);
+
+        // Channel number; events such as "ErrorFrame" or "CANFD" lines fail here.
+        if (!std::isdigit(static_cast<unsigned char>(*p))) return false;
+        std::strtoul(p, &end, 10);
+        if (*end != ' ' && *end != '\t') return false;
+        p = skip_spaces(end);
+
+        const unsigned long id = std::strtoul(p, &end, state.hex_ids ? 16 : 10);
+        if (end == p) return false;
+        out.id = static_cast<uint32_t>(id);
+        if (*end == 'x' || *end == 'X')
+        {
+            out.id |= CanIngest::kExtendedFlag;
+            ++end;
+        }
+        if (*end != ' ' && *end != '\t') return false;
+        p = skip_spaces(end);
+
+        if (!starts_with(p, "Rx") && !starts_with(p, "Tx")) return false;
+        p = skip_spaces(p + 2);
+
+        const char kind = *p;
+        if (kind != 'd' && kind != 'r') return false;
+        p = skip_spaces(p + 1);
+
+        const unsigned long dlc = std::strtoul(p, &end, 16);
+        if (end == p || dlc > 8) return false;
+        std::memset(out.data, 0, sizeof(out.data));
+        if (kind == 'r')
+            out.dlc = 0;
+        else if ((out.dlc = read_bytes(end, true, static_cast<uint8_t>(dlc), out.data)) != dlc)
+            return false;
+
+        out.time_s = state.relative_time ? state.last_time_s + t : t;
+        state.last_time_s = out.time_s;
+        return true;
+    }
+
+    static Format detect_format(const char* path, std::FILE* f)
+    {
+        const std::size_t len = std::strlen(path);
+        if (len >= 4 && (std::strcmp(path + len - 4, ".asc") == 0 || std::strcmp(path + len - 4, ".ASC") == 0))
+            return Format::Asc;
+
+        char line[256];
+        Format format = Format::Candump;
+        while (std::fgets(line, sizeof(line), f))
+        {
+            const char* p = skip_spaces(line);
+            if (*p == '\0' || *p == '\n' || *p == '\r') continue;
+            if (starts_with(p, "date ") || starts_with(p, "base ")) format = Format::Asc;
+            break;
+        }
+        std::rewind(f);
+        return format;
+    }
+
+    Result import(const char* in_path, const char* out_path, Format format, uint32_t index_interval_ms)
+    {
+        Result result{};
+        std::FILE* in = std::fopen(in_path, "r");
+        if (!in)
+        {
+            std::fprintf(stderr, "import: cannot open %s\n", in_path);
+            return result;
+        }
+        if (format == Format::Auto) format = detect_format(in_path, in);
+
+        CanTraceWriter writer;
+        if (!writer.open(out_path))
+        {
+            std::fprintf(stderr, "import: cannot create %s\n", out_path);
+            std::fclose(in);
+            return result;
+        }
+        if (index_interval_ms != 0) writer.enable_index(index_interval_ms);
+
+        // Lines longer than the buffer (ASC comments) are consumed in pieces;
+        // only a piece that starts a line is parsed.
+        char line[512];
+        bool at_line_start = true;
+        AscState asc;
+        Frame frame;
+        double first_s = 0;
+        double last_s = 0;
+        while (std::fgets(line, sizeof(line), in))
+        {
+            const bool starts_line = at_line_start;
+            at_line_start = std::strchr(line, '\n') != nullptr;
+            if (!starts_line) continue;
+            ++result.lines;
+
+            const bool parsed = format == Format::Asc ? parse_asc_line(line, asc, frame)
+                                                      : parse_candump_line(line, frame);
+            if (!parsed)
+            {
+                ++result.skipped;
+                continue;
+            }
+            if (result.frames == 0) first_s = frame.time_s;
+            last_s = frame.time_s;
+            writer.write(frame.id, frame.dlc, frame.data, static_cast<uint64_t>(std::llround(frame.time_s * 1000.0)));
+            ++result.frames;
+        }
+        std::fclose(in);
+
+        result.ok = writer.dropped() == 0;
+        result.index_entries = writer.index_entries();
+        writer.close();
+        result.duration_s = last_s - first_s;
+        return result;
+    }
+} // namespace can_log_import
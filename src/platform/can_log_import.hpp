@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+// Streaming converters from text CAN logs to the binary trace format
+// (src/can_trace.hpp) used by the simulator replay. Input is read one line
+// at a time, so multi-hour logs convert in constant memory apart from the
+// time index (8 bytes per interval).
+namespace can_log_import
+{
+    enum class Format
+    {
+        Auto,    // .asc extension or an ASC header means ASC, else candump
+        Candump, // candump -l "(ts) can0 123#..." and candump -ta "(ts) can0 123 [8] .."
+        Asc,     // Vector ASC, hex or dec IDs, absolute or relative timestamps
+    };
+
+    struct Frame
+    {
+        double time_s;
+        uint32_t id; // CanIngest::kExtendedFlag set for 29-bit frames
+        uint8_t dlc;
+        uint8_t data[8];
+    };
+
+    struct Result
+    {
+        bool ok;
+        uint64_t lines;
+        uint64_t frames;
+        uint64_t skipped; // comments, events, CAN FD and lines we could not parse
+        uint32_t index_entries;
+        double duration_s;
+    };
+
+    Result import(const char* in_path, const char* out_path, Format format = Format::Auto,
+                  uint32_t index_interval_ms = 1000);
+
+    // Line parsers, exposed for tests.
+    bool parse_candump_line(const char* line, Frame& out);
+
+    struct AscState
+    {
+        bool hex_ids = true;
+        bool relative_time = false;
+        double last_time_s = 0;
+    };
+
+    // Header lines ("base hex timestamps absolute") update state and return false.
+    bool parse_asc_line(const char* line, AscState& state, Frame& out);
+} // namespace can_log_import
@@ -0,0 +1,73 @@
+#include "can_replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Upper bound for one sleep, so a stop request is noticed during long gaps.
+constexpr auto kMaxSleep = std::chrono::milliseconds(100);
+}
+
+bool CanTraceReplay::open(const std::string& path)
+{
+    return reader_.open(path.c_str());
+}
+
+CanTraceReplay::Result CanTraceReplay::run(CanIngest& ingest, const std::atomic<bool>& running, const Options& options)
+{
+    const bool paced = options.speed > 0.0;
+    const std::size_t batch = std::max<std::size_t>(1, options.batch);
+    Result result{};
+    const auto started = Clock::now();
+
+    do
+    {
+        if (!reader_.seek(options.start_ms)) break;
+
+        // Trace time start_ms + t maps to base_ms + t / speed on the FlightData
+        // clock, and to pass_start + t / speed on the wall clock when pacing.
+        const uint64_t base_ms = FlightData::monotonic_ms();
+        const auto pass_start = Clock::now();
+        const double scale = paced ? 1.0 / options.speed : 1.0;
+
+        CanTraceRecord rec;
+        std::size_t pending = 0;
+        uint32_t last_ts = options.start_ms;
+        while (running.load(std::memory_order_relaxed) && reader_.next(rec))
+        {
+            const double offset_ms = (rec.timestamp_ms - options.start_ms) * scale;
+            if (paced)
+            {
+                const auto due = pass_start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(offset_ms));
+                if (due > Clock::now())
+                {
+                    // Frames due so far become visible before we wait.
+                    ingest.publish();
+                    pending = 0;
+                    while (running.load(std::memory_order_relaxed) && due > Clock::now())
+                        std::this_thread::sleep_until(std::min(due, Clock::now() + kMaxSleep));
+                }
+            }
+
+            ingest.on_frame(rec.id, rec.dlc, rec.data, base_ms + static_cast<uint64_t>(offset_ms));
+            last_ts = rec.timestamp_ms;
+            ++result.frames;
+            if (++pending >= batch)
+            {
+                ingest.publish();
+                pending = 0;
+            }
+        }
+        ingest.publish();
+        result.trace_seconds += (last_ts - options.start_ms) / 1000.0;
+    }
+    while (options.loop && running.load(std::memory_order_relaxed));
+
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    return result;
+}
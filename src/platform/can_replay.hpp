@@ -0,0 +1,45 @@
+#pragma once
+
+#include "can_ingest.hpp"
+#include "can_trace.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Replays a CAN trace (src/can_trace.hpp) straight into CanIngest for the
+// native simulator, with no socket in between.
+//
+// Frame timestamps are derived from the trace, not from the wall clock, so
+// a given trace and speed always produce the same sequence of ingest calls.
+class CanTraceReplay
+{
+public:
+    // speed <= 0 replays as fast as possible.
+    static constexpr double kAsFastAsPossible = 0.0;
+
+    struct Options
+    {
+        double speed = 1.0;     // 1 = real time, 10 = ten times faster
+        bool loop = false;      // start over at the end of the trace
+        std::size_t batch = 64; // frames per publish when running flat out
+        uint32_t start_ms = 0;  // trace time to start (and loop) from
+    };
+
+    struct Result
+    {
+        uint64_t frames;
+        double trace_seconds; // trace time covered
+        double wall_seconds;  // time the replay took
+    };
+
+    bool open(const std::string& path);
+
+    // Blocks until the trace ends (never, with loop) or running turns false.
+    Result run(CanIngest& ingest, const std::atomic<bool>& running, const Options& options);
+
+    uint64_t record_count() const { return reader_.record_count(); }
+
+private:
+    CanTraceReader reader_;
+};
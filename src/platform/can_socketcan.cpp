@@ -0,0 +1,156 @@
+#include "can_socketcan.hpp"
+#include "can_acceptance.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::size_t kControlSize = CMSG_SPACE(sizeof(timespec));
+
+uint64_t timespec_ms(const timespec& ts)
+{
+    return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL;
+}
+}
+
+SocketCanReceiver::SocketCanReceiver(std::size_t batch_size)
+    : batch_size_(std::max<std::size_t>(1, batch_size)),
+      frames_(batch_size_),
+      iov_(batch_size_),
+      msgs_(batch_size_),
+      control_(batch_size_ * kControlSize)
+{
+}
+
+SocketCanReceiver::~SocketCanReceiver()
+{
+    close();
+}
+
+bool SocketCanReceiver::open(const std::string& iface)
+{
+    close();
+
+    const int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) return false;
+
+    ifreq ifr {};
+    std::snprintf(ifr.ifr_name, IFNAMSIZ, "%s", iface.c_str());
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) { ::close(fd); return false; }
+
+    sockaddr_can addr {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+
+    timeval timeout { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+
+    // Exact-match standard data frames for every consumed id.
+    ::can_filter filters[can_acceptance::kIdCount];
+    for (std::size_t i = 0; i < can_acceptance::kIdCount; ++i)
+    {
+        filters[i].can_id = can_acceptance::kIds[i];
+        filters[i].can_mask = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+    }
+    if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters, sizeof(filters)) < 0)
+    {
+        std::fprintf(stderr, "can: CAN_RAW_FILTER failed (%s), receiving all frames\n", std::strerror(errno));
+    }
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { ::close(fd); return false; }
+    fd_ = fd;
+    iface_ = iface;
+    rx_packets_base_ = read_rx_packets();
+    delivered_ = 0;
+    return true;
+}
+
+void SocketCanReceiver::close()
+{
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+int SocketCanReceiver::receive(CanIngest& ingest)
+{
+    if (fd_ < 0) return -1;
+
+    for (std::size_t i = 0; i < batch_size_; ++i)
+    {
+        iov_[i] = {&frames_[i], sizeof(can_frame)};
+        msgs_[i] = {};
+        msgs_[i].msg_hdr.msg_iov = &iov_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+        msgs_[i].msg_hdr.msg_control = &control_[i * kControlSize];
+        msgs_[i].msg_hdr.msg_controllen = kControlSize;
+    }
+
+    // MSG_WAITFORONE: block (up to SO_RCVTIMEO) for the first frame only,
+    // then take whatever else is already queued.
+    const int n = recvmmsg(fd_, msgs_.data(), static_cast<unsigned>(batch_size_), MSG_WAITFORONE, nullptr);
+    if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+
+    // Kernel timestamps are CLOCK_REALTIME; map them onto the monotonic
+    // clock CanIngest uses with one offset per batch.
+    const uint64_t mono_now = FlightData::monotonic_ms();
+    timespec real_ts {};
+    clock_gettime(CLOCK_REALTIME, &real_ts);
+    const int64_t real_to_mono = static_cast<int64_t>(mono_now) - static_cast<int64_t>(timespec_ms(real_ts));
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (msgs_[i].msg_len != sizeof(can_frame)) continue;
+        const can_frame& frame = frames_[i];
+
+        uint64_t ts_ms = mono_now;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msgs_[i].msg_hdr); c; c = CMSG_NXTHDR(&msgs_[i].msg_hdr, c))
+        {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPNS)
+            {
+                timespec kts;
+                std::memcpy(&kts, CMSG_DATA(c), sizeof(kts));
+                ts_ms = static_cast<uint64_t>(static_cast<int64_t>(timespec_ms(kts)) + real_to_mono);
+                break;
+            }
+        }
+
+        const uint8_t dlc = (frame.can_id & CAN_RTR_FLAG) ? 0 : frame.len;
+        ingest.on_frame(frame.can_id & (CAN_EFF_FLAG | CAN_EFF_MASK), dlc, frame.data, ts_ms);
+    }
+    ingest.publish();
+    delivered_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    return n;
+}
+
+uint64_t SocketCanReceiver::read_rx_packets() const
+{
+    const std::string path = "/sys/class/net/" + iface_ + "/statistics/rx_packets";
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return 0;
+    unsigned long long value = 0;
+    if (std::fscanf(f, "%llu", &value) != 1) value = 0;
+    std::fclose(f);
+    return value;
+}
+
+SocketCanReceiver::FilterStats SocketCanReceiver::filter_stats() const
+{
+    const uint64_t delivered = delivered_.load(std::memory_order_relaxed);
+    const uint64_t rx_now = read_rx_packets();
+    const uint64_t bus = rx_now >= rx_packets_base_ ? rx_now - rx_packets_base_ : 0;
+    return {bus, delivered, bus > delivered ? bus - delivered : 0};
+}
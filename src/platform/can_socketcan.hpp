@@ -0,0 +1,61 @@
+#pragma once
+
+#include "can_ingest.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct can_frame;
+struct mmsghdr;
+struct iovec;
+
+// SocketCAN front-end for the native simulator. Each receive() pulls up to
+// batch_size frames with one recvmmsg() call, stamps them with the kernel
+// receive time (SO_TIMESTAMPNS) and applies the whole batch to CanIngest
+// under a single publish. A CAN_RAW_FILTER built from the dispatch table
+// keeps frames the display does not consume in the kernel.
+class SocketCanReceiver
+{
+public:
+    static constexpr std::size_t kDefaultBatch = 64;
+
+    explicit SocketCanReceiver(std::size_t batch_size = kDefaultBatch);
+    ~SocketCanReceiver();
+
+    SocketCanReceiver(const SocketCanReceiver&) = delete;
+    SocketCanReceiver& operator=(const SocketCanReceiver&) = delete;
+
+    bool open(const std::string& iface);
+    void close();
+
+    // Waits up to 1 s for the first frame. Returns the number of frames
+    // handed to ingest (0 on timeout) or -1 on a socket error.
+    int receive(CanIngest& ingest);
+
+    int fd() const { return fd_; }
+
+    struct FilterStats
+    {
+        uint64_t bus_frames; // received by the interface since open()
+        uint64_t delivered;  // passed the kernel filter
+        uint64_t dropped;    // filtered out in the kernel
+    };
+
+    // Safe to call from any thread.
+    FilterStats filter_stats() const;
+
+private:
+    uint64_t read_rx_packets() const;
+
+    int fd_ = -1;
+    std::string iface_;
+    uint64_t rx_packets_base_ = 0;
+    std::atomic<uint64_t> delivered_{0};
+    std::size_t batch_size_;
+    std::vector<can_frame> frames_;
+    std::vector<iovec> iov_;
+    std::vector<mmsghdr> msgs_;
+    std::vector<unsigned char> control_;
+};
@@ -3,6 +3,8 @@
 #include <algorithm>
 
 #ifdef NATIVE_SIMULATOR
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include "drivers/sdl/lv_sdl_keyboard.h"
 #include "drivers/sdl/lv_sdl_mouse.h"
@@ -17,6 +19,10 @@ lv_indev_t* g_mouse = nullptr;
 lv_indev_t* g_mousewheel = nullptr;
 lv_indev_t* g_keyboard = nullptr;
 int g_brightness_percent = 100;
+std::mutex g_wake_mutex;
+std::condition_variable g_wake_cv;
+bool g_wake_pending = false;
+void (*g_wake_handler)() = nullptr;
 }
 
 bool ui_platform_init_display()
@@ -61,6 +67,34 @@ lv_display_t* ui_platform_get_display()
 {
     return g_display;
 }
+
+void ui_platform_wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_wake_mutex);
+        g_wake_pending = true;
+    }
+    g_wake_cv.notify_one();
+}
+
+void ui_platform_set_wake_handler(void (*handler)())
+{
+    std::lock_guard<std::recursive_mutex> lock(g_lvgl_mutex);
+    g_wake_handler = handler;
+}
+
+void ui_platform_wait(uint32_t timeout_ms)
+{
+    bool woken;
+    {
+        std::unique_lock<std::mutex> lock(g_wake_mutex);
+        woken = g_wake_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [] { return g_wake_pending; });
+        g_wake_pending = false;
+    }
+    if (!woken) return;
+    std::lock_guard<std::recursive_mutex> lock(g_lvgl_mutex);
+    if (g_wake_handler) g_wake_handler();
+}
 #else
 #include "bsp/esp32_s3_touch_amoled_1_75.h"
 
@@ -77,6 +111,10 @@ bool ui_platform_init_display()
         }
     };
     cfg.lv_adapter_cfg.task_core_id = 1;
+    // Screens park their timers while no new data arrives and the CAN
+    // ingest wakes the worker (ui_platform_wake()), so let it sleep until
+    // the next LVGL timer instead of polling every 15 ms.
+    cfg.lv_adapter_cfg.task_max_delay_ms = 100;
     return bsp_display_start_with_config(&cfg) != nullptr;
 }
 
@@ -104,4 +142,27 @@ lv_display_t* ui_platform_get_display()
 {
     return lv_display_get_default();
 }
+
+namespace
+{
+void (*g_wake_handler)() = nullptr;
+
+void run_wake_handler(void*)
+{
+    if (g_wake_handler) g_wake_handler();
+}
+}
+
+// esp_lv_adapter_wake() and esp_lv_adapter_set_wake_cb() are not upstream;
+// support/patch_lvgl_adapter.py adds them to the component before the build.
+void ui_platform_wake()
+{
+    esp_lv_adapter_wake();
+}
+
+void ui_platform_set_wake_handler(void (*handler)())
+{
+    g_wake_handler = handler;
+    esp_lv_adapter_set_wake_cb(handler ? run_wake_handler : nullptr, nullptr);
+}
 #endif
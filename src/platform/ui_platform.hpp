@@ -8,3 +8,15 @@ void ui_platform_unlock();
 int ui_platform_get_brightness();
 void ui_platform_set_brightness(int brightness_percent);
 lv_display_t* ui_platform_get_display();
+
+// Wakes the LVGL task early; callable from any thread. The handler set with
+// ui_platform_set_wake_handler() then runs on the LVGL task, lock held,
+// before its next lv_timer_handler() call.
+void ui_platform_wake();
+void ui_platform_set_wake_handler(void (*handler)());
+
+#ifdef NATIVE_SIMULATOR
+// Simulator main loop: sleeps up to timeout_ms or until ui_platform_wake(),
+// then runs the wake handler if it was woken. Returns with the handler done.
+void ui_platform_wait(uint32_t timeout_ms);
+#endif
@@ -0,0 +1,242 @@
+#include "polar_format.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#if __has_include(<cjson/cJSON.h>)
+#include <cjson/cJSON.h>
+#else
+#include "cJSON.h"
+#endif
+
+namespace fpol
+{
+    namespace
+    {
+        // Each distinct string is stored once; flap labels and band symbols
+        // are mostly the same few strings.
+        struct SymbolPool
+        {
+            std::string bytes;
+
+            uint16_t intern(const char* s)
+            {
+                if (!s) return kNoSymbol;
+                const std::size_t len = std::strlen(s);
+                for (std::size_t at = 0; at < bytes.size(); at += std::strlen(bytes.c_str() + at) + 1)
+                    if (std::strcmp(bytes.c_str() + at, s) == 0) return static_cast<uint16_t>(at);
+                const std::size_t at = bytes.size();
+                bytes.append(s, len);
+                bytes.push_back('\0');
+                return static_cast<uint16_t>(at);
+            }
+        };
+
+        struct Band
+        {
+            uint16_t symbol;
+            std::vector<std::array<float, 2>> ranges;
+        };
+
+        bool fail(std::string* error, const char* what)
+        {
+            if (error) *error = what;
+            return false;
+        }
+
+        float number(const cJSON* item, float fallback)
+        {
+            return cJSON_IsNumber(item) ? static_cast<float>(item->valuedouble) : fallback;
+        }
+
+        const char* string(const cJSON* item)
+        {
+            return cJSON_IsString(item) ? item->valuestring : nullptr;
+        }
+
+        std::size_t align4(std::size_t n) { return (n + 3) & ~std::size_t{3}; }
+    } // namespace
+
+    std::vector<uint8_t> from_json(const char* json, const char* name, std::string* error)
+    {
+        cJSON* root = cJSON_Parse(json);
+        if (!root)
+        {
+            fail(error, "JSON does not parse");
+            return {};
+        }
+
+        Header h{};
+        h.magic = kMagic;
+        h.version = kVersion;
+        h.header_size = sizeof(Header);
+        h.lowspeed_flap = -1;
+        h.lowspeed_vmin = -1.0f;
+        h.lowspeed_vmax = -1.0f;
+        // Used when the file has no speedlimits.
+        h.vso = 75.0f;
+        h.vfe = 180.0f;
+        h.vs1 = 90.0f;
+        h.vno = 200.0f;
+        h.vne = 280.0f;
+
+        h.source_size = static_cast<uint32_t>(std::strlen(json));
+        h.source_crc32 = crc32(reinterpret_cast<const uint8_t*>(json), h.source_size);
+
+        SymbolPool pool;
+        h.name = pool.intern(name);
+
+        if (const cJSON* meta = cJSON_GetObjectItem(root, "meta"))
+            h.empty_mass_kg = number(cJSON_GetObjectItem(meta, "empty_mass_kg"), 0.0f);
+
+        std::vector<float> weights;
+        const cJSON* item = nullptr;
+        if (const cJSON* w_arr = cJSON_GetObjectItem(root, "weights"); cJSON_IsArray(w_arr))
+            cJSON_ArrayForEach(item, w_arr) weights.push_back(static_cast<float>(item->valueint));
+
+        std::vector<uint16_t> labels;
+        if (const cJSON* flaps = cJSON_GetObjectItem(root, "flaps"))
+            if (const cJSON* lab_arr = cJSON_GetObjectItem(flaps, "labels"); cJSON_IsArray(lab_arr))
+                cJSON_ArrayForEach(item, lab_arr)
+                    if (const char* s = string(item)) labels.push_back(pool.intern(s));
+
+        std::vector<Band> bands;
+        if (const cJSON* sp_arr = cJSON_GetObjectItem(root, "speedpolar"); cJSON_IsArray(sp_arr))
+        {
+            cJSON_ArrayForEach(item, sp_arr)
+            {
+                const char* wk = string(cJSON_GetObjectItem(item, "wk"));
+                Band b{pool.intern(wk ? wk : ""), {}};
+                const cJSON* pair = nullptr;
+                if (const cJSON* r_arr = cJSON_GetObjectItem(item, "ranges"); cJSON_IsArray(r_arr))
+                    cJSON_ArrayForEach(pair, r_arr)
+                        if (cJSON_IsArray(pair) && cJSON_GetArraySize(pair) >= 2)
+                            b.ranges.push_back({number(cJSON_GetArrayItem(pair, 0), -1.0f),
+                                                number(cJSON_GetArrayItem(pair, 1), -1.0f)});
+                bands.push_back(std::move(b));
+            }
+        }
+
+        if (const cJSON* ls = cJSON_GetObjectItem(root, "lowspeed"))
+        {
+            // Resolved to a flap label now instead of by string on every lookup.
+            if (const char* wk = string(cJSON_GetObjectItem(ls, "wk")))
+            {
+                const uint16_t sym = pool.intern(wk);
+                for (std::size_t i = 0; i < labels.size() && h.lowspeed_flap < 0; ++i)
+                    if (labels[i] == sym) h.lowspeed_flap = static_cast<int16_t>(i);
+            }
+            if (const cJSON* r = cJSON_GetObjectItem(ls, "range"); cJSON_IsArray(r) && cJSON_GetArraySize(r) >= 2)
+            {
+                h.lowspeed_vmin = number(cJSON_GetArrayItem(r, 0), -1.0f);
+                h.lowspeed_vmax = number(cJSON_GetArrayItem(r, 1), -1.0f);
+            }
+        }
+
+        if (const cJSON* sl = cJSON_GetObjectItem(root, "speedlimits"))
+        {
+            h.vso = number(cJSON_GetObjectItem(sl, "vso"), h.vso);
+            h.vfe = number(cJSON_GetObjectItem(sl, "vfe"), h.vfe);
+            h.vs1 = number(cJSON_GetObjectItem(sl, "vs1"), h.vs1);
+            h.vno = number(cJSON_GetObjectItem(sl, "vno"), h.vno);
+            h.vne = number(cJSON_GetObjectItem(sl, "vne"), h.vne);
+        }
+        cJSON_Delete(root);
+
+        if (weights.size() > 0xFFFF || labels.size() > 0xFFFF || bands.size() > 0xFFFF ||
+            pool.bytes.size() >= kNoSymbol)
+        {
+            fail(error, "polar too large for .fpol");
+            return {};
+        }
+        if (pool.bytes.empty()) pool.bytes.push_back('\0');
+
+        h.weight_count = static_cast<uint16_t>(weights.size());
+        h.flap_count = static_cast<uint16_t>(labels.size());
+        h.band_count = static_cast<uint16_t>(bands.size());
+        h.symbol_bytes = static_cast<uint16_t>(pool.bytes.size());
+
+        std::size_t at = sizeof(Header);
+        h.weights_offset = static_cast<uint32_t>(at);
+        at += weights.size() * sizeof(float);
+        h.ranges_offset = static_cast<uint32_t>(at);
+        at += bands.size() * weights.size() * 2 * sizeof(float);
+        h.flap_labels_offset = static_cast<uint32_t>(at);
+        at += labels.size() * sizeof(uint16_t);
+        h.band_symbols_offset = static_cast<uint32_t>(at);
+        at += bands.size() * sizeof(uint16_t);
+        h.band_range_counts_offset = static_cast<uint32_t>(at);
+        at += bands.size() * sizeof(uint16_t);
+        h.symbols_offset = static_cast<uint32_t>(at);
+        at += pool.bytes.size();
+        h.file_size = static_cast<uint32_t>(align4(at));
+
+        std::vector<uint8_t> out(h.file_size, 0);
+        auto put = [&](uint32_t offset, const void* src, std::size_t bytes)
+        {
+            if (bytes) std::memcpy(out.data() + offset, src, bytes);
+        };
+        put(h.weights_offset, weights.data(), weights.size() * sizeof(float));
+        for (std::size_t b = 0; b < bands.size(); ++b)
+        {
+            for (std::size_t w = 0; w < weights.size(); ++w)
+            {
+                // Weights without a range in the JSON read as "none".
+                const std::array<float, 2> r = w < bands[b].ranges.size() ? bands[b].ranges[w]
+                                                                          : std::array<float, 2>{-1.0f, -1.0f};
+                put(static_cast<uint32_t>(h.ranges_offset + (b * weights.size() + w) * 2 * sizeof(float)), r.data(),
+                    sizeof(r));
+            }
+            const uint16_t count = static_cast<uint16_t>(std::min<std::size_t>(bands[b].ranges.size(), 0xFFFF));
+            put(static_cast<uint32_t>(h.band_symbols_offset + b * sizeof(uint16_t)), &bands[b].symbol,
+                sizeof(uint16_t));
+            put(static_cast<uint32_t>(h.band_range_counts_offset + b * sizeof(uint16_t)), &count, sizeof(uint16_t));
+        }
+        put(h.flap_labels_offset, labels.data(), labels.size() * sizeof(uint16_t));
+        put(h.symbols_offset, pool.bytes.data(), pool.bytes.size());
+
+        h.crc32 = crc32(out.data() + sizeof(Header), h.file_size - sizeof(Header));
+        std::memcpy(out.data(), &h, sizeof(Header));
+        return out;
+    }
+
+    std::vector<uint8_t> from_json_file(const char* path, std::string* error)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f)
+        {
+            fail(error, "cannot open file");
+            return {};
+        }
+        std::string text;
+        char chunk[512];
+        std::size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) text.append(chunk, n);
+        fclose(f);
+        if (text.empty())
+        {
+            fail(error, "file is empty");
+            return {};
+        }
+
+        const char* slash = std::strrchr(path, '/');
+        return from_json(text.c_str(), slash ? slash + 1 : path, error);
+    }
+
+    bool source_fingerprint(const char* path, uint32_t& size, uint32_t& crc)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        size = 0;
+        crc = 0;
+        uint8_t chunk[256];
+        std::size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        {
+            crc = crc32(chunk, n, crc);
+            size += static_cast<uint32_t>(n);
+        }
+        const bool ok = !ferror(f);
+        fclose(f);
+        return ok;
+    }
+} // namespace fpol
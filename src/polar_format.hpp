@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// .fpol: the flap polar in a binary layout that is used where it lies.
+//
+// A polar JSON (spiffs_data/*.json) is converted once, on the host with
+// test/polar_convert.cpp or on the device when a JSON file is selected, into
+// one contiguous blob:
+//
+//   Header
+//   float    weights[weight_count]                      kg, ascending
+//   float    ranges[band_count][weight_count][2]        vmin, vmax in km/h, -1 = none
+//   uint16_t flap_labels[flap_count]                    symbol offsets
+//   uint16_t band_symbols[band_count]                   symbol offsets
+//   uint16_t band_range_counts[band_count]              ranges given in the JSON
+//   char     symbols[symbol_bytes]                      NUL-terminated, each string once
+//
+// Little-endian, as on the ESP32-S3 and the host. Sections are 4-byte
+// aligned, so a View reads floats straight from a memory-mapped file or
+// flash partition. open() checks magic, version, sizes, offsets and a CRC-32
+// over everything after the header before handing out a View; after that,
+// lookups do no further checks beyond the counts.
+//
+// The header also records the size and CRC-32 of the source JSON, so a copy
+// kept in flash can be matched against the file it came from, and an install
+// number the device stamps when it writes a copy (outside the CRC).
+namespace fpol
+{
+    inline constexpr uint32_t kMagic = 0x4C4F5046; // "FPOL"
+    inline constexpr uint16_t kVersion = 2;
+    inline constexpr uint16_t kNoSymbol = 0xFFFF;
+
+    static_assert(std::endian::native == std::endian::little, ".fpol is little-endian");
+
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t header_size;
+        uint32_t file_size;
+        uint32_t crc32; // bytes [header_size, file_size)
+
+        uint16_t weight_count;
+        uint16_t flap_count;
+        uint16_t band_count;
+        uint16_t symbol_bytes;
+        uint16_t name;          // symbol: file name of the source JSON
+        int16_t lowspeed_flap;  // flap label index of the low-speed band, -1 = none
+
+        float empty_mass_kg;
+        float lowspeed_vmin;    // -1 = no low-speed band
+        float lowspeed_vmax;
+        float vso, vfe, vs1, vno, vne;
+
+        uint32_t weights_offset;
+        uint32_t ranges_offset;
+        uint32_t flap_labels_offset;
+        uint32_t band_symbols_offset;
+        uint32_t band_range_counts_offset;
+        uint32_t symbols_offset;
+
+        uint32_t source_size;   // bytes of the source JSON
+        uint32_t source_crc32;  // CRC-32 of the source JSON
+        uint32_t install;       // 0 from the converter; the device numbers its copies
+    };
+
+    static_assert(sizeof(Header) == 96, "Header layout is part of the file format");
+
+    inline constexpr std::array<uint32_t, 256> kCrcTable = []
+    {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    // CRC-32 (IEEE 802.3), as zlib's crc32(); pass the previous result as
+    // crc to continue over data read in pieces.
+    inline uint32_t crc32(const uint8_t* data, std::size_t len, uint32_t crc = 0)
+    {
+        uint32_t c = crc ^ 0xFFFFFFFFu;
+        for (std::size_t i = 0; i < len; ++i) c = kCrcTable[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    // Validated pointers into a blob. Does not own the memory.
+    struct View
+    {
+        const Header* header = nullptr;
+        const float* weights = nullptr;
+        const float* ranges = nullptr;
+        const uint16_t* flap_labels = nullptr;
+        const uint16_t* band_symbols = nullptr;
+        const uint16_t* band_range_counts = nullptr;
+        const char* symbols = nullptr;
+
+        bool valid() const { return header != nullptr; }
+        std::size_t weight_count() const { return header ? header->weight_count : 0; }
+        std::size_t flap_count() const { return header ? header->flap_count : 0; }
+        std::size_t band_count() const { return header ? header->band_count : 0; }
+
+        const char* symbol(uint16_t offset) const { return offset == kNoSymbol ? nullptr : symbols + offset; }
+        const char* name() const { return header ? symbol(header->name) : nullptr; }
+
+        // vmin/vmax of a band at weights[w].
+        const float* range(std::size_t band, std::size_t w) const
+        {
+            return ranges + (band * header->weight_count + w) * 2;
+        }
+    };
+
+    enum class Error : uint8_t
+    {
+        None,
+        TooSmall,
+        BadMagic,
+        BadVersion,
+        BadSize,
+        BadChecksum,
+        BadLayout,
+    };
+
+    inline const char* error_name(Error e)
+    {
+        switch (e)
+        {
+        case Error::None: return "ok";
+        case Error::TooSmall: return "too small";
+        case Error::BadMagic: return "not a .fpol file";
+        case Error::BadVersion: return "unsupported version";
+        case Error::BadSize: return "size mismatch";
+        case Error::BadChecksum: return "checksum mismatch";
+        case Error::BadLayout: return "bad section layout";
+        }
+        return "?";
+    }
+
+    // Checks the blob and fills out. `size` may exceed the file (a flash
+    // partition is mapped whole); the header's file_size is what counts.
+    inline Error open(const void* data, std::size_t size, View& out)
+    {
+        out = View{};
+        const auto* base = static_cast<const uint8_t*>(data);
+        if (!base || size < sizeof(Header)) return Error::TooSmall;
+        if (reinterpret_cast<uintptr_t>(base) % alignof(float) != 0) return Error::BadLayout;
+
+        const auto* h = reinterpret_cast<const Header*>(base);
+        if (h->magic != kMagic) return Error::BadMagic;
+        if (h->version != kVersion || h->header_size != sizeof(Header)) return Error::BadVersion;
+        if (h->file_size < sizeof(Header) || h->file_size > size) return Error::BadSize;
+        if (crc32(base + sizeof(Header), h->file_size - sizeof(Header)) != h->crc32) return Error::BadChecksum;
+
+        auto section = [&](uint32_t offset, std::size_t bytes, std::size_t align)
+        { return offset >= sizeof(Header) && offset % align == 0 && offset + bytes <= h->file_size; };
+        const std::size_t cells = std::size_t{h->band_count} * h->weight_count * 2;
+        if (!section(h->weights_offset, h->weight_count * sizeof(float), 4) ||
+            !section(h->ranges_offset, cells * sizeof(float), 4) ||
+            !section(h->flap_labels_offset, h->flap_count * sizeof(uint16_t), 2) ||
+            !section(h->band_symbols_offset, h->band_count * sizeof(uint16_t), 2) ||
+            !section(h->band_range_counts_offset, h->band_count * sizeof(uint16_t), 2) ||
+            !section(h->symbols_offset, h->symbol_bytes, 1) || h->symbol_bytes == 0 ||
+            base[h->symbols_offset + h->symbol_bytes - 1] != '\0')
+            return Error::BadLayout;
+        if (h->flap_count > 0 && h->lowspeed_flap >= static_cast<int>(h->flap_count)) return Error::BadLayout;
+
+        const auto* labels = reinterpret_cast<const uint16_t*>(base + h->flap_labels_offset);
+        const auto* bands = reinterpret_cast<const uint16_t*>(base + h->band_symbols_offset);
+        auto symbol_ok = [&](uint16_t s) { return s == kNoSymbol || s < h->symbol_bytes; };
+        if (!symbol_ok(h->name)) return Error::BadLayout;
+        for (std::size_t i = 0; i < h->flap_count; ++i)
+            if (!symbol_ok(labels[i])) return Error::BadLayout;
+        for (std::size_t i = 0; i < h->band_count; ++i)
+            if (!symbol_ok(bands[i])) return Error::BadLayout;
+
+        out.header = h;
+        out.weights = reinterpret_cast<const float*>(base + h->weights_offset);
+        out.ranges = reinterpret_cast<const float*>(base + h->ranges_offset);
+        out.flap_labels = labels;
+        out.band_symbols = bands;
+        out.band_range_counts = reinterpret_cast<const uint16_t*>(base + h->band_range_counts_offset);
+        out.symbols = reinterpret_cast<const char*>(base + h->symbols_offset);
+        return Error::None;
+    }
+
+    // Converts polar JSON text into a .fpol blob. `name` is stored as the
+    // source file name. Returns an empty vector and sets error (if given) when
+    // the JSON does not parse or is too large for the format.
+    std::vector<uint8_t> from_json(const char* json, const char* name, std::string* error = nullptr);
+
+    // Reads and converts a JSON file.
+    std::vector<uint8_t> from_json_file(const char* path, std::string* error = nullptr);
+
+    // Size and CRC-32 of a file as from_json() records them for its source,
+    // read in pieces without holding the file in memory. False if the file
+    // cannot be read.
+    bool source_fingerprint(const char* path, uint32_t& size, uint32_t& crc);
+} // namespace fpol
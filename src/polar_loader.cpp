@@ -0,0 +1,138 @@
+#include "polar_loader.hpp"
+#include "flaputils.hpp"
+#include "seqlock.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#ifndef NATIVE_TEST_BUILD
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace polar_loader
+{
+    struct Request
+    {
+        uint32_t number;
+        char path[128];
+    };
+
+    // Written by the loader task only.
+    static Seqlock<Status> kStatus;
+    static std::atomic<uint32_t> kLastRequest{0};
+
+    static void run(const Request& r)
+    {
+        kStatus.store({r.number, State::Loading});
+        const bool ok = flaputils::load_data(r.path);
+        if (ok && !flaputils::save_polar_path(r.path))
+            printf("polar_loader: %s loaded but not persisted\n", r.path);
+        kStatus.store({r.number, ok ? State::Loaded : State::Failed});
+    }
+
+#ifndef NATIVE_TEST_BUILD
+    // Below the CAN tasks on core 0, away from the LVGL task. The stack
+    // covers the cJSON parse of a polar.
+    static constexpr uint32_t kStackSize = 6144;
+    static constexpr UBaseType_t kPriority = 2;
+
+    static QueueHandle_t kQueue = nullptr;
+
+    [[noreturn]] static void loader_task(void*)
+    {
+        Request r;
+        while (true)
+        {
+            // Idle: erase ahead of the next load rather than during it.
+            flaputils::prepare_polar_slot();
+            if (xQueueReceive(kQueue, &r, portMAX_DELAY) == pdTRUE) run(r);
+        }
+    }
+
+    void start()
+    {
+        if (kQueue) return;
+        kQueue = xQueueCreate(1, sizeof(Request));
+        if (kQueue) xTaskCreatePinnedToCore(loader_task, "polar_loader", kStackSize, nullptr, kPriority, nullptr, 0);
+    }
+
+    static bool enqueue(const Request& r)
+    {
+        // A one-slot queue: overwriting drops a request the task has not
+        // picked up yet.
+        return kQueue && xQueueOverwrite(kQueue, &r) == pdPASS;
+    }
+#else
+    static std::mutex kMutex;
+    static std::condition_variable kWake;
+    static Request kPending{};
+    static bool kHasPending = false;
+    static bool kRunning = false;
+    static std::thread kThread;
+
+    static void loader_thread()
+    {
+        std::unique_lock<std::mutex> lock(kMutex);
+        while (true)
+        {
+            kWake.wait(lock, [] { return kHasPending || !kRunning; });
+            if (!kHasPending) return;
+            const Request r = kPending;
+            kHasPending = false;
+            lock.unlock();
+            run(r);
+            lock.lock();
+        }
+    }
+
+    void start()
+    {
+        const std::lock_guard<std::mutex> lock(kMutex);
+        if (kRunning) return;
+        kRunning = true;
+        kThread = std::thread(loader_thread);
+    }
+
+    void stop()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(kMutex);
+            if (!kRunning) return;
+            kRunning = false;
+            kHasPending = false;
+        }
+        kWake.notify_one();
+        kThread.join();
+    }
+
+    static bool enqueue(const Request& r)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(kMutex);
+            if (!kRunning) return false;
+            kPending = r;
+            kHasPending = true;
+        }
+        kWake.notify_one();
+        return true;
+    }
+#endif
+
+    uint32_t request(const char* filepath)
+    {
+        Request r{};
+        if (!filepath || std::strlen(filepath) >= sizeof(r.path)) return 0;
+        std::strcpy(r.path, filepath);
+        r.number = kLastRequest.fetch_add(1, std::memory_order_relaxed) + 1;
+        return enqueue(r) ? r.number : 0;
+    }
+
+    Status status() { return kStatus.load(); }
+
+} // namespace polar_loader
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// Background polar loading. A load (file read, JSON parse or flash write,
+// NVS commit) takes far longer than a frame, so the LVGL task only queues
+// the request here and polls status(); a loader task does the work and
+// flaputils switches the new polar in whole.
+//
+// The queue holds one request: a newer one replaces a request still
+// waiting, so only the last polar picked is loaded.
+namespace polar_loader
+{
+    enum class State : uint8_t
+    {
+        Idle,    // no request handled yet
+        Loading, // request is being loaded
+        Loaded,  // request is the active polar and its path is persisted
+        Failed,  // request did not load; the previous polar stays active
+    };
+
+    struct Status
+    {
+        uint32_t request; // number returned by request(), 0 before the first
+        State state;
+    };
+
+    // Starts the loader task. Call once, after the filesystem is mounted.
+    void start();
+
+#ifdef NATIVE_TEST_BUILD
+    // Finishes the request in progress and ends the loader thread.
+    void stop();
+#endif
+
+    // Queues a load of filepath and returns its request number, or 0 if the
+    // loader is not running or the path is too long. Never blocks.
+    uint32_t request(const char* filepath);
+
+    // Latest request the loader has picked up, and how far it got. Safe
+    // from any task.
+    Status status();
+
+} // namespace polar_loader
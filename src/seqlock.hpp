@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef NATIVE_TEST_BUILD
+#include <thread>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+// Single-writer sequence lock for small trivially copyable values.
+//
+// The writer bumps the sequence to odd, stores the payload and bumps it back
+// to even. Readers copy the payload and retry if the sequence was odd or moved
+// underneath them, so they never block the writer and never see a torn value.
+// The payload is kept as relaxed atomic words, which keeps the copy free of
+// data races without any lock.
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+public:
+    // Must only be called from one thread at a time.
+    void store(const T& value)
+    {
+        uint32_t buf[kWords] = {};
+        std::memcpy(buf, &value, sizeof(T));
+
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i) words_[i].store(buf[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Optionally reports the (even) sequence the returned value was stored under.
+    T load(uint32_t* sequence_out = nullptr) const
+    {
+        uint32_t buf[kWords];
+        uint32_t spins = 0;
+        uint32_t s0;
+        while (true)
+        {
+            s0 = seq_.load(std::memory_order_acquire);
+            if ((s0 & 1u) == 0)
+            {
+                for (std::size_t i = 0; i < kWords; ++i) buf[i] = words_[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == s0) break;
+            }
+            // A higher-priority reader can preempt the writer mid-store on the
+            // same core; back off so the writer gets to finish.
+            if (++spins >= 64)
+            {
+                spins = 0;
+                backoff();
+            }
+        }
+        if (sequence_out) *sequence_out = s0;
+        T out;
+        std::memcpy(&out, buf, sizeof(T));
+        return out;
+    }
+
+    // Even value that changes on every store(); handy for "anything new?" checks.
+    uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    static void backoff()
+    {
+#ifdef NATIVE_TEST_BUILD
+        std::this_thread::yield();
+#else
+        vTaskDelay(1);
+#endif
+    }
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> words_[kWords] = {};
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "flight_data.hpp"
+#include "seqlock.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Windowed statistics of one signal, as published by FlightHistory.
+struct SignalStats
+{
+    uint16_t count = 0;   // samples in the window, 0 = nothing received yet
+    uint32_t span_ms = 0; // oldest to newest sample
+    float last = 0;
+    float min = 0;
+    float max = 0;
+    float mean = 0;
+    float slope = 0; // least-squares trend in units per second, 0 below two samples
+};
+
+// Fixed-capacity history of one signal with O(1) windowed statistics.
+//
+// Raw samples are averaged into one entry per interval_ms, so Capacity entries
+// cover Capacity * interval_ms regardless of the CAN rate. Entries older than
+// that (after a gap in reception) are dropped as well.
+//
+// Mean and regression slope come from running sums that are updated when an
+// entry enters or leaves the window. Min and max come from two monotonic
+// queues of ring positions, amortized O(1) per entry. Times in the sums are
+// relative to a base that is moved forward once per Capacity entries, which
+// also re-sums the window and so bounds the rounding drift of the
+// add/subtract updates.
+//
+// No allocation; not thread-safe (FlightHistory publishes the results).
+template <std::size_t Capacity>
+class SignalHistory
+{
+    static_assert(Capacity >= 2 && Capacity <= UINT16_MAX, "Capacity must fit the uint16_t ring positions");
+
+public:
+    struct Sample
+    {
+        uint32_t t_ms;
+        float value;
+    };
+
+    static constexpr std::size_t kCapacity = Capacity;
+
+    explicit SignalHistory(uint32_t interval_ms = 1000) : interval_ms_(interval_ms ? interval_ms : 1) {}
+
+    uint32_t interval_ms() const { return interval_ms_; }
+    uint32_t window_ms() const { return interval_ms_ * static_cast<uint32_t>(Capacity); }
+
+    // Adds a raw sample. Returns true if it closed the running interval, i.e.
+    // a new entry went into the window and stats() changed.
+    bool add(float value, uint32_t t_ms)
+    {
+        bool committed = false;
+        if (bucket_n_ != 0 && t_ms - bucket_start_ms_ >= interval_ms_)
+        {
+            commit();
+            committed = true;
+        }
+        if (bucket_n_ == 0)
+        {
+            bucket_start_ms_ = t_ms;
+            bucket_sum_ = 0;
+        }
+        bucket_sum_ += value;
+        bucket_last_ms_ = t_ms;
+        ++bucket_n_;
+        return committed;
+    }
+
+    // Closes the running interval early, e.g. before reading a final result.
+    void flush()
+    {
+        if (bucket_n_ != 0) commit();
+    }
+
+    void clear()
+    {
+        head_ = count_ = 0;
+        min_q_.clear();
+        max_q_.clear();
+        bucket_n_ = 0;
+        since_rebase_ = 0;
+        sum_t_ = sum_v_ = sum_tt_ = sum_tv_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // i = 0 is the oldest entry.
+    const Sample& at(std::size_t i) const { return ring_[wrap(head_ + i)]; }
+    const Sample& newest() const { return at(count_ - 1); }
+
+    SignalStats stats() const
+    {
+        SignalStats s;
+        if (count_ == 0) return s;
+        const Sample& first = at(0);
+        const Sample& last = newest();
+        const double n = static_cast<double>(count_);
+        s.count = static_cast<uint16_t>(count_);
+        s.span_ms = last.t_ms - first.t_ms;
+        s.last = last.value;
+        s.min = ring_[min_q_.front()].value;
+        s.max = ring_[max_q_.front()].value;
+        s.mean = static_cast<float>(sum_v_ / n);
+        const double denom = n * sum_tt_ - sum_t_ * sum_t_;
+        if (count_ >= 2 && denom > 0) s.slope = static_cast<float>((n * sum_tv_ - sum_t_ * sum_v_) / denom * 1000.0);
+        return s;
+    }
+
+private:
+    // Ring positions in arrival order; a tiny deque over a fixed array.
+    struct PosQueue
+    {
+        std::array<uint16_t, Capacity> pos;
+        std::size_t first = 0;
+        std::size_t n = 0;
+
+        void clear() { first = n = 0; }
+        bool empty() const { return n == 0; }
+        uint16_t front() const { return pos[first]; }
+        uint16_t back() const { return pos[wrap(first + n - 1)]; }
+        void pop_front() { first = wrap(first + 1); --n; }
+        void pop_back() { --n; }
+        void push_back(uint16_t p) { pos[wrap(first + n)] = p; ++n; }
+    };
+
+    static std::size_t wrap(std::size_t i) { return i >= Capacity ? i - Capacity : i; }
+
+    void commit()
+    {
+        const Sample e{bucket_start_ms_ + (bucket_last_ms_ - bucket_start_ms_) / 2,
+                       bucket_sum_ / static_cast<float>(bucket_n_)};
+        bucket_n_ = 0;
+
+        if (count_ == Capacity) evict();
+        while (count_ != 0 && e.t_ms - at(0).t_ms >= window_ms()) evict();
+        if (count_ == 0)
+        {
+            base_ms_ = e.t_ms;
+            since_rebase_ = 0;
+        }
+
+        const uint16_t p = static_cast<uint16_t>(wrap(head_ + count_));
+        ring_[p] = e;
+        ++count_;
+        accumulate(e, 1.0);
+        while (!min_q_.empty() && ring_[min_q_.back()].value >= e.value) min_q_.pop_back();
+        min_q_.push_back(p);
+        while (!max_q_.empty() && ring_[max_q_.back()].value <= e.value) max_q_.pop_back();
+        max_q_.push_back(p);
+
+        if (++since_rebase_ >= Capacity) rebase();
+    }
+
+    void evict()
+    {
+        const uint16_t p = static_cast<uint16_t>(head_);
+        accumulate(ring_[p], -1.0);
+        if (min_q_.front() == p) min_q_.pop_front();
+        if (max_q_.front() == p) max_q_.pop_front();
+        head_ = wrap(head_ + 1);
+        --count_;
+    }
+
+    void accumulate(const Sample& e, double sign)
+    {
+        const double t = static_cast<double>(static_cast<int32_t>(e.t_ms - base_ms_));
+        const double v = e.value;
+        sum_t_ += sign * t;
+        sum_v_ += sign * v;
+        sum_tt_ += sign * t * t;
+        sum_tv_ += sign * t * v;
+    }
+
+    void rebase()
+    {
+        since_rebase_ = 0;
+        base_ms_ = at(0).t_ms;
+        sum_t_ = sum_v_ = sum_tt_ = sum_tv_ = 0;
+        for (std::size_t i = 0; i < count_; ++i) accumulate(at(i), 1.0);
+    }
+
+    std::array<Sample, Capacity> ring_;
+    PosQueue min_q_;
+    PosQueue max_q_;
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    uint32_t interval_ms_;
+
+    // Running interval.
+    float bucket_sum_ = 0;
+    uint32_t bucket_n_ = 0;
+    uint32_t bucket_start_ms_ = 0;
+    uint32_t bucket_last_ms_ = 0;
+
+    // Regression sums, t in ms relative to base_ms_. Double because the
+    // t*t terms cancel badly in single precision.
+    uint32_t base_ms_ = 0;
+    std::size_t since_rebase_ = 0;
+    double sum_t_ = 0;
+    double sum_v_ = 0;
+    double sum_tt_ = 0;
+    double sum_tv_ = 0;
+};
+
+// Trend history of the signals the screens derive averages and rates from:
+// IAS, altitude, vario, wind speed, ground speed and flap position. Fed by
+// CanIngest with every decoded sample (single writer); stats() is published
+// through a Seqlock per signal and may be read from any thread.
+//
+// 1 s entries over 5 minutes: about 3.6 KB per signal, 22 KB in total.
+class FlightHistory
+{
+public:
+    static constexpr uint32_t kIntervalMs = 1000;
+    static constexpr std::size_t kEntries = 300;
+    static constexpr SignalMask kTracked =
+        signal_mask(FlightSignal::Ias, FlightSignal::Alt, FlightSignal::Vario, FlightSignal::WindSpeed,
+                    FlightSignal::GpsGroundSpeed, FlightSignal::Flap);
+
+    using History = SignalHistory<kEntries>;
+
+    static constexpr bool tracks(FlightSignal s) { return (kTracked & signal_mask(s)) != 0; }
+
+    // Writer thread. Picks the value of `signal` out of the staged snapshot.
+    void add(FlightSignal signal, const FlightSnapshot& snap, uint32_t t_ms)
+    {
+        if (!tracks(signal)) return;
+        const std::size_t i = slot(signal);
+        if (histories_[i].add(value_of(signal, snap), t_ms)) stats_[i].store(histories_[i].stats());
+    }
+
+    // Latest published statistics; zero count for untracked signals.
+    SignalStats stats(FlightSignal signal) const
+    {
+        return tracks(signal) ? stats_[slot(signal)].load() : SignalStats{};
+    }
+
+    // Raw entries, for the writer thread only.
+    const History* history(FlightSignal signal) const
+    {
+        return tracks(signal) ? &histories_[slot(signal)] : nullptr;
+    }
+
+private:
+    static constexpr std::size_t kCount = static_cast<std::size_t>(__builtin_popcount(kTracked));
+
+    // Index among the tracked signals.
+    static constexpr std::size_t slot(FlightSignal s)
+    {
+        return static_cast<std::size_t>(__builtin_popcount(kTracked & (signal_mask(s) - 1)));
+    }
+
+    static float value_of(FlightSignal s, const FlightSnapshot& snap)
+    {
+        switch (s)
+        {
+        case FlightSignal::Ias: return snap.ias;
+        case FlightSignal::Alt: return snap.alt;
+        case FlightSignal::Vario: return snap.vario;
+        case FlightSignal::WindSpeed: return snap.wind_speed;
+        case FlightSignal::GpsGroundSpeed: return snap.gps_ground_speed;
+        case FlightSignal::Flap: return static_cast<float>(snap.flapIdx);
+        default: return 0;
+        }
+    }
+
+    std::array<History, kCount> histories_;
+    std::array<Seqlock<SignalStats>, kCount> stats_;
+};
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include "lvgl.h"
 #include "../ui.h"
 #include "../ui_helpers.hpp"
@@ -10,6 +13,11 @@ static lv_obj_t* s_screen = nullptr;
 static lv_obj_t* s_scale = nullptr;
 static lv_obj_t* s_needle = nullptr;
 static lv_obj_t* s_label = nullptr;
+static lv_obj_t* s_trend = nullptr;
+static lv_obj_t* s_unit_label = nullptr;
+static lv_scale_section_t* s_sec_white = nullptr;
+static lv_scale_section_t* s_sec_green = nullptr;
+static lv_scale_section_t* s_sec_yellow = nullptr;
 static StaleOverlayState s_stale_overlay;
 
 // Needle dimensions
@@ -18,9 +26,19 @@ static constexpr int32_t NEEDLE_OUTER_RADIUS = 200;
 static constexpr int32_t SCALE_LABEL_GAP = 26;
 static constexpr int32_t ASI_ARC_WIDTH = 15;
 
-// Scale range
-static constexpr float ASI_MIN = 40.0f;
-static constexpr float ASI_MAX = 280.0f;
+// Speed trend arc, between the tick ends and the scale labels
+static constexpr int32_t TREND_ARC_RADIUS = 207;
+static constexpr int32_t TREND_ARC_WIDTH = 8;
+static constexpr float TREND_SECONDS = 5.0f;  // arc shows where IAS will be in 5 s
+static constexpr float TREND_MIN_SPEED = 1.0f; // display units; shorter trends are not drawn
+
+// Scale range and limits in the display unit, set by ui_sync_units() only
+// when the unit or the polar changes. Everything below works in display
+// units, so nothing is converted per frame.
+static float s_asi_min = 40.0f;
+static float s_asi_max = 280.0f;
+static flaputils::SpeedLimits s_limits = {};
+static uint32_t s_units_gen = 0; // units::generation() of the scale
 
 // ASI Arc colors
 #define ASI_COLOR_WHITE  lv_color_white()
@@ -42,10 +60,13 @@ static constexpr float ASI_MAX = 280.0f;
 //
 // Tune the constants below.
 
-static float s_raw_ema = ASI_MIN;      // filtered sensor target (km/h)
-static float s_x = ASI_MIN;            // displayed speed state (km/h)
-static float s_v = 0.0f;               // displayed speed rate state (km/h per sec)
+static float s_raw_ema = 40.0f;        // filtered sensor target
+static float s_x = 40.0f;              // displayed speed state
+static float s_v = 0.0f;               // displayed speed rate state (per sec)
 static uint32_t s_last_ms = 0;
+static int32_t s_drawn_speed = INT32_MIN; // needle position on screen
+static int32_t s_trend_a0 = -1;         // trend arc angles on screen, -1 = hidden
+static int32_t s_trend_a1 = -1;
 
 // Sensor filtering (removes jitter before feeding the “mechanical” model)
 static constexpr float SENSOR_TAU_SEC = 0.18f; // 0.12..0.35
@@ -63,12 +84,12 @@ static constexpr float WN_HIGH = 9.0f;    // rad/s at high speed
 // (1.0 = none; >1 slows decel response)
 static constexpr float DECEL_LAG = 1.10f;
 
-// Deadband (“stiction”) in km/h to stop needle from buzzing when nearly steady
+// Deadband (“stiction”) in display units to stop needle from buzzing when nearly steady
 static constexpr float STICTION_BAND = 0.35f;
 
 // Max needle acceleration / rate clamps (stability + realism)
-static constexpr float MAX_RATE_KMH_PER_SEC = 420.0f;     // cap speed of needle motion
-static constexpr float MAX_ACCEL_KMH_PER_SEC2 = 2200.0f;  // cap acceleration
+static constexpr float MAX_RATE_PER_SEC = 420.0f;     // cap speed of needle motion
+static constexpr float MAX_ACCEL_PER_SEC2 = 2200.0f;  // cap acceleration
 
 static float clampf(float x, float lo, float hi)
 {
@@ -115,7 +136,7 @@ static void ui_set_line_needle_value(lv_obj_t* scale_obj, lv_obj_t* needle_line,
     lv_line_set_points(needle_line, points, 2);
 }
 
-static void asi_step_mechanics(float target_kmh)
+static void asi_step_mechanics(float target)
 {
     // dt
     uint32_t now = lv_tick_get();
@@ -129,55 +150,62 @@ static void asi_step_mechanics(float target_kmh)
     s_last_ms = now;
 
     // Clamp target to scale
-    target_kmh = clampf(target_kmh, ASI_MIN, ASI_MAX);
+    target = clampf(target, s_asi_min, s_asi_max);
 
     // --- "Stiction" deadband: if very close and moving slowly, stop ---
-    const float err0 = target_kmh - s_x;
+    const float err0 = target - s_x;
     if (fabsf(err0) < STICTION_BAND && fabsf(s_v) < 2.0f)
     {
-        s_x = target_kmh;
+        s_x = target;
         s_v = 0.0f;
         return;
     }
 
     // --- ωn depends on speed (heavier at low speed) ---
-    const float t = clampf((s_x - ASI_MIN) / (ASI_MAX - ASI_MIN), 0.0f, 1.0f);
+    const float t = clampf((s_x - s_asi_min) / (s_asi_max - s_asi_min), 0.0f, 1.0f);
     float wn = lerpf(WN_LOW, WN_HIGH, t);
 
     // Different damping up/down + slower decel feel
-    const bool accelerating = (target_kmh > s_x);
+    const bool accelerating = (target > s_x);
     float zeta = accelerating ? ZETA_UP : ZETA_DOWN;
     float lag = accelerating ? 1.0f : DECEL_LAG;
     wn /= lag;
 
     // Second-order dynamics
     // a = ωn^2 * (target - x) - 2ζωn * v
-    float a = (wn * wn) * (target_kmh - s_x) - (2.0f * zeta * wn) * s_v;
+    float a = (wn * wn) * (target - s_x) - (2.0f * zeta * wn) * s_v;
 
     // Clamp acceleration (helps stability and realism)
-    a = clampf(a, -MAX_ACCEL_KMH_PER_SEC2, MAX_ACCEL_KMH_PER_SEC2);
+    a = clampf(a, -MAX_ACCEL_PER_SEC2, MAX_ACCEL_PER_SEC2);
 
     // Integrate (semi-implicit Euler)
     s_v += a * dt;
-    s_v = clampf(s_v, -MAX_RATE_KMH_PER_SEC, MAX_RATE_KMH_PER_SEC);
+    s_v = clampf(s_v, -MAX_RATE_PER_SEC, MAX_RATE_PER_SEC);
 
     s_x += s_v * dt;
-    s_x = clampf(s_x, ASI_MIN, ASI_MAX);
+    s_x = clampf(s_x, s_asi_min, s_asi_max);
 
     // If we crossed the target, damp out quickly to avoid long ringing
     // (keeps it "instrument-like" rather than "spring toy")
-    const float err1 = target_kmh - s_x;
+    const float err1 = target - s_x;
     if ((err0 > 0 && err1 < 0) || (err0 < 0 && err1 > 0))
     {
         s_v *= 0.55f;
     }
 }
 
-static void ui_update_asi(float raw_kmh)
+// Needle at rest on raw: further steps would not move it.
+static bool asi_settled(float raw)
+{
+    if (std::isnan(raw) || std::isinf(raw)) raw = s_asi_min;
+    return s_v == 0.0f && fabsf(clampf(raw, s_asi_min, s_asi_max) - s_x) < 0.05f;
+}
+
+static void ui_update_asi(float raw)
 {
     // sanitize & clamp to scale range
-    if (std::isnan(raw_kmh) || std::isinf(raw_kmh)) raw_kmh = ASI_MIN;
-    raw_kmh = clampf(raw_kmh, ASI_MIN, ASI_MAX);
+    if (std::isnan(raw) || std::isinf(raw)) raw = s_asi_min;
+    raw = clampf(raw, s_asi_min, s_asi_max);
 
     // time step for EMA (use lv_tick too, but keep it simple/robust)
     static uint32_t last_ema_ms = 0;
@@ -193,18 +221,20 @@ static void ui_update_asi(float raw_kmh)
 
     // 1) sensor low-pass
     const float alpha = dt / (SENSOR_TAU_SEC + dt);
-    s_raw_ema += alpha * (raw_kmh - s_raw_ema);
+    s_raw_ema += alpha * (raw - s_raw_ema);
 
     // 2) “mechanical” model step
     asi_step_mechanics(s_raw_ema);
 
-    // 3) draw needle
+    // 3) draw needle, only when it moved by a whole unit
     const int32_t vi = (int32_t)lroundf(s_x);
+    if (vi == s_drawn_speed) return;
+    s_drawn_speed = vi;
     ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, vi);
 
     // Update needle color based on current displayed speed
     lv_color_t n_color = ASI_COLOR_WHITE;
-    flaputils::SpeedLimits sl = flaputils::get_speed_limits();
+    const flaputils::SpeedLimits& sl = s_limits;
     if(s_x >= sl.vne) n_color = ASI_COLOR_RED;
     else if(s_x >= sl.vno) n_color = ASI_COLOR_YELLOW;
     else if(s_x >= sl.vs1) n_color = ASI_COLOR_GREEN;
@@ -214,6 +244,41 @@ static void ui_update_asi(float raw_kmh)
     lv_obj_set_style_line_color(s_needle, n_color, 0);
 }
 
+// Scale angle (0..angle range) of a speed, clamped to the scale.
+static int32_t asi_angle(float speed)
+{
+    const float t = clampf((speed - s_asi_min) / (s_asi_max - s_asi_min), 0.0f, 1.0f);
+    return (int32_t)lroundf(t * lv_scale_get_angle_range(s_scale));
+}
+
+// Arc from the needle to the speed expected in TREND_SECONDS. lv_arc only
+// invalidates the part of the ring between the old and the new angles, so a
+// growing or shrinking trend redraws a thin slice of the screen.
+static void ui_update_trend(float trend_per_s, bool stale)
+{
+    if (!s_trend) return;
+    const float delta = trend_per_s * TREND_SECONDS;
+    int32_t a0 = -1;
+    int32_t a1 = -1;
+    if (!stale && std::isfinite(delta) && fabsf(delta) >= TREND_MIN_SPEED)
+    {
+        a0 = asi_angle(s_x);
+        a1 = asi_angle(s_x + delta);
+        if (a1 < a0) std::swap(a0, a1);
+        if (a1 == a0) a0 = a1 = -1;
+    }
+    if (a0 == s_trend_a0 && a1 == s_trend_a1) return;
+
+    if (a0 < 0)
+        lv_obj_add_flag(s_trend, LV_OBJ_FLAG_HIDDEN);
+    else
+    {
+        lv_arc_set_angles(s_trend, a0, a1);
+        if (s_trend_a0 < 0) lv_obj_remove_flag(s_trend, LV_OBJ_FLAG_HIDDEN);
+    }
+    s_trend_a0 = a0;
+    s_trend_a1 = a1;
+}
 
 static inline void make_noninteractive(lv_obj_t* o)
 {
@@ -228,15 +293,12 @@ static void ui_create_gauge()
     lv_obj_set_style_bg_color(s_screen, lv_color_black(), 0);
     lv_obj_set_style_bg_opa(s_screen, LV_OPA_COVER, 0);
 
-    // Round inner scale 40..280 km/h
+    // Round inner scale; range and ticks follow the speed unit (ui_sync_units)
     s_scale = lv_scale_create(s_screen);
     lv_obj_set_size(s_scale, 466, 466);
     lv_obj_center(s_scale);
 
     lv_scale_set_mode(s_scale, LV_SCALE_MODE_ROUND_INNER);
-    lv_scale_set_range(s_scale, (int32_t)ASI_MIN, (int32_t)ASI_MAX);
-    lv_scale_set_total_tick_count(s_scale, 25); // total ticks (40, 50, 60, ..., 280)
-    lv_scale_set_major_tick_every(s_scale, 2);  // major each 2nd tick (40, 60, 80, ...)
     lv_scale_set_angle_range(s_scale, 280);
     lv_scale_set_rotation(s_scale, 130);
     lv_scale_set_label_show(s_scale, true);
@@ -268,27 +330,35 @@ static void ui_create_gauge()
     lv_style_set_arc_color(&style_yellow, ASI_COLOR_YELLOW);
     lv_style_set_arc_width(&style_yellow, ASI_ARC_WIDTH);
 
-    lv_scale_section_t* sec;
-    flaputils::SpeedLimits sl = flaputils::get_speed_limits();
-
-    // White arc: Vso to Vfe
-    sec = lv_scale_add_section(s_scale);
-    lv_scale_set_section_range(s_scale, sec, (int32_t)sl.vso, (int32_t)sl.vfe);
-    lv_scale_set_section_style_main(s_scale, sec, &style_white);
+    // White arc: Vso to Vfe, green arc: Vs1 to Vno, yellow arc: Vno to Vne.
+    // Ranges are set by ui_sync_units().
+    s_sec_white = lv_scale_add_section(s_scale);
+    lv_scale_set_section_style_main(s_scale, s_sec_white, &style_white);
 
-    // Green arc: Vs1 to Vno
-    sec = lv_scale_add_section(s_scale);
-    lv_scale_set_section_range(s_scale, sec, (int32_t)sl.vs1, (int32_t)sl.vno);
-    lv_scale_set_section_style_main(s_scale, sec, &style_green);
+    s_sec_green = lv_scale_add_section(s_scale);
+    lv_scale_set_section_style_main(s_scale, s_sec_green, &style_green);
 
-    // Yellow arc: Vno to Vne
-    sec = lv_scale_add_section(s_scale);
-    lv_scale_set_section_range(s_scale, sec, (int32_t)sl.vno, (int32_t)sl.vne);
-    lv_scale_set_section_style_main(s_scale, sec, &style_yellow);
+    s_sec_yellow = lv_scale_add_section(s_scale);
+    lv_scale_set_section_style_main(s_scale, s_sec_yellow, &style_yellow);
 
     lv_obj_set_style_text_color(s_scale, lv_color_white(), 0);
     lv_obj_set_style_text_font(s_scale, &lv_font_montserrat_28, 0);
 
+    // Speed trend arc, same geometry as the scale
+    s_trend = lv_arc_create(s_scale);
+    make_noninteractive(s_trend);
+    lv_obj_set_size(s_trend, 2 * TREND_ARC_RADIUS, 2 * TREND_ARC_RADIUS);
+    lv_obj_align(s_trend, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_remove_style(s_trend, nullptr, LV_PART_KNOB);
+    lv_obj_set_style_arc_opa(s_trend, LV_OPA_0, LV_PART_MAIN);
+    lv_obj_set_style_arc_width(s_trend, TREND_ARC_WIDTH, LV_PART_INDICATOR);
+    lv_obj_set_style_arc_color(s_trend, lv_palette_main(LV_PALETTE_PURPLE), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_rounded(s_trend, false, LV_PART_INDICATOR);
+    lv_arc_set_rotation(s_trend, lv_scale_get_rotation(s_scale));
+    lv_arc_set_bg_angles(s_trend, 0, lv_scale_get_angle_range(s_scale));
+    lv_obj_add_flag(s_trend, LV_OBJ_FLAG_HIDDEN);
+    s_trend_a0 = s_trend_a1 = -1;
+
     // Needle
     s_needle = lv_line_create(s_scale);
     lv_obj_set_style_line_width(s_needle, 11, 0);
@@ -303,11 +373,10 @@ static void ui_create_gauge()
     lv_obj_center(s_label);
 
     // Unit
-    lv_obj_t* unit = lv_label_create(s_screen);
-    lv_obj_set_style_text_color(unit, lv_color_white(), 0);
-    lv_obj_set_style_text_font(unit, &lv_font_montserrat_16, 0);
-    lv_label_set_text(unit, "km/h");
-    lv_obj_align(unit, LV_ALIGN_CENTER, 0, 80);
+    s_unit_label = lv_label_create(s_screen);
+    lv_obj_set_style_text_color(s_unit_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(s_unit_label, &lv_font_montserrat_16, 0);
+    lv_obj_align(s_unit_label, LV_ALIGN_CENTER, 0, 80);
 
     /* Title */
     lv_obj_t* title = lv_label_create(s_screen);
@@ -317,25 +386,95 @@ static void ui_create_gauge()
     lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
     lv_obj_align(title, LV_ALIGN_BOTTOM_MID, 0, -10);
 
-    // Initial position (min of scale)
-    ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, (int32_t)ASI_MIN);
-
     // Stale overlay starts removed and is created on demand.
     s_stale_overlay = {};
+    s_units_gen = 0;
+}
+
+// Start the needle at rest on v, without a swing from the old position.
+static void asi_reset(float v)
+{
+    if (std::isnan(v) || std::isinf(v)) v = s_asi_min;
+    v = clampf(v, s_asi_min, s_asi_max);
+
+    s_raw_ema = v;
+    s_x = v;
+    s_v = 0.0f;
+    s_last_ms = 0;
+    s_drawn_speed = INT32_MIN;
+}
+
+// Scale range, ticks and limit arcs in the display unit. Runs when the
+// screen is loaded and only does work if the unit or the polar limits
+// changed since the last time: the ticks are regenerated once per change.
+static void ui_sync_units(float v)
+{
+    const bool unit_changed = s_units_gen != units::generation();
+    const flaputils::SpeedLimits& sl = flaputils::get_display_speed_limits();
+    if (!unit_changed && std::memcmp(&sl, &s_limits, sizeof(sl)) == 0) return;
+
+    if (unit_changed)
+    {
+        s_units_gen = units::generation();
+        const units::AsiScale& asi = units::speed().asi;
+        s_asi_min = (float)asi.min;
+        s_asi_max = (float)asi.max;
+        lv_scale_set_range(s_scale, asi.min, asi.max);
+        lv_scale_set_total_tick_count(s_scale, asi.ticks);
+        lv_scale_set_major_tick_every(s_scale, asi.major_every);
+        lv_label_set_text(s_unit_label, units::speed().label);
+        asi_reset(v);
+        ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, (int32_t)lroundf(s_x));
+    }
+
+    s_limits = sl;
+    lv_scale_set_section_range(s_scale, s_sec_white, (int32_t)lroundf(sl.vso), (int32_t)lroundf(sl.vfe));
+    lv_scale_set_section_range(s_scale, s_sec_green, (int32_t)lroundf(sl.vs1), (int32_t)lroundf(sl.vno));
+    lv_scale_set_section_range(s_scale, s_sec_yellow, (int32_t)lroundf(sl.vno), (int32_t)lroundf(sl.vne));
+    s_drawn_speed = INT32_MIN; // needle colour
+}
+
+// Signals this screen draws; only these raise the stale overlay.
+static constexpr SignalMask kDrawnSignals = signal_mask(FlightSignal::Ias);
+
+// Smooth "instrument-like" needle: 25 Hz while IAS changes.
+static ScreenRefresh s_refresh{kDrawnSignals, 40};
+
+static void set_speed_label(int speed)
+{
+    static int shown = INT32_MIN;
+    if (!s_label || speed == shown) return;
+    shown = speed;
+    lv_label_set_text_fmt(s_label, "%d", speed);
 }
 
 static void ui_update_timer_cb(lv_timer_t* /*t*/)
 {
     if (lv_screen_active() != s_screen) return;
 
-    const bool stale = is_stale();
+    const SignalMask changed = ui_refresh_begin(s_refresh);
+    const FlightSnapshot snap = get_flight_snapshot();
+    const bool stale = is_stale(snap, kDrawnSignals);
     ui_set_stale_overlay(s_screen, s_stale_overlay, stale);
+    // A stale IAS stops changing, so the returns below would keep the last
+    // trend drawn under the cross.
+    if (stale) ui_update_trend(0.0f, true);
+    if (!changed && s_refresh.parked) return; // stale check only
+
+    const float v = get_ias_display(snap);
+    if (changed == kAllSignals) ui_sync_units(v); // unit or polar may have changed
 
-    const float v = get_ias_kmh();
+    if (!changed && asi_settled(v))
+    {
+        set_speed_label((int)v);
+        ui_refresh_idle(s_refresh);
+        return;
+    }
 
     if (s_scale && s_needle)
     {
         ui_update_asi(v);
+        ui_update_trend(get_ias_trend_display_s(snap), stale);
     }
 
     // Update label slower (100 ms) to reduce redraw cost/flicker
@@ -344,10 +483,7 @@ static void ui_update_timer_cb(lv_timer_t* /*t*/)
     if (div >= 5) // 5 * 20ms = 100ms
     {
         div = 0;
-        if (s_label)
-        {
-            lv_label_set_text_fmt(s_label, "%d", (int)v);
-        }
+        set_speed_label((int)v);
     }
 }
 
@@ -356,17 +492,9 @@ void screen1_create()
     ui_create_gauge();
 
     // Initialize states from current value to avoid initial jump
-    float v = get_ias_kmh();
-    if (std::isnan(v) || std::isinf(v)) v = ASI_MIN;
-    v = clampf(v, ASI_MIN, ASI_MAX);
-
-    s_raw_ema = v;
-    s_x = v;
-    s_v = 0.0f;
-    s_last_ms = 0;
+    ui_sync_units(get_ias_display(get_flight_snapshot()));
 
-    // Smooth "instrument-like" needle: 25 Hz
-    lv_timer_create(ui_update_timer_cb, 40, nullptr);
+    ui_refresh_attach(s_refresh, s_screen, ui_update_timer_cb);
 }
 
 lv_obj_t* screen1_get()
@@ -2,9 +2,10 @@
 #include "../ui.h"
 #include "../ui_helpers.hpp"
 #include "flaputils.hpp"
+#include <array>
 #include <cmath>
 #include <cstdint>
-#include <vector>
+#include <span>
 
 #ifndef NATIVE_SIMULATOR
 #include "esp_task_wdt.h"
@@ -28,9 +29,10 @@ static constexpr int32_t NEEDLE_INNER_RADIUS = 130;
 static constexpr int32_t NEEDLE_OUTER_RADIUS = 170;
 static constexpr int32_t ASI_ARC_WIDTH = 20;
 
-/* IAS range */
-static constexpr float ASI_MIN = 40.0f;
-static constexpr float ASI_MAX = 280.0f;
+/* IAS range in the display unit, set by ui_sync_units() on unit change */
+static float s_asi_min = 40.0f;
+static float s_asi_max = 280.0f;
+static uint32_t s_units_gen = 0; // units::generation() of the range
 
 /* Arc ring segments */
 static lv_obj_t* s_seg_arcs[32] = {nullptr};
@@ -40,6 +42,7 @@ static uint32_t s_seg_count = 0;
 static lv_obj_t* s_tick_lines[33] = {nullptr};      // boundaries: 0..count
 static lv_point_precise_t s_tick_pts[33][2];        // NOTE: must match lv_line_set_points signature
 static lv_obj_t* s_labels[32] = {nullptr};          // one per segment
+static std::array<flaputils::FlapSpeedRange, 31> s_params; // bands of the last build
 
 /* Highlight bookkeeping */
 static int32_t s_last_highlight_idx = -9999;
@@ -54,10 +57,11 @@ static const lv_opa_t SEG_OPA_ON = LV_OPA_COVER;
    Same model as screen1: sensor LPF + 2nd-order damped response, with
    stiction + up/down feel differences + wn depends on speed.
 */
-static float s_raw_ema = ASI_MIN;  // filtered sensor target (km/h)
-static float s_x = ASI_MIN;        // displayed speed state (km/h)
-static float s_v = 0.0f;           // displayed needle rate (km/h/s)
+static float s_raw_ema = 40.0f;    // filtered sensor target (display units)
+static float s_x = 40.0f;          // displayed speed state (display units)
+static float s_v = 0.0f;           // displayed needle rate (display units/s)
 static uint32_t s_last_ms = 0;
+static int32_t s_drawn_speed = INT32_MIN; // needle position on screen
 
 /* Sensor filtering */
 static constexpr float SENSOR_TAU_SEC = 0.18f; // 0.12..0.35
@@ -70,9 +74,9 @@ static constexpr float WN_LOW = 4.5f;  // rad/s at low speed
 static constexpr float WN_HIGH = 9.0f; // rad/s at high speed
 
 static constexpr float DECEL_LAG = 1.10f;         // >1 slows decel response
-static constexpr float STICTION_BAND = 0.35f;     // km/h
-static constexpr float MAX_RATE_KMH_PER_SEC = 420.0f;
-static constexpr float MAX_ACCEL_KMH_PER_SEC2 = 2200.0f;
+static constexpr float STICTION_BAND = 0.35f;     // display units
+static constexpr float MAX_RATE_PER_SEC = 420.0f;
+static constexpr float MAX_ACCEL_PER_SEC2 = 2200.0f;
 
 static inline void feed_task_wdt_if_subscribed(void)
 {
@@ -182,8 +186,7 @@ static inline void set_label_rotation_01deg(lv_obj_t* obj, int32_t angle01deg)
 
 /* Forward decl */
 static void draw_variable_scale(lv_obj_t* parent,
-                                const std::vector<flaputils::FlapSpeedRange>& params,
-                                uint32_t count,
+                                std::span<const flaputils::FlapSpeedRange> params,
                                 const float* w,
                                 float w_sum,
                                 int32_t rot_deg,
@@ -192,8 +195,7 @@ static void draw_variable_scale(lv_obj_t* parent,
 
 /* Draw ticks at segment boundaries and labels at segment centers */
 static void draw_variable_scale(lv_obj_t* parent,
-                                const std::vector<flaputils::FlapSpeedRange>& params,
-                                uint32_t count,
+                                std::span<const flaputils::FlapSpeedRange> params,
                                 const float* w,
                                 float w_sum,
                                 int32_t rot_deg,
@@ -214,6 +216,7 @@ static void draw_variable_scale(lv_obj_t* parent,
 
     const int32_t tick_width = 2;
 
+    const uint32_t count = (uint32_t)params.size();
     const int32_t usable_span = span_deg - (int32_t)count * gap_deg;
     const float usable_span_f = (usable_span > 0) ? (float)usable_span : (float)span_deg;
 
@@ -286,8 +289,9 @@ static void draw_variable_scale(lv_obj_t* parent,
             lv_obj_set_style_text_font(lab, &lv_font_montserrat_20, 0);
         }
 
-        const char* sym = flaputils::get_range_symbol_name(params[i].index);
-        lv_label_set_text(lab, sym ? sym : "");
+        char sym[flaputils::kSymbolSize];
+        flaputils::get_range_symbol_name(params[i].index, sym, sizeof(sym));
+        lv_label_set_text(lab, sym);
         lv_obj_remove_flag(lab, LV_OBJ_FLAG_HIDDEN);
 
         const lv_coord_t lw = 40;
@@ -325,8 +329,8 @@ static void ui_set_line_needle_value(lv_obj_t* /*scale_obj*/, lv_obj_t* needle_l
 
     int32_t rotation = 130;
     int32_t angle_range = 280;
-    int32_t min = 40;
-    int32_t max = 280;
+    int32_t min = (int32_t)s_asi_min;
+    int32_t max = (int32_t)s_asi_max;
     int32_t width = 466;
     int32_t height = 466;
 
@@ -350,7 +354,7 @@ static void ui_set_line_needle_value(lv_obj_t* /*scale_obj*/, lv_obj_t* needle_l
 
 /* --------- ASI mechanics step + draw --------- */
 
-static void asi_step_mechanics(float target_kmh)
+static void asi_step_mechanics(float target)
 {
     uint32_t now = lv_tick_get();
     float dt = 0.02f; // expected 50 Hz
@@ -362,44 +366,44 @@ static void asi_step_mechanics(float target_kmh)
     }
     s_last_ms = now;
 
-    target_kmh = clampf(target_kmh, ASI_MIN, ASI_MAX);
+    target = clampf(target, s_asi_min, s_asi_max);
 
-    const float err0 = target_kmh - s_x;
+    const float err0 = target - s_x;
     if (fabsf(err0) < STICTION_BAND && fabsf(s_v) < 2.0f)
     {
-        s_x = target_kmh;
+        s_x = target;
         s_v = 0.0f;
         return;
     }
 
-    const float t = clampf((s_x - ASI_MIN) / (ASI_MAX - ASI_MIN), 0.0f, 1.0f);
+    const float t = clampf((s_x - s_asi_min) / (s_asi_max - s_asi_min), 0.0f, 1.0f);
     float wn = lerpf(WN_LOW, WN_HIGH, t);
 
-    const bool accelerating = (target_kmh > s_x);
+    const bool accelerating = (target > s_x);
     float zeta = accelerating ? ZETA_UP : ZETA_DOWN;
     float lag = accelerating ? 1.0f : DECEL_LAG;
     wn /= lag;
 
-    float a = (wn * wn) * (target_kmh - s_x) - (2.0f * zeta * wn) * s_v;
-    a = clampf(a, -MAX_ACCEL_KMH_PER_SEC2, MAX_ACCEL_KMH_PER_SEC2);
+    float a = (wn * wn) * (target - s_x) - (2.0f * zeta * wn) * s_v;
+    a = clampf(a, -MAX_ACCEL_PER_SEC2, MAX_ACCEL_PER_SEC2);
 
     s_v += a * dt;
-    s_v = clampf(s_v, -MAX_RATE_KMH_PER_SEC, MAX_RATE_KMH_PER_SEC);
+    s_v = clampf(s_v, -MAX_RATE_PER_SEC, MAX_RATE_PER_SEC);
 
     s_x += s_v * dt;
-    s_x = clampf(s_x, ASI_MIN, ASI_MAX);
+    s_x = clampf(s_x, s_asi_min, s_asi_max);
 
-    const float err1 = target_kmh - s_x;
+    const float err1 = target - s_x;
     if ((err0 > 0 && err1 < 0) || (err0 < 0 && err1 > 0))
     {
         s_v *= 0.55f;
     }
 }
 
-static void ui_update_asi(float raw_kmh)
+static void ui_update_asi(float raw)
 {
-    if (std::isnan(raw_kmh) || std::isinf(raw_kmh)) raw_kmh = ASI_MIN;
-    raw_kmh = clampf(raw_kmh, ASI_MIN, ASI_MAX);
+    if (std::isnan(raw) || std::isinf(raw)) raw = s_asi_min;
+    raw = clampf(raw, s_asi_min, s_asi_max);
 
     static uint32_t last_ema_ms = 0;
     uint32_t now = lv_tick_get();
@@ -413,28 +417,58 @@ static void ui_update_asi(float raw_kmh)
     last_ema_ms = now;
 
     const float alpha = dt / (SENSOR_TAU_SEC + dt);
-    s_raw_ema += alpha * (raw_kmh - s_raw_ema);
+    s_raw_ema += alpha * (raw - s_raw_ema);
 
     asi_step_mechanics(s_raw_ema);
 
     const int32_t vi = (int32_t)lroundf(s_x);
+    if (vi == s_drawn_speed) return;
+    s_drawn_speed = vi;
     ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, vi);
 }
 
+// Needle at rest on raw: further steps would not move it.
+static bool asi_settled(float raw)
+{
+    if (std::isnan(raw) || std::isinf(raw)) raw = s_asi_min;
+    return s_v == 0.0f && fabsf(clampf(raw, s_asi_min, s_asi_max) - s_x) < 0.05f;
+}
+
+
+// Needle range in the display unit; work only when the unit changed. The
+// flap segments are sized by band width ratios, which no unit changes, so
+// only the needle follows the unit.
+static void ui_sync_units(float v)
+{
+    if (s_units_gen == units::generation()) return;
+    s_units_gen = units::generation();
+
+    const units::AsiScale& asi = units::speed().asi;
+    s_asi_min = (float)asi.min;
+    s_asi_max = (float)asi.max;
+    lv_scale_set_range(s_scale, asi.min, asi.max);
+
+    // Restart the needle at rest on the current value
+    if (std::isnan(v) || std::isinf(v)) v = s_asi_min;
+    v = clampf(v, s_asi_min, s_asi_max);
+    s_raw_ema = v;
+    s_x = v;
+    s_v = 0.0f;
+    s_last_ms = 0;
+    s_drawn_speed = (int32_t)lroundf(v);
+    ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, s_drawn_speed);
+}
 
 /* ---------- deferred build ---------- */
 
-static void ui_create_screen2_deferred(void)
+static void ui_create_screen2_deferred(float weight)
 {
-    float weight = get_weight_kg();
     if (s_initialized && std::fabs(weight - s_last_weight) < 0.5f) return;
 
-    /* Build labels + segments */
-    auto params = flaputils::get_flap_speed_ranges(weight);
-    if (params.empty()) return;
-
-    uint32_t count = (uint32_t)params.size();
-    if (count > 31) count = 31;
+    /* Build labels + segments; at most 31, the rest do not fit the ring */
+    const uint32_t count = (uint32_t)flaputils::get_flap_speed_ranges(weight, s_params);
+    if (count == 0) return;
+    const std::span<const flaputils::FlapSpeedRange> params(s_params.data(), count);
 
     s_seg_count = count;
     s_last_highlight_idx = -9999;
@@ -522,7 +556,7 @@ static void ui_create_screen2_deferred(void)
         }
     }
 
-    draw_variable_scale(s_arc_container, params, count, w, w_sum, rot, span, gap_deg);
+    draw_variable_scale(s_arc_container, params, w, w_sum, rot, span, gap_deg);
 
     s_initialized = true;
     s_last_weight = weight;
@@ -533,43 +567,68 @@ static void ui_create_screen2_deferred(void)
 
 /* ---------- timer ---------- */
 
+// Signals this screen draws.
+static constexpr SignalMask kDrawnSignals = signal_mask(FlightSignal::Ias, FlightSignal::Flap, FlightSignal::Mass);
+// The ones that raise the stale overlay. Mass is sent only when the ballast
+// changes, so it may never arrive; without it only the target flap is hidden
+// (get_flap_target()).
+static constexpr SignalMask kStaleSignals = signal_mask(FlightSignal::Ias, FlightSignal::Flap);
+
+// 20 Hz tick (50ms) for smooth needle; other UI updates are internally divided down
+static ScreenRefresh s_refresh{kDrawnSignals, 50};
+
 static void ui_update_timer_cb(lv_timer_t* /*t*/)
 {
     // Feeding the watchdog here is safe as this is called from the LVGL task context
     feed_task_wdt_if_subscribed();
 
     if (lv_screen_active() != s_screen) return;
-    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale());
+    const SignalMask changed = ui_refresh_begin(s_refresh);
+    const FlightSnapshot snap = get_flight_snapshot();
+    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale(snap, kStaleSignals));
+    if (!changed && s_refresh.parked) return; // stale check only
+
+    // Nothing new and the needle at rest: bring the divided-down parts up
+    // to date once, then park until the next frame.
+    if (changed == kAllSignals) ui_sync_units(get_ias_display(snap));
+    const bool idle = !changed && asi_settled(get_ias_display(snap));
+    if (changed == kAllSignals)
+    {
+        s_drawn_speed = INT32_MIN;
+        s_last_actual_idx = -9999;
+        s_last_target_idx = -9999;
+    }
 
     /* Do heavy work (weight-dependent rebuild) slower */
     static uint8_t slow_div = 0;
     slow_div++;
-    if (slow_div >= 10) // 10 * 100ms = 1s
+    if (slow_div >= 10 || idle) // 10 * 100ms = 1s
     {
         slow_div = 0;
-        float current_weight = get_weight_kg();
+        float current_weight = get_weight_kg(snap);
         if (!s_initialized || std::fabs(current_weight - s_last_weight) >= 0.5f)
         {
-            ui_create_screen2_deferred();
+            ui_create_screen2_deferred(current_weight);
         }
     }
 
     /* Update flap label/triangles at moderate rate (same as timer: 100ms) */
     static uint8_t mid_div = 0;
     mid_div++;
-    if (mid_div >= 2) // 2 * 100ms = 200ms
+    if (mid_div >= 2 || idle) // 2 * 100ms = 200ms
     {
         mid_div = 0;
 
-        flaputils::FlapSymbolResult actual = get_flap_actual();
-        flaputils::FlapSymbolResult target = get_flap_target();
+        flaputils::FlapSymbolResult actual = get_flap_actual(snap);
+        flaputils::FlapSymbolResult target = get_flap_target(snap);
 
         if (actual.index != s_last_actual_idx)
         {
             if (s_flap_label)
             {
-                const char* sym = flaputils::get_flap_symbol_name(actual.index);
-                lv_label_set_text(s_flap_label, sym ? sym : "-");
+                char sym[flaputils::kSymbolSize];
+                lv_label_set_text(s_flap_label,
+                                  flaputils::get_flap_symbol_name(actual.index, sym, sizeof(sym)) ? sym : "-");
             }
             s_last_actual_idx = actual.index;
         }
@@ -600,10 +659,16 @@ static void ui_update_timer_cb(lv_timer_t* /*t*/)
         }
     }
 
+    if (idle)
+    {
+        ui_refresh_idle(s_refresh);
+        return;
+    }
+
     /* Needle: smooth at full rate (100ms) - only update if visible */
     if (s_scale && s_needle && lv_screen_active() == s_screen)
     {
-        ui_update_asi(get_ias_kmh());
+        ui_update_asi(get_ias_display(snap));
     }
 }
 
@@ -633,13 +698,12 @@ static void ui_create_screen2()
     lv_obj_set_style_border_width(s_arc_container, 0, 0);
     lv_obj_set_style_pad_all(s_arc_container, 0, 0);
 
-    // Round inner scale 40..280 km/h (needle only)
+    // Round inner scale (needle only), range set by ui_sync_units()
     s_scale = lv_scale_create(s_screen);
     lv_obj_set_size(s_scale, 466, 466);
     lv_obj_center(s_scale);
 
     lv_scale_set_mode(s_scale, LV_SCALE_MODE_ROUND_INNER);
-    lv_scale_set_range(s_scale, (int32_t)ASI_MIN, (int32_t)ASI_MAX);
     lv_scale_set_total_tick_count(s_scale, 11); // Hide ticks
     lv_scale_set_major_tick_every(s_scale, 5);
     lv_obj_set_style_line_width(s_scale, 0, LV_PART_ITEMS);
@@ -657,8 +721,6 @@ static void ui_create_screen2()
     lv_obj_set_style_line_color(s_needle, lv_color_white(), 0);
     lv_obj_set_style_line_rounded(s_needle, true, 0);
 
-    // Initial position (min)
-    ui_set_line_needle_value(s_scale, s_needle, NEEDLE_INNER_RADIUS, NEEDLE_OUTER_RADIUS, (int32_t)ASI_MIN);
 
     /* Title */
     lv_obj_t* title = lv_label_create(s_screen);
@@ -718,25 +780,19 @@ static void ui_create_screen2()
     lv_obj_add_flag(s_triangle_up_canvas, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(s_triangle_down_canvas, LV_OBJ_FLAG_HIDDEN);
     s_stale_overlay = {};
+    s_units_gen = 0;
 }
 
 void screen2_create()
 {
+    const FlightSnapshot snap = get_flight_snapshot();
     ui_create_screen2();
-    ui_create_screen2_deferred();
+    ui_create_screen2_deferred(get_weight_kg(snap));
 
     // Init needle dynamics to current IAS to avoid a jump
-    float v = get_ias_kmh();
-    if (std::isnan(v) || std::isinf(v)) v = ASI_MIN;
-    v = clampf(v, ASI_MIN, ASI_MAX);
-
-    s_raw_ema = v;
-    s_x = v;
-    s_v = 0.0f;
-    s_last_ms = 0;
+    ui_sync_units(get_ias_display(snap));
 
-    // 20 Hz tick (50ms) for smooth needle; other UI updates are internally divided down
-    lv_timer_create(ui_update_timer_cb, 50, nullptr);
+    ui_refresh_attach(s_refresh, s_screen, ui_update_timer_cb);
 }
 
 lv_obj_t* screen2_get()
@@ -1,8 +1,46 @@
 #include "lvgl.h"
 #include "../../platform/ui_platform.hpp"
+#include "units.hpp"
 extern const lv_font_t digits_120;
 
 static lv_obj_t* s_screen = nullptr;
+static lv_obj_t* s_units_label = nullptr;
+
+// Unit combinations offered by the units button, in cycling order.
+struct UnitPreset
+{
+    units::SpeedUnit speed;
+    units::AltitudeUnit altitude;
+};
+
+static constexpr UnitPreset kUnitPresets[] = {
+    {units::SpeedUnit::Kmh, units::AltitudeUnit::Meter},
+    {units::SpeedUnit::Knots, units::AltitudeUnit::Feet},
+    {units::SpeedUnit::Knots, units::AltitudeUnit::Meter},
+    {units::SpeedUnit::Mph, units::AltitudeUnit::Feet},
+};
+static constexpr int kUnitPresetCount = sizeof(kUnitPresets) / sizeof(kUnitPresets[0]);
+
+static void units_label_update()
+{
+    lv_label_set_text_fmt(s_units_label, "%s  %s", units::speed().label, units::altitude().label);
+}
+
+static void units_event_cb(lv_event_t* e)
+{
+    int next = 0;
+    for (int i = 0; i < kUnitPresetCount; ++i)
+    {
+        if (kUnitPresets[i].speed == units::speed().unit && kUnitPresets[i].altitude == units::altitude().unit)
+        {
+            next = (i + 1) % kUnitPresetCount;
+            break;
+        }
+    }
+    units::set(kUnitPresets[next].speed, kUnitPresets[next].altitude);
+    units::save();
+    units_label_update();
+}
 
 static void brightness_plus_event_cb(lv_event_t* e)
 {
@@ -39,6 +77,17 @@ static void ui_create_screen3()
     lv_obj_set_style_text_font(brightness_label, &lv_font_montserrat_20, 0);
     lv_obj_align(brightness_label, LV_ALIGN_CENTER, 0, -110);
 
+    // Units button: cycles through kUnitPresets
+    lv_obj_t* btn_units = lv_btn_create(s_screen);
+    lv_obj_set_size(btn_units, 180, 56);
+    lv_obj_align(btn_units, LV_ALIGN_TOP_MID, 0, 40);
+    lv_obj_add_event_cb(btn_units, units_event_cb, LV_EVENT_CLICKED, nullptr);
+
+    s_units_label = lv_label_create(btn_units);
+    lv_obj_set_style_text_font(s_units_label, &lv_font_montserrat_20, 0);
+    lv_obj_center(s_units_label);
+    units_label_update();
+
     // Plus Button
     lv_obj_t* btn_plus = lv_btn_create(s_screen);
     lv_obj_set_size(btn_plus, 120, 120);
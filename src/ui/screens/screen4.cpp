@@ -14,57 +14,90 @@ static lv_obj_t* s_label_alt = nullptr;
 static lv_obj_t* s_label_heading = nullptr;
 static lv_obj_t* s_label_wind = nullptr;
 static lv_obj_t* s_label_gps_ground_speed = nullptr;
-static lv_obj_t* s_label_gps_true_track = nullptr;
+static lv_obj_t* s_label_home = nullptr;
 static lv_obj_t* s_label_polar = nullptr;
+static lv_obj_t* s_label_can = nullptr;
 static StaleOverlayState s_stale_overlay;
 
 
+// Signals this screen draws.
+static constexpr SignalMask kDrawnSignals =
+    signal_mask(FlightSignal::Ias, FlightSignal::Mass, FlightSignal::Flap, FlightSignal::Alt, FlightSignal::Heading,
+                FlightSignal::WindSpeed, FlightSignal::WindDirection, FlightSignal::GpsGroundSpeed,
+                FlightSignal::GpsTrueTrack);
+// The ones that raise the stale overlay: all but Mass, which is sent only
+// when the ballast changes.
+static constexpr SignalMask kStaleSignals = kDrawnSignals & ~signal_mask(FlightSignal::Mass);
+
+// Polar and CAN bus health are not flight signals, so this screen keeps its
+// 2 Hz tick while shown and never parks; it is only paused while hidden.
+static ScreenRefresh s_refresh{kDrawnSignals, 500};
+
 static void ui_update_timer_cb(lv_timer_t* timer)
 {
     if (!s_screen || lv_screen_active() != s_screen) return;
-    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale());
+    ui_refresh_begin(s_refresh);
+    const FlightSnapshot snap = get_flight_snapshot();
+    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale(snap, kStaleSignals));
 
     char buf[64];
 
     // IAS
-    snprintf(buf, sizeof(buf), "IAS: %.0f km/h", get_ias_kmh());
+    const char* speed_unit = units::speed().label;
+    snprintf(buf, sizeof(buf), "IAS: %.0f %s", get_ias_display(snap), speed_unit);
     lv_label_set_text(s_label_ias, buf);
 
     // Weight
-    snprintf(buf, sizeof(buf), "Weight: %.0f kg", get_weight_kg());
+    snprintf(buf, sizeof(buf), "Weight: %.0f kg", get_weight_kg(snap));
     lv_label_set_text(s_label_weight, buf);
 
     // Flap Actual
-    flaputils::FlapSymbolResult actual = get_flap_actual();
-    const char* actual_name = flaputils::get_flap_symbol_name(actual.index);
-    snprintf(buf, sizeof(buf), "Flap Actual: %s (%d)", actual_name ? actual_name : "---", actual.index);
+    flaputils::FlapSymbolResult actual = get_flap_actual(snap);
+    char actual_name[flaputils::kSymbolSize];
+    if (!flaputils::get_flap_symbol_name(actual.index, actual_name, sizeof(actual_name)))
+        snprintf(actual_name, sizeof(actual_name), "---");
+    snprintf(buf, sizeof(buf), "Flap Actual: %s (%d)", actual_name, actual.index);
     lv_label_set_text(s_label_flap_actual, buf);
 
     // Flap Target
-    flaputils::FlapSymbolResult target = get_flap_target();
-    const char* target_name = flaputils::get_flap_symbol_name(target.index);
-    snprintf(buf, sizeof(buf), "Flap Target: %s (%d)", target_name ? target_name : "---", target.index);
+    flaputils::FlapSymbolResult target = get_flap_target(snap);
+    char target_name[flaputils::kSymbolSize];
+    if (!flaputils::get_flap_symbol_name(target.index, target_name, sizeof(target_name)))
+        snprintf(target_name, sizeof(target_name), "---");
+    snprintf(buf, sizeof(buf), "Flap Target: %s (%d)", target_name, target.index);
     lv_label_set_text(s_label_flap_target, buf);
 
     // Alt
-    snprintf(buf, sizeof(buf), "Alt: %.0f m", get_alt_m());
+    snprintf(buf, sizeof(buf), "Alt: %.0f %s", get_alt_display(snap), units::altitude().label);
     lv_label_set_text(s_label_alt, buf);
 
     // Heading
-    snprintf(buf, sizeof(buf), "HDG: %.0f deg", get_heading());
+    snprintf(buf, sizeof(buf), "HDG: %.0f deg", get_heading(snap));
     lv_label_set_text(s_label_heading, buf);
 
     // Wind
-    snprintf(buf, sizeof(buf), "Wind: %.0f km/h @ %.0f deg", get_wind_speed_kmh(), get_wind_direction());
+    const char* wind_tag = get_wind_source_tag(snap);
+    if (*wind_tag)
+        snprintf(buf, sizeof(buf), "Wind: %.0f %s @ %.0f deg (%s %u%%)", get_wind_speed_display(snap), speed_unit,
+                 get_wind_direction(snap), wind_tag, snap.wind_quality);
+    else
+        snprintf(buf, sizeof(buf), "Wind: %.0f %s @ %.0f deg", get_wind_speed_display(snap), speed_unit,
+                 get_wind_direction(snap));
     lv_label_set_text(s_label_wind, buf);
 
-    // GPS Ground Speed
-    snprintf(buf, sizeof(buf), "GS: %.0f km/h", get_gps_ground_speed_kmh());
+    // GPS Ground Speed and True Track
+    snprintf(buf, sizeof(buf), "GS: %.0f %s TRK: %.0f deg", get_gps_ground_speed_display(snap), speed_unit,
+             get_gps_true_track(snap));
     lv_label_set_text(s_label_gps_ground_speed, buf);
 
-    // GPS True Track
-    snprintf(buf, sizeof(buf), "TRK: %.0f deg", get_gps_true_track());
-    lv_label_set_text(s_label_gps_true_track, buf);
+    // Home
+    float home_distance, home_bearing;
+    if (get_home_display(snap, home_distance, home_bearing))
+        snprintf(buf, sizeof(buf), "Home: %.1f %s @ %.0f deg", home_distance, units::speed().distance_label,
+                 home_bearing);
+    else
+        snprintf(buf, sizeof(buf), "Home: ---");
+    lv_label_set_text(s_label_home, buf);
 
     // Polar
     std::string polar_name = flaputils::get_polar();
@@ -74,6 +107,12 @@ static void ui_update_timer_cb(lv_timer_t* timer)
     }
     snprintf(buf, sizeof(buf), "Polar: %s", polar_name.c_str());
     lv_label_set_text(s_label_polar, buf);
+
+    // CAN bus health
+    const CanBusHealth can = get_can_bus_health();
+    snprintf(buf, sizeof(buf), "CAN: %s %u.%u%% BO:%lu", CanBusHealth::state_name(can.state),
+             can.rx_load_permille / 10, can.rx_load_permille % 10, static_cast<unsigned long>(can.bus_off_events));
+    lv_label_set_text(s_label_can, buf);
 }
 
 void screen4_create()
@@ -128,19 +167,24 @@ void screen4_create()
     lv_obj_set_style_text_font(s_label_gps_ground_speed, &lv_font_montserrat_20, 0);
     lv_obj_align(s_label_gps_ground_speed, LV_ALIGN_TOP_MID, 0, 290);
 
-    s_label_gps_true_track = lv_label_create(s_screen);
-    lv_obj_set_style_text_color(s_label_gps_true_track, lv_color_white(), 0);
-    lv_obj_set_style_text_font(s_label_gps_true_track, &lv_font_montserrat_20, 0);
-    lv_obj_align(s_label_gps_true_track, LV_ALIGN_TOP_MID, 0, 330);
+    s_label_home = lv_label_create(s_screen);
+    lv_obj_set_style_text_color(s_label_home, lv_color_white(), 0);
+    lv_obj_set_style_text_font(s_label_home, &lv_font_montserrat_20, 0);
+    lv_obj_align(s_label_home, LV_ALIGN_TOP_MID, 0, 330);
 
     s_label_polar = lv_label_create(s_screen);
     lv_obj_set_style_text_color(s_label_polar, lv_color_white(), 0);
     lv_obj_set_style_text_font(s_label_polar, &lv_font_montserrat_20, 0);
     lv_obj_align(s_label_polar, LV_ALIGN_TOP_MID, 0, 370);
 
+    s_label_can = lv_label_create(s_screen);
+    lv_obj_set_style_text_color(s_label_can, lv_color_white(), 0);
+    lv_obj_set_style_text_font(s_label_can, &lv_font_montserrat_16, 0);
+    lv_obj_align(s_label_can, LV_ALIGN_TOP_MID, 0, 405);
+
     s_stale_overlay = {};
 
-    lv_timer_create(ui_update_timer_cb, 500, nullptr);
+    ui_refresh_attach(s_refresh, s_screen, ui_update_timer_cb);
 }
 
 lv_obj_t* screen4_get()
@@ -8,9 +8,7 @@
 
 #define TAPE_WIDTH     200
 #define TAPE_HEIGHT    400
-#define PIXELS_PER_M   2.0f     // scaling (adjust!)
-#define MAJOR_STEP     100      // major tick (m)
-#define MINOR_STEP     10       // minor tick (m)
+// Tick steps and scaling come from the altitude unit (units.hpp).
 
 /* ================= STATE ================= */
 
@@ -21,7 +19,9 @@ static lv_obj_t* s_alt_baro_label = nullptr;
 static lv_obj_t* s_unit_label = nullptr;
 static StaleOverlayState s_stale_overlay;
 
-static float s_alt_filtered = 0;
+static float s_alt_filtered = 0; // display units
+static units::AltitudeTape s_tape_steps = units::altitude().tape;
+static uint32_t s_units_gen = 0;  // units::generation() of s_tape_steps
 
 /* ================= DRAW EVENT ================= */
 
@@ -36,18 +36,20 @@ static void tape_draw_event(lv_event_t* e)
     int center_y = (coords.y1 + coords.y2) / 2;
 
     float alt = s_alt_filtered;
+    const int minor_step = s_tape_steps.minor_step;
+    const int span = 5 * s_tape_steps.major_step;
 
-    /* find base altitude aligned to MINOR_STEP */
-    int base_alt = ((int)alt / MINOR_STEP) * MINOR_STEP;
+    /* find base altitude aligned to the minor step */
+    int base_alt = ((int)alt / minor_step) * minor_step;
 
-    for (int a = base_alt - 500; a <= base_alt + 500; a += MINOR_STEP)
+    for (int a = base_alt - span; a <= base_alt + span; a += minor_step)
     {
-        float dy = (alt - a) * PIXELS_PER_M;
+        float dy = (alt - a) * s_tape_steps.pixels_per_unit;
         int y = center_y + (int)dy;
 
         if (y < coords.y1 || y > coords.y2) continue;
 
-        bool major = (a % MAJOR_STEP == 0);
+        bool major = (a % s_tape_steps.major_step == 0);
 
         int line_len = major ? 30 : 15;
 
@@ -102,11 +104,6 @@ static void update_altitude(float alt)
         snprintf(buf, sizeof(buf), "%.0f", s_alt_filtered);
         lv_label_set_text(s_alt_baro_label, buf);
     }
-    if (s_unit_label)
-    {
-        lv_label_set_text(s_unit_label, "m");
-    }
-
     lv_obj_invalidate(s_tape);
 }
 
@@ -122,12 +119,37 @@ static inline void make_noninteractive(lv_obj_t* o)
 
 /* ================= TIMER ================= */
 
+// Signals this screen draws; only these raise the stale overlay.
+static constexpr SignalMask kDrawnSignals = signal_mask(FlightSignal::Alt);
+
+static ScreenRefresh s_refresh{kDrawnSignals, 33};
+
 static void ui_update_timer_cb(lv_timer_t* timer)
 {
     if (!s_screen || lv_screen_active() != s_screen) return;
 
-    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale());
-    update_altitude(get_alt_m());
+    const SignalMask changed = ui_refresh_begin(s_refresh);
+    const FlightSnapshot snap = get_flight_snapshot();
+    ui_set_stale_overlay(s_screen, s_stale_overlay, is_stale(snap, kDrawnSignals));
+    if (!changed && s_refresh.parked) return; // stale check only
+
+    // Units only change in Settings, so a reload is the time to pick them up.
+    if (changed == kAllSignals && s_units_gen != units::generation())
+    {
+        s_units_gen = units::generation();
+        s_tape_steps = units::altitude().tape;
+        s_alt_filtered = get_alt_display(snap);
+        lv_label_set_text(s_unit_label, units::altitude().label);
+    }
+
+    const float alt = get_alt_display(snap);
+    // The filter has caught up to well under a pixel: nothing left to draw.
+    if (!changed && std::fabs(alt - s_alt_filtered) < 0.05f)
+    {
+        ui_refresh_idle(s_refresh);
+        return;
+    }
+    update_altitude(alt);
 }
 
 /* ================= SCREEN ================= */
@@ -184,7 +206,7 @@ void screen5_create()
 
     s_stale_overlay = {};
 
-    lv_timer_create(ui_update_timer_cb, 33, NULL);
+    ui_refresh_attach(s_refresh, s_screen, ui_update_timer_cb);
 }
 
 /* ================= GETTER ================= */
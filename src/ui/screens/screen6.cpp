@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstdint>
 #include "lvgl.h"
 #include "../ui.h"
 #include "../ui_helpers.hpp"
@@ -15,6 +16,8 @@ static lv_obj_t* s_screen = nullptr;
 static lv_obj_t* s_scale = nullptr;
 static lv_obj_t* s_needle = nullptr;
 static lv_obj_t* s_label = nullptr;
+static lv_obj_t* s_unit_label = nullptr;
+static uint32_t s_units_gen = 0; // units::generation() of the unit label
 static lv_obj_t* s_inner_circle = nullptr;
 static StaleOverlayState s_stale_overlay;
 
@@ -88,7 +91,7 @@ static void ui_set_needle_value(lv_obj_t* scale_obj,
                                 const int32_t inner_length,
                                 const int32_t outer_length,
                                 int32_t value,
-                                float wind_speed)
+                                float wind_ms)
 {
     lv_obj_align(needle_obj, LV_ALIGN_TOP_LEFT, 0, 0);
 
@@ -111,7 +114,7 @@ static void ui_set_needle_value(lv_obj_t* scale_obj,
     /* ===== Improved arrow geometry, scaled by wind speed ===== */
     // Base dimensions for a wind speed of 20 km/h (approx)
     // We'll scale from 0.4x (at 0 km/h) to 2.5x (at 100 km/h)
-    float scale = 0.4f + (wind_speed / 40.0f); // 20 km/h is 0.9x, 40 km/h is 1.4x, etc.
+    float scale = 0.4f + (wind_ms * 3.6f / 40.0f); // 20 km/h is 0.9x, 40 km/h is 1.4x, etc.
     if (scale < 0.4f) scale = 0.4f;
     if (scale > 2.5f) scale = 2.5f;
 
@@ -204,11 +207,12 @@ static void ui_create_gauge()
     lv_obj_center(s_label);
 
     /* Unit */
-    lv_obj_t* unit = lv_label_create(s_screen);
-    lv_obj_set_style_text_color(unit, lv_color_white(), 0);
-    lv_obj_set_style_text_font(unit, &lv_font_montserrat_16, 0);
-    lv_label_set_text(unit, "km/h");
-    lv_obj_align(unit, LV_ALIGN_CENTER, 0, 80);
+    s_unit_label = lv_label_create(s_screen);
+    lv_obj_set_style_text_color(s_unit_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(s_unit_label, &lv_font_montserrat_16, 0);
+    lv_label_set_text(s_unit_label, units::speed().label);
+    lv_obj_align(s_unit_label, LV_ALIGN_CENTER, 0, 80);
+    s_units_gen = units::generation();
 
     /* Title */
     lv_obj_t* title = lv_label_create(s_screen);
@@ -230,16 +234,31 @@ static void ui_create_gauge()
 }
 
 /* ================= TIMER ================= */
+// Signals this screen draws; only these raise the stale overlay.
+static constexpr SignalMask kDrawnSignals = signal_mask(FlightSignal::WindSpeed, FlightSignal::WindDirection, FlightSignal::Heading);
+
+static ScreenRefresh s_refresh{kDrawnSignals, 40};
+
 static void ui_update_timer_cb(lv_timer_t*)
 {
     if (lv_screen_active() != s_screen) return;
 
-    const bool stale = is_stale();
+    const SignalMask changed = ui_refresh_begin(s_refresh);
+    const FlightSnapshot snap = get_flight_snapshot();
+    const bool stale = is_stale(snap, kDrawnSignals);
     ui_set_stale_overlay(s_screen, s_stale_overlay, stale);
+    if (!changed && s_refresh.parked) return; // stale check only
 
-    float wind_speed = get_wind_speed_kmh();
-    float wind_dir = get_wind_direction();
-    float heading = get_heading();
+    // Units only change in Settings, so a reload is the time to pick them up.
+    if (changed == kAllSignals && s_units_gen != units::generation())
+    {
+        s_units_gen = units::generation();
+        lv_label_set_text(s_unit_label, units::speed().label);
+    }
+
+    float wind_speed = get_wind_speed_display(snap);
+    float wind_dir = get_wind_direction(snap);
+    float heading = get_heading(snap);
 
     float rel_dir = wind_dir - heading + 180.0f;
     while (rel_dir > 180.0f) rel_dir -= 360.0f;
@@ -247,6 +266,24 @@ static void ui_update_timer_cb(lv_timer_t*)
 
     static float s_smoothed_rel_dir = 0.0f;
     static bool s_first_run = true;
+    static int32_t s_drawn_dir = INT32_MIN;
+    static int32_t s_drawn_speed = INT32_MIN;
+
+    float pending = rel_dir - s_smoothed_rel_dir;
+    while (pending > 180.0f) pending -= 360.0f;
+    while (pending < -180.0f) pending += 360.0f;
+    if (!changed && !s_first_run && std::fabs(pending) < 0.5f)
+    {
+        // Needle has caught up and no new wind or heading: park.
+        const int32_t speed = (int32_t)lroundf(wind_speed);
+        if (speed != s_drawn_speed)
+        {
+            s_drawn_speed = speed;
+            lv_label_set_text_fmt(s_label, "%d", (int)speed);
+        }
+        ui_refresh_idle(s_refresh);
+        return;
+    }
 
     if (s_first_run)
     {
@@ -265,17 +302,23 @@ static void ui_update_timer_cb(lv_timer_t*)
         while (s_smoothed_rel_dir < -180.0f) s_smoothed_rel_dir += 360.0f;
     }
 
-    ui_set_needle_value(s_scale, s_needle,
-                        NEEDLE_INNER_RADIUS,
-                        NEEDLE_OUTER_RADIUS,
-                        (int32_t)lroundf(s_smoothed_rel_dir),
-                        wind_speed);
+    const int32_t dir = (int32_t)lroundf(s_smoothed_rel_dir);
+    if (changed || dir != s_drawn_dir)
+    {
+        s_drawn_dir = dir;
+        ui_set_needle_value(s_scale, s_needle,
+                            NEEDLE_INNER_RADIUS,
+                            NEEDLE_OUTER_RADIUS,
+                            dir,
+                            snap.wind_speed);
+    }
 
     static uint8_t div = 0;
     if (++div >= 5)
     {
         div = 0;
-        lv_label_set_text_fmt(s_label, "%d", (int)lroundf(wind_speed));
+        s_drawn_speed = (int32_t)lroundf(wind_speed);
+        lv_label_set_text_fmt(s_label, "%d", (int)s_drawn_speed);
     }
 }
 
@@ -283,7 +326,7 @@ static void ui_update_timer_cb(lv_timer_t*)
 void screen6_create()
 {
     ui_create_gauge();
-    lv_timer_create(ui_update_timer_cb, 40, nullptr);
+    ui_refresh_attach(s_refresh, s_screen, ui_update_timer_cb);
 }
 
 lv_obj_t* screen6_get()
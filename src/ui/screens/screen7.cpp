@@ -2,16 +2,33 @@
 #include "../ui.h"
 #include "../ui_helpers.hpp"
 #include "../../flaputils.hpp"
+#include "../../polar_loader.hpp"
 #include <dirent.h>
 #include <string>
 #include <vector>
 
 static lv_obj_t* s_screen = nullptr;
 static lv_obj_t* s_roller = nullptr;
+static lv_obj_t* s_spinner = nullptr;
+static lv_obj_t* s_result = nullptr;
+// Polls the loader while a request of ours is in flight.
+static lv_timer_t* s_poll = nullptr;
+static uint32_t s_pending = 0;
+// File names behind the roller rows; a polar may be .json or .fpol.
+static std::vector<std::string> s_files;
+
+static bool is_polar_file(const std::string& filename)
+{
+    const size_t last_dot = filename.find_last_of('.');
+    if (last_dot == std::string::npos) return false;
+    const std::string ext = filename.substr(last_dot);
+    return ext == ".json" || ext == ".fpol";
+}
 
 static std::string get_spiffs_file_list()
 {
     std::string file_list;
+    s_files.clear();
 #ifdef NATIVE_TEST_BUILD
     const char* path = "spiffs_data";
 #else
@@ -25,14 +42,16 @@ static std::string get_spiffs_file_list()
     struct dirent* ent;
     while ((ent = readdir(dir)) != nullptr) {
         if (ent->d_name[0] == '.') continue;
-        if (ent->d_type == DT_REG) {
+        if (ent->d_type == DT_REG && is_polar_file(ent->d_name)) {
+            s_files.push_back(ent->d_name);
             if (!file_list.empty()) {
                 file_list += "\n";
             }
+            // JSON polars show without extension, as before; a .fpol keeps
+            // it so it can be told apart from its source.
             std::string filename = ent->d_name;
-            size_t last_dot = filename.find_last_of('.');
-            if (last_dot != std::string::npos) {
-                filename = filename.substr(0, last_dot);
+            if (filename.size() > 5 && filename.compare(filename.size() - 5, 5, ".json") == 0) {
+                filename.resize(filename.size() - 5);
             }
             file_list += filename;
         }
@@ -45,24 +64,52 @@ static std::string get_spiffs_file_list()
     return file_list;
 }
 
+static void show_result(const char* text, lv_color_t color)
+{
+    lv_label_set_text(s_result, text);
+    lv_obj_set_style_text_color(s_result, color, 0);
+    lv_obj_add_flag(s_spinner, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void poll_timer_cb(lv_timer_t* /*t*/)
+{
+    const polar_loader::Status st = polar_loader::status();
+    if (st.request != s_pending) return;
+    if (st.state == polar_loader::State::Loaded) {
+        show_result(flaputils::get_polar().c_str(), lv_color_hex(0x00C000));
+    } else if (st.state == polar_loader::State::Failed) {
+        show_result("Load failed", lv_color_hex(0xE00000));
+    } else {
+        return;
+    }
+    s_pending = 0;
+    lv_timer_pause(s_poll);
+}
+
+// Only queues the load: reading, parsing and the NVS commit happen on the
+// loader task, so the needles keep moving meanwhile.
 static void select_event_cb(lv_event_t* e)
 {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_CLICKED) {
-        char buf[256];
-        lv_roller_get_selected_str(s_roller, buf, sizeof(buf));
-        std::string filename = buf;
-        if (filename != "No SPIFFS" && filename != "Empty") {
+        const uint32_t selected = lv_roller_get_selected(s_roller);
+        if (selected < s_files.size()) {
             std::string path;
 #ifdef NATIVE_TEST_BUILD
             path = "spiffs_data/";
 #else
             path = "/spiffs/";
 #endif
-            path += filename + ".json";
-            if (flaputils::load_data(path.c_str())) {
-                flaputils::save_polar_path(path.c_str());
+            path += s_files[selected];
+            s_pending = polar_loader::request(path.c_str());
+            if (s_pending == 0) {
+                show_result("Load failed", lv_color_hex(0xE00000));
+                return;
             }
+            lv_label_set_text(s_result, "Loading...");
+            lv_obj_set_style_text_color(s_result, lv_color_white(), 0);
+            lv_obj_remove_flag(s_spinner, LV_OBJ_FLAG_HIDDEN);
+            lv_timer_resume(s_poll);
         }
     }
 }
@@ -104,6 +151,23 @@ static void ui_create_polar()
     lv_obj_t* label = lv_label_create(btn);
     lv_label_set_text(label, "Select");
     lv_obj_center(label);
+
+    /* Load progress and result */
+    s_spinner = lv_spinner_create(s_screen);
+    lv_spinner_set_anim_params(s_spinner, 1000, 200);
+    lv_obj_set_size(s_spinner, 40, 40);
+    lv_obj_align(s_spinner, LV_ALIGN_TOP_MID, 0, 40);
+    lv_obj_add_flag(s_spinner, LV_OBJ_FLAG_HIDDEN);
+
+    s_result = lv_label_create(s_screen);
+    lv_label_set_text(s_result, "");
+    lv_obj_set_style_text_font(s_result, &lv_font_montserrat_20, 0);
+    lv_obj_set_width(s_result, LV_PCT(100));
+    lv_obj_set_style_text_align(s_result, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(s_result, LV_ALIGN_TOP_MID, 0, 90);
+
+    s_poll = lv_timer_create(poll_timer_cb, 100, nullptr);
+    lv_timer_pause(s_poll);
 }
 
 void screen7_create()
@@ -1,4 +1,5 @@
 #include "ui.h"
+#include "ui_helpers.hpp"
 #include "lvgl.h"
 #include "screens/screen1.hpp"
 #include "screens/screen2.hpp"
@@ -8,6 +9,7 @@
 #include "screens/screen6.hpp"
 #include "screens/screen7.hpp"
 #include "../platform/ui_platform.hpp"
+#include <atomic>
 
 #ifdef NATIVE_SIMULATOR
 #include <cstdio>
@@ -20,6 +22,88 @@ static lv_obj_t* s_label2 = nullptr;
 static lv_obj_t* s_label3 = nullptr;
 static lv_obj_t* s_label4 = nullptr;
 
+// Screen refresh parking. s_parked is only touched on the LVGL task;
+// s_wake_armed hands the wake-up over from the CAN ingest thread.
+static ScreenRefresh* s_parked = nullptr;
+static std::atomic<bool> s_wake_armed{false};
+
+// run_now: tick right away (woken from outside the timer callback).
+static void refresh_unpark(ScreenRefresh& r, bool run_now)
+{
+    r.parked = false;
+    if (s_parked == &r)
+    {
+        s_parked = nullptr;
+        s_wake_armed.store(false);
+    }
+    lv_timer_set_period(r.timer, r.period_ms);
+    if (run_now) lv_timer_ready(r.timer);
+}
+
+static void refresh_wake_handler()
+{
+    if (s_parked) refresh_unpark(*s_parked, true);
+}
+
+static void refresh_screen_event_cb(lv_event_t* e)
+{
+    auto* r = static_cast<ScreenRefresh*>(lv_event_get_user_data(e));
+    if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOAD_START)
+    {
+        r->reload = true;
+        lv_timer_resume(r->timer);
+        refresh_unpark(*r, true);
+    }
+    else
+    {
+        if (s_parked == r)
+        {
+            s_parked = nullptr;
+            s_wake_armed.store(false);
+        }
+        r->parked = false;
+        lv_timer_pause(r->timer);
+    }
+}
+
+void ui_refresh_attach(ScreenRefresh& r, lv_obj_t* screen, lv_timer_cb_t cb)
+{
+    r.timer = lv_timer_create(cb, r.period_ms, &r);
+    lv_timer_pause(r.timer);
+    lv_obj_add_event_cb(screen, refresh_screen_event_cb, LV_EVENT_SCREEN_LOAD_START, &r);
+    lv_obj_add_event_cb(screen, refresh_screen_event_cb, LV_EVENT_SCREEN_UNLOAD_START, &r);
+}
+
+SignalMask ui_refresh_begin(ScreenRefresh& r)
+{
+    const SignalMask changed = take_flight_changes(r.signals);
+    if (r.reload)
+    {
+        r.reload = false;
+        return kAllSignals;
+    }
+    // A stale-check tick can see data before the wake-up does.
+    if (changed && r.parked) refresh_unpark(r, false);
+    return changed;
+}
+
+void ui_refresh_idle(ScreenRefresh& r)
+{
+    if (r.parked) return;
+    r.parked = true;
+    s_parked = &r;
+    lv_timer_set_period(r.timer, ScreenRefresh::kParkedPeriodMs);
+    watch_flight_changes(r.signals);
+    s_wake_armed.store(true);
+    // A publish between the last take and arming found the wake-up disarmed.
+    if (peek_flight_changes(r.signals)) refresh_unpark(r, true);
+}
+
+void ui_flight_data_changed()
+{
+    if (s_wake_armed.exchange(false)) ui_platform_wake();
+}
+
 void set_label1(const char* text)
 {
     if (ui_platform_lock(-1))
@@ -62,6 +146,7 @@ void ui_init()
     {
         return;
     }
+    ui_platform_set_wake_handler(refresh_wake_handler);
 
     if (ui_platform_lock(-1))
     {
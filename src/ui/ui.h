@@ -1,6 +1,9 @@
 #pragma once
 
+#include "can_bus_health.hpp"
 #include "flaputils.hpp"
+#include "flight_data.hpp"
+#include "signal_history.hpp"
 
 void ui_init();
 void set_label1(const char* text);
@@ -8,15 +11,16 @@ void set_label2(const char* text);
 void set_label3(const char* text);
 void set_label4(const char* text);
 
-// Global data access wrappers
-float get_ias_kmh();
-float get_weight_kg();
-float get_alt_m();
-float get_heading();
-float get_wind_speed_kmh();
-float get_wind_direction();
-float get_gps_ground_speed_kmh();
-float get_gps_true_track();
-flaputils::FlapSymbolResult get_flap_actual();
-flaputils::FlapSymbolResult get_flap_target();
-bool is_stale();
+// Consistent copy of the global flight state; screens take one per tick.
+FlightSnapshot get_flight_snapshot();
+// Change notification on the global flight state (FlightData::take_changes(),
+// peek_changes() and watch()).
+SignalMask take_flight_changes(SignalMask signals);
+SignalMask peek_flight_changes(SignalMask signals);
+void watch_flight_changes(SignalMask signals);
+// FlightData change listener: wakes the UI task if the visible screen is
+// parked waiting for data. Safe from any thread.
+void ui_flight_data_changed();
+// Five-minute statistics of a FlightHistory signal (zero count if untracked).
+SignalStats get_signal_stats(FlightSignal signal);
+CanBusHealth get_can_bus_health();
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "flight_data.hpp"
+#include "flight_codec.hpp"
 #include "flaputils.hpp"
+#include "geo.hpp"
+#include "units.hpp"
 #include "lvgl.h"
 #include <cstdio>
 
@@ -45,80 +48,151 @@ inline void ui_set_stale_overlay(lv_obj_t* parent, StaleOverlayState& state, boo
     if (state.cross_b) lv_obj_add_flag(state.cross_b, LV_OBJ_FLAG_HIDDEN);
 }
 
-inline float get_ias_kmh(const FlightData& state)
+// Change-driven screen timer. While the screen is shown and data changes,
+// the timer runs every period_ms. A tick with nothing new and nothing
+// animating calls ui_refresh_idle(): the timer then only runs every
+// kParkedPeriodMs (for the stale check) until one of `signals` is published,
+// which wakes the LVGL task at once. Hidden screens pause their timer.
+struct ScreenRefresh
+{
+    static constexpr uint32_t kParkedPeriodMs = 250;
+
+    SignalMask signals;
+    uint32_t period_ms;
+    lv_timer_t* timer = nullptr;
+    bool parked = false;
+    bool reload = false; // set when the screen is loaded: redraw everything
+};
+
+// Creates the (paused) timer and hooks the screen's load/unload events.
+void ui_refresh_attach(ScreenRefresh& refresh, lv_obj_t* screen, lv_timer_cb_t cb);
+// Start of a tick: the subscribed signals published since the last tick,
+// kAllSignals on the first tick after the screen was loaded.
+SignalMask ui_refresh_begin(ScreenRefresh& refresh);
+// Nothing to do this tick: park the timer until new data arrives.
+void ui_refresh_idle(ScreenRefresh& refresh);
+
+// True if any of `signals` is stale or its last sample was rejected.
+// Screens pass the signals they draw.
+inline bool is_stale(const FlightSnapshot& state, SignalMask signals)
+{
+    return ((state.out_of_range | state.decode_error) & signals) ||
+           state.is_stale(signals, FlightData::monotonic_ms());
+}
+
+// True if all of `signals` can be computed with (see
+// FlightSnapshot::invalid_signals). Unlike is_stale() there is no boot grace.
+inline bool is_valid(const FlightSnapshot& state, SignalMask signals)
+{
+    return state.is_valid(signals, FlightData::monotonic_ms());
+}
+
+// IAS in km/h, the unit of the polar. For flap lookups, not for display.
+inline float get_ias_kmh(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.ias * 3.6f;
 }
 
-inline float get_weight_kg(const FlightData& state)
+// Display getters below return the units selected in Settings (units.hpp).
+inline float get_ias_display(const FlightSnapshot& state)
+{
+    return state.ias * units::speed().per_ms;
+}
+
+// IAS trend in display speed units per second.
+inline float get_ias_trend_display_s(const FlightSnapshot& state)
+{
+    return state.ias_rate * units::speed().per_ms;
+}
+
+inline float get_weight_kg(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.dry_and_ballast_mass / 10.0f;
 }
 
-inline float get_alt_m(const FlightData& state)
+inline float get_alt_m(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.alt + state.alt_corr;
 }
 
-inline float get_heading(const FlightData& state)
+inline float get_alt_display(const FlightSnapshot& state)
+{
+    return get_alt_m(state) * units::altitude().per_m;
+}
+
+inline float get_heading(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.heading;
 }
 
-inline float get_wind_speed_kmh(const FlightData& state)
+inline float get_wind_speed_display(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
-    return state.wind_speed * 3.6f;
+    return state.wind_speed * units::speed().per_ms;
 }
 
-inline float get_wind_direction(const FlightData& state)
+inline float get_wind_direction(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.wind_direction;
 }
 
-inline float get_gps_ground_speed_kmh(const FlightData& state)
+// Short tag for wind estimated on board, empty for wind from the bus.
+inline const char* get_wind_source_tag(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
-    return state.gps_ground_speed * 3.6f;
+    switch (state.wind_source)
+    {
+    case WindSource::Triangle: return "calc";
+    case WindSource::Circling: return "circ";
+    default: return "";
+    }
 }
 
-inline float get_gps_true_track(const FlightData& state)
+inline float get_gps_ground_speed_display(const FlightSnapshot& state)
+{
+    return state.gps_ground_speed * units::speed().per_ms;
+}
+
+inline float get_gps_true_track(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return state.gps_true_track;
 }
 
-inline flaputils::FlapSymbolResult get_flap_actual(const FlightData& state)
+// Distance (display distance unit, see units::SpeedDisplay) and true bearing
+// from the current position to the first fix after power-on. False until
+// both are known and the position is valid.
+inline bool get_home_display(const FlightSnapshot& state, float& distance, float& bearing_deg)
+{
+    if (!state.has_home || !is_valid(state, signal_mask(FlightSignal::Lat, FlightSignal::Lon))) return false;
+    const geo::Vector v = geo::distance_bearing({state.lat, state.lon}, {state.home_lat, state.home_lon});
+    distance = v.distance_m * 0.001f * units::speed().per_kmh;
+    bearing_deg = v.bearing_deg;
+    return true;
+}
+
+inline flaputils::FlapSymbolResult get_flap_actual(const FlightSnapshot& state)
 {
-    std::lock_guard<std::mutex> lock(state.mtx);
     return flaputils::get_flap_symbol(state.flapIdx);
 }
 
-inline flaputils::FlapSymbolResult get_flap_target(const FlightData& state)
+// {-1} until IAS and mass are both valid; mass reads 0 before the first
+// 1515 frame.
+inline flaputils::FlapSymbolResult get_flap_target(const FlightSnapshot& state)
 {
-    float weight = get_weight_kg(state);
-    std::lock_guard<std::mutex> lock(state.mtx);
-    return flaputils::get_optimal_flap(weight, state.ias * 3.6f);
+    if (!is_valid(state, signal_mask(FlightSignal::Ias, FlightSignal::Mass))) return {-1};
+    return flaputils::get_optimal_flap(get_weight_kg(state), get_ias_kmh(state));
 }
 
-inline void print_flight_data(const FlightData& state)
+inline void print_flight_data(const FlightSnapshot& state)
 {
-    std::lock_guard lock(state.mtx);
-    printf(
-        "FlightData: IAS=%.2f, TAS=%.2f, ALT=%.2f, ALT_CORR=%.2f, Vario=%.2f, Flap=%d, Lat=%.7f, Lon=%.7f, GPS Ground Speed=%.2f, GPS True Track=%.2f, Dry + Ballast Mass=%u, ENL=%u, Wind Speed=%.2f, Wind Dir=%.2f, Heading=%.2f\n",
-        state.ias * 3.6, state.tas * 3.6, state.alt, state.alt_corr, state.vario, state.flapIdx, state.lat, state.lon, state.gps_ground_speed, state.gps_true_track, state.dry_and_ballast_mass / 10, state.enl, state.wind_speed, state.wind_direction, state.heading);
+    printf("FlightData: ");
+    flight_codec::print_values(state);
+    printf("wind_source=%u wind_quality=%u\n", static_cast<unsigned>(state.wind_source), state.wind_quality);
 
-    const auto [index] = flaputils::get_optimal_flap(
-        state.dry_and_ballast_mass / 10.0f, state.ias * 3.6f);
+    // N/A until IAS and mass are valid, as on the display.
+    const auto [index] = get_flap_target(state);
     const flaputils::FlapSymbolResult actual = flaputils::get_flap_symbol(state.flapIdx);
-    const char* opt_sym = flaputils::get_range_symbol_name(index);
-    const char* act_sym = flaputils::get_flap_symbol_name(actual.index);
+    char opt_sym[flaputils::kSymbolSize];
+    char act_sym[flaputils::kSymbolSize];
     printf("Flaps: Optimal=%s, Actual=%s\n",
-           opt_sym ? opt_sym : "N/A",
-           act_sym ? act_sym : "N/A");
+           flaputils::get_range_symbol_name(index, opt_sym, sizeof(opt_sym)) ? opt_sym : "N/A",
+           flaputils::get_flap_symbol_name(actual.index, act_sym, sizeof(act_sym)) ? act_sym : "N/A");
 }
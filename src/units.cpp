@@ -0,0 +1,89 @@
+#include "units.hpp"
+
+#include <cstdio>
+#ifndef NATIVE_TEST_BUILD
+#include "nvs_flash.h"
+#include "nvs.h"
+#endif
+
+#ifdef NATIVE_TEST_BUILD
+#define NVS_UNITS_SIMULATION_FILE ".nvs_units"
+#endif
+
+namespace units
+{
+    namespace detail
+    {
+        const SpeedDisplay* g_speed = &kSpeedDisplays[static_cast<int>(SpeedUnit::Kmh)];
+        const AltitudeDisplay* g_altitude = &kAltitudeDisplays[static_cast<int>(AltitudeUnit::Meter)];
+        uint32_t g_generation = 1;
+    } // namespace detail
+
+    static constexpr int kSpeedUnitCount = sizeof(kSpeedDisplays) / sizeof(kSpeedDisplays[0]);
+    static constexpr int kAltitudeUnitCount = sizeof(kAltitudeDisplays) / sizeof(kAltitudeDisplays[0]);
+
+    void set(SpeedUnit speed_unit, AltitudeUnit altitude_unit)
+    {
+        const int s = static_cast<int>(speed_unit);
+        const int a = static_cast<int>(altitude_unit);
+        if (s >= kSpeedUnitCount || a >= kAltitudeUnitCount) return;
+        if (detail::g_speed->unit == speed_unit && detail::g_altitude->unit == altitude_unit) return;
+
+        detail::g_speed = &kSpeedDisplays[s];
+        detail::g_altitude = &kAltitudeDisplays[a];
+        if (++detail::g_generation == 0) detail::g_generation = 1;
+    }
+
+    bool save()
+    {
+        const uint8_t s = static_cast<uint8_t>(speed().unit);
+        const uint8_t a = static_cast<uint8_t>(altitude().unit);
+#ifndef NATIVE_TEST_BUILD
+        nvs_handle_t my_handle;
+        esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
+        if (err != ESP_OK) return false;
+
+        err = nvs_set_u8(my_handle, "speed_unit", s);
+        if (err == ESP_OK) err = nvs_set_u8(my_handle, "alt_unit", a);
+        if (err == ESP_OK) err = nvs_commit(my_handle);
+        nvs_close(my_handle);
+        return (err == ESP_OK);
+#else
+        FILE* f = fopen(NVS_UNITS_SIMULATION_FILE, "w");
+        if (!f) return false;
+        fprintf(f, "%u %u\n", s, a);
+        fclose(f);
+        return true;
+#endif
+    }
+
+    bool load_persisted()
+    {
+        unsigned s = 0;
+        unsigned a = 0;
+#ifndef NATIVE_TEST_BUILD
+        nvs_handle_t my_handle;
+        esp_err_t err = nvs_open("storage", NVS_READONLY, &my_handle);
+        if (err != ESP_OK) return false;
+
+        uint8_t s8 = 0;
+        uint8_t a8 = 0;
+        err = nvs_get_u8(my_handle, "speed_unit", &s8);
+        if (err == ESP_OK) err = nvs_get_u8(my_handle, "alt_unit", &a8);
+        nvs_close(my_handle);
+        if (err != ESP_OK) return false;
+        s = s8;
+        a = a8;
+#else
+        FILE* f = fopen(NVS_UNITS_SIMULATION_FILE, "r");
+        if (!f) return false;
+        const bool ok = fscanf(f, "%u %u", &s, &a) == 2;
+        fclose(f);
+        if (!ok) return false;
+#endif
+        if (s >= kSpeedUnitCount || a >= kAltitudeUnitCount) return false;
+        set(static_cast<SpeedUnit>(s), static_cast<AltitudeUnit>(a));
+        return true;
+    }
+
+} // namespace units
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+
+// Display units. Flight values stay SI in FlightSnapshot (m/s, m) and the
+// polar stays in km/h; only what is drawn is converted.
+//
+// Each unit is a compile-time policy. The policies are folded into constant
+// tables, so selecting a unit only swaps a pointer and the per-frame cost of
+// a displayed value is the one multiply it always had. Anything derived from
+// the unit (polar limits, scale ticks) is converted once per change; callers
+// compare generation() with the value they last converted for.
+namespace units
+{
+    enum class SpeedUnit : uint8_t
+    {
+        Kmh,
+        Knots,
+        Mph,
+    };
+
+    enum class AltitudeUnit : uint8_t
+    {
+        Meter,
+        Feet,
+    };
+
+    // Round ASI scale in whole display units.
+    struct AsiScale
+    {
+        int32_t min;
+        int32_t max;
+        uint32_t ticks;       // total tick count, min and max included
+        uint32_t major_every; // labelled ticks
+    };
+
+    // Altitude tape steps in display units.
+    struct AltitudeTape
+    {
+        int32_t minor_step;
+        int32_t major_step;
+        float pixels_per_unit;
+    };
+
+    template <SpeedUnit U>
+    struct SpeedPolicy;
+
+    template <>
+    struct SpeedPolicy<SpeedUnit::Kmh>
+    {
+        static constexpr float kPerKmh = 1.0f;
+        static constexpr const char* kLabel = "km/h";
+        static constexpr const char* kDistanceLabel = "km";
+        static constexpr AsiScale kAsi{40, 280, 25, 2}; // 10 km/h ticks
+    };
+
+    template <>
+    struct SpeedPolicy<SpeedUnit::Knots>
+    {
+        static constexpr float kPerKmh = 1.0f / 1.852f;
+        static constexpr const char* kLabel = "kt";
+        static constexpr const char* kDistanceLabel = "NM";
+        static constexpr AsiScale kAsi{20, 150, 27, 2}; // 5 kt ticks
+    };
+
+    template <>
+    struct SpeedPolicy<SpeedUnit::Mph>
+    {
+        static constexpr float kPerKmh = 1.0f / 1.609344f;
+        static constexpr const char* kLabel = "mph";
+        static constexpr const char* kDistanceLabel = "mi";
+        static constexpr AsiScale kAsi{20, 180, 33, 4}; // 5 mph ticks
+    };
+
+    template <AltitudeUnit U>
+    struct AltitudePolicy;
+
+    template <>
+    struct AltitudePolicy<AltitudeUnit::Meter>
+    {
+        static constexpr float kPerMeter = 1.0f;
+        static constexpr const char* kLabel = "m";
+        static constexpr AltitudeTape kTape{10, 100, 2.0f};
+    };
+
+    template <>
+    struct AltitudePolicy<AltitudeUnit::Feet>
+    {
+        static constexpr float kPerMeter = 1.0f / 0.3048f;
+        static constexpr const char* kLabel = "ft";
+        static constexpr AltitudeTape kTape{20, 200, 0.6f};
+    };
+
+    template <SpeedUnit U>
+    constexpr float speed_from_ms(float ms)
+    {
+        return ms * (3.6f * SpeedPolicy<U>::kPerKmh);
+    }
+
+    template <SpeedUnit U>
+    constexpr float speed_from_kmh(float kmh)
+    {
+        return kmh * SpeedPolicy<U>::kPerKmh;
+    }
+
+    template <AltitudeUnit U>
+    constexpr float altitude_from_m(float m)
+    {
+        return m * AltitudePolicy<U>::kPerMeter;
+    }
+
+    // A policy flattened into data for the unit chosen at runtime. Distances
+    // follow the speed unit (km, NM, mi), so per_kmh is also per km.
+    struct SpeedDisplay
+    {
+        SpeedUnit unit;
+        float per_ms;
+        float per_kmh;
+        const char* label;
+        const char* distance_label;
+        AsiScale asi;
+    };
+
+    struct AltitudeDisplay
+    {
+        AltitudeUnit unit;
+        float per_m;
+        const char* label;
+        AltitudeTape tape;
+    };
+
+    template <SpeedUnit U>
+    constexpr SpeedDisplay make_speed_display()
+    {
+        return {U, speed_from_ms<U>(1.0f), speed_from_kmh<U>(1.0f), SpeedPolicy<U>::kLabel,
+                SpeedPolicy<U>::kDistanceLabel, SpeedPolicy<U>::kAsi};
+    }
+
+    template <AltitudeUnit U>
+    constexpr AltitudeDisplay make_altitude_display()
+    {
+        return {U, altitude_from_m<U>(1.0f), AltitudePolicy<U>::kLabel, AltitudePolicy<U>::kTape};
+    }
+
+    // Indexed by the enum value.
+    inline constexpr SpeedDisplay kSpeedDisplays[] = {
+        make_speed_display<SpeedUnit::Kmh>(),
+        make_speed_display<SpeedUnit::Knots>(),
+        make_speed_display<SpeedUnit::Mph>(),
+    };
+
+    inline constexpr AltitudeDisplay kAltitudeDisplays[] = {
+        make_altitude_display<AltitudeUnit::Meter>(),
+        make_altitude_display<AltitudeUnit::Feet>(),
+    };
+
+    static_assert(kSpeedDisplays[static_cast<int>(SpeedUnit::Knots)].unit == SpeedUnit::Knots);
+    static_assert(kSpeedDisplays[static_cast<int>(SpeedUnit::Mph)].unit == SpeedUnit::Mph);
+    static_assert(kAltitudeDisplays[static_cast<int>(AltitudeUnit::Feet)].unit == AltitudeUnit::Feet);
+    static_assert(speed_from_ms<SpeedUnit::Kmh>(10.0f) == 36.0f);
+
+    namespace detail
+    {
+        extern const SpeedDisplay* g_speed;
+        extern const AltitudeDisplay* g_altitude;
+        extern uint32_t g_generation;
+    } // namespace detail
+
+    // Active units. Written by set() from the UI task only.
+    inline const SpeedDisplay& speed() { return *detail::g_speed; }
+    inline const AltitudeDisplay& altitude() { return *detail::g_altitude; }
+
+    // Changes on every set(), never 0.
+    inline uint32_t generation() { return detail::g_generation; }
+
+    // Selects the display units. Does not persist; see save().
+    void set(SpeedUnit speed_unit, AltitudeUnit altitude_unit);
+
+    // Persists the active units to NVS.
+    bool save();
+
+    // Selects the units persisted in NVS. Returns false (and keeps km/h and
+    // m) if none are stored.
+    bool load_persisted();
+
+} // namespace units
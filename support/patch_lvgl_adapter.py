@@ -2,7 +2,8 @@ Import("env")
 from pathlib import Path
 
 proj = Path(env["PROJECT_DIR"])
-cmake = proj / "components" / "espressif__esp_lvgl_adapter" / "CMakeLists.txt"
+component = proj / "components" / "espressif__esp_lvgl_adapter"
+cmake = component / "CMakeLists.txt"
 
 def patch():
     if not cmake.exists():
@@ -25,4 +26,124 @@ def patch():
         cmake.write_text(s2, encoding="utf-8")
         print("Patched esp_lvgl_adapter CMakeLists.txt (-include sticky form)")
 
+# Worker wake-up used by src/platform/ui_platform.cpp: the LVGL worker sleeps
+# in ulTaskNotifyTake() instead of vTaskDelay(), esp_lv_adapter_wake() ends
+# the sleep early and a wake callback runs under the LVGL lock before
+# lv_timer_handler(). Each edit is (file, original text, patched text).
+WAKE_EDITS = [
+    ("include/esp_lv_adapter.h",
+     """void esp_lv_adapter_unlock(void);
+
+/*****************************************************************************
+ *                         Display Control Functions                         *""",
+     """void esp_lv_adapter_unlock(void);
+
+/**
+ * @brief Wake the LVGL worker before its delay expires
+ *
+ * Safe to call from any task. The worker runs the wake callback (if set) and
+ * then lv_timer_handler() right away instead of finishing its sleep.
+ */
+void esp_lv_adapter_wake(void);
+
+/**
+ * @brief Set the callback the worker runs after esp_lv_adapter_wake()
+ *
+ * The callback runs in the LVGL task with the LVGL lock held, just before
+ * lv_timer_handler(), so it may use LVGL APIs (e.g. make a timer ready).
+ * Must be set after esp_lv_adapter_init().
+ *
+ * @param[in] cb  Callback, NULL to remove
+ * @param[in] arg Argument passed to the callback
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_STATE: Adapter not initialized
+ */
+esp_err_t esp_lv_adapter_set_wake_cb(void (*cb)(void *arg), void *arg);
+
+/*****************************************************************************
+ *                         Display Control Functions                         *"""),
+    ("src/adapter/adapter_internal.h",
+     """    TaskHandle_t task;                      /*!< LVGL task handle */
+""",
+     """    TaskHandle_t task;                      /*!< LVGL task handle */
+    void (*wake_cb)(void *);                /*!< Run by the worker after esp_lv_adapter_wake() */
+    void *wake_cb_arg;                      /*!< Argument for wake_cb */
+"""),
+    ("src/adapter/esp_lv_adapter.c",
+     """        xSemaphoreGiveRecursive(s_ctx.lvgl_mutex);
+    }
+}
+
+esp_err_t esp_lv_adapter_refresh_now(lv_display_t *disp)""",
+     """        xSemaphoreGiveRecursive(s_ctx.lvgl_mutex);
+    }
+}
+
+void esp_lv_adapter_wake(void)
+{
+    if (s_ctx.task) {
+        xTaskNotifyGive(s_ctx.task);
+    }
+}
+
+esp_err_t esp_lv_adapter_set_wake_cb(void (*cb)(void *arg), void *arg)
+{
+    ESP_RETURN_ON_FALSE(s_ctx.inited, ESP_ERR_INVALID_STATE, TAG, "Adapter not initialized");
+
+    esp_err_t ret = esp_lv_adapter_lock(-1);
+    ESP_RETURN_ON_ERROR(ret, TAG, "Failed to acquire LVGL lock (ret=%d)", ret);
+    s_ctx.wake_cb = cb;
+    s_ctx.wake_cb_arg = arg;
+    esp_lv_adapter_unlock();
+    return ESP_OK;
+}
+
+esp_err_t esp_lv_adapter_refresh_now(lv_display_t *disp)"""),
+    ("src/adapter/esp_lv_adapter.c",
+     """    uint32_t task_delay_ms = s_ctx.config.task_max_delay_ms;
+
+    while (!s_ctx.task_exit_requested) {""",
+     """    uint32_t task_delay_ms = s_ctx.config.task_max_delay_ms;
+    bool woken = false;
+
+    while (!s_ctx.task_exit_requested) {"""),
+    ("src/adapter/esp_lv_adapter.c",
+     """        if (esp_lv_adapter_lock(-1) == ESP_OK) {
+            task_delay_ms = lv_timer_handler();""",
+     """        if (esp_lv_adapter_lock(-1) == ESP_OK) {
+            if (woken && s_ctx.wake_cb) {
+                s_ctx.wake_cb(s_ctx.wake_cb_arg);
+            }
+            task_delay_ms = lv_timer_handler();"""),
+    ("src/adapter/esp_lv_adapter.c",
+     """        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
+    }
+
+    s_ctx.paused = false;""",
+     """        /* Sleep until the next LVGL timer is due or esp_lv_adapter_wake() */
+        woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(task_delay_ms)) != 0;
+    }
+
+    s_ctx.paused = false;"""),
+]
+
+def patch_wake():
+    if not component.exists():
+        return
+
+    for rel, old, new in WAKE_EDITS:
+        path = component / rel
+        s = path.read_text(encoding="utf-8")
+        if new in s:
+            continue
+        if old not in s:
+            # ui_platform.cpp needs the wake API; fail here, not at link time.
+            print(">>> esp_lvgl_adapter changed upstream, cannot apply wake patch to", rel)
+            env.Exit(1)
+        path.write_text(s.replace(old, new, 1), encoding="utf-8")
+        print("Patched esp_lvgl_adapter", rel, "(worker wake-up)")
+
 patch()
+patch_wake()
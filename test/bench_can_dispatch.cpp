@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../src/can_decoder.hpp"
+#include "../src/can_ingest.hpp"
+
+// Per-frame cost of the CAN ID dispatch table versus the former
+// string-keyed FlightData::update_* path (reproduced below as the baseline).
+
+struct LegacyFlightData
+{
+    std::mutex mtx;
+    float ias = 0, tas = 0, alt = 0, alt_corr = 0, vario = 0;
+    int flapIdx = 0;
+    float gps_ground_speed = 0, gps_true_track = 0;
+    uint16_t dry_and_ballast_mass = 0, enl = 0;
+    float wind_speed = 0, wind_direction = 0, heading = 0;
+    uint64_t last_relevant_rx_ms = 0;
+
+    void update_float(const std::string& key, float value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (key == "ias")
+        {
+            ias = value;
+            last_relevant_rx_ms = FlightData::monotonic_ms();
+        }
+        else if (key == "tas") tas = value;
+        else if (key == "alt") alt = value;
+        else if (key == "alt_corr") alt_corr = value;
+        else if (key == "vario") vario = value;
+        else if (key == "gps_ground_speed")
+        {
+            gps_ground_speed = value;
+            last_relevant_rx_ms = FlightData::monotonic_ms();
+        }
+        else if (key == "gps_true_track") gps_true_track = value;
+        else if (key == "wind_speed") wind_speed = value;
+        else if (key == "wind_direction") wind_direction = value;
+        else if (key == "heading") heading = value;
+    }
+
+    void update_int(const std::string& key, int value)
+    {
+        std::lock_guard lock(mtx);
+        if (key == "flap")
+        {
+            flapIdx = value;
+            last_relevant_rx_ms = FlightData::monotonic_ms();
+        }
+    }
+
+    void update_uint16(const std::string& key, uint16_t value)
+    {
+        std::lock_guard lock(mtx);
+        if (key == "dry_and_ballast_mass") dry_and_ballast_mass = value;
+        else if (key == "enl") enl = value;
+    }
+};
+
+static void legacy_handle(LegacyFlightData& fd, uint32_t id, const uint8_t* data)
+{
+    switch (id)
+    {
+    case 315: fd.update_float("ias", CANDecoder::decode_float(data)); break;
+    case 316: fd.update_float("tas", CANDecoder::decode_float(data)); break;
+    case 321: fd.update_float("heading", CANDecoder::decode_float(data)); break;
+    case 322: fd.update_float("alt", CANDecoder::decode_float(data)); break;
+    case 1519: fd.update_float("alt_corr", CANDecoder::decode_float(data)); break;
+    case 333: fd.update_float("wind_speed", CANDecoder::decode_float(data)); break;
+    case 334: fd.update_float("wind_direction", CANDecoder::decode_float(data)); break;
+    case 340: fd.update_int("flap", CANDecoder::decode_flap_idx(data)); break;
+    case 1039: fd.update_float("gps_ground_speed", CANDecoder::decode_float(data)); break;
+    case 1040: fd.update_float("gps_true_track", CANDecoder::decode_float(data)); break;
+    case 1515: fd.update_uint16("dry_and_ballast_mass", CANDecoder::decode_u16(data)); break;
+    case 1506: fd.update_uint16("enl", CANDecoder::decode_u16(data)); break;
+    default: break;
+    }
+}
+
+struct Frame
+{
+    uint32_t id;
+    uint8_t data[8];
+};
+
+static std::vector<Frame> make_frames()
+{
+    // Every consumed ID plus a few foreign ones, as seen on a shared bus.
+    const uint32_t ids[] = {315, 316, 321, 322, 333, 334, 340, 354, 1039, 1040, 1506, 1515, 1519, 300, 1200, 1038};
+    std::vector<Frame> frames;
+    for (int rep = 0; rep < 64; ++rep)
+    {
+        for (uint32_t id : ids)
+        {
+            // Header: node 1, the data type each ID is declared with, rolling message code.
+            const CanSignal* sig = can_dispatch::find(id);
+            const uint8_t type = sig ? static_cast<uint8_t>(sig->data_type) : 2;
+            Frame f{id, {1, type, 0, static_cast<uint8_t>(rep), 0x41, 0x20, 0x00, 0x00}}; // 10.0f
+            // Integer payloads inside their schema range.
+            if (id == 340) f.data[5] = 2;     // flap index
+            if (id == 1506) f.data[4] = 0x01; // ENL 288
+            if (id == 1515) f.data[4] = 0x14; // 515.2 kg
+            frames.push_back(f);
+        }
+    }
+    return frames;
+}
+
+template <typename Fn>
+static double ns_per_frame(const std::vector<Frame>& frames, int rounds, Fn&& fn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const Frame& f : frames) fn(f);
+    const auto t1 = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / (static_cast<double>(frames.size()) * rounds);
+}
+
+int main()
+{
+    const std::vector<Frame> frames = make_frames();
+    constexpr int kRounds = 2000;
+
+    LegacyFlightData legacy;
+    FlightData table;
+    CanIngest ingest(table);
+    // Receive timestamps come from the front-end; take one up front so only
+    // the dispatch itself is measured.
+    const uint64_t now_ms = FlightData::monotonic_ms();
+
+    // warm-up
+    ns_per_frame(frames, 10, [&](const Frame& f) { legacy_handle(legacy, f.id, f.data); });
+    ns_per_frame(frames, 10, [&](const Frame& f) { ingest.ingest(f.id, 8, f.data, now_ms); });
+
+    const double legacy_ns = ns_per_frame(frames, kRounds, [&](const Frame& f) { legacy_handle(legacy, f.id, f.data); });
+    const double table_ns = ns_per_frame(frames, kRounds, [&](const Frame& f) { ingest.ingest(f.id, 8, f.data, now_ms); });
+
+    std::printf("frames/round: %zu, rounds: %d\n", frames.size(), kRounds);
+    std::printf("string-keyed update_*: %8.1f ns/frame\n", legacy_ns);
+    std::printf("dispatch table:        %8.1f ns/frame\n", table_ns);
+    std::printf("speedup:               %8.2fx\n", legacy_ns / table_ns);
+
+    // Both paths must agree on the decoded values.
+    const FlightSnapshot snap = table.snapshot();
+    const bool same = legacy.ias == snap.ias && legacy.flapIdx == snap.flapIdx &&
+        legacy.dry_and_ballast_mass == snap.dry_and_ballast_mass && legacy.alt_corr == snap.alt_corr;
+    std::printf("\n=== BENCH SUMMARY: %s ===\n", same ? "PASS" : "FAIL");
+    return same ? 0 : 1;
+}
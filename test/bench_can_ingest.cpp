@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../src/can_ingest.hpp"
+
+// Replays a captured candump log (default test/canlog.log) through CanIngest
+// and reports the per-frame cost, once publishing after every frame and once
+// publishing per batch as the TWAI front-end does when its queue has backlog.
+
+struct Frame
+{
+    uint64_t ts_ms;
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+};
+
+static int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// "(1740476040.000000) can0 154#000000005E000000"
+static bool parse_candump_line(const char* line, Frame& out)
+{
+    double ts = 0;
+    char iface[32];
+    char frame[64];
+    if (std::sscanf(line, " (%lf) %31s %63s", &ts, iface, frame) != 3) return false;
+
+    const char* hash = std::strchr(frame, '#');
+    if (!hash) return false;
+
+    out = {};
+    out.ts_ms = static_cast<uint64_t>(ts * 1000.0);
+    out.id = static_cast<uint32_t>(std::strtoul(frame, nullptr, 16));
+    if (hash - frame > 3) out.id |= CanIngest::kExtendedFlag;
+
+    const char* p = hash + 1;
+    while (out.dlc < 8 && hex_nibble(p[0]) >= 0 && hex_nibble(p[1]) >= 0)
+    {
+        out.data[out.dlc++] = static_cast<uint8_t>((hex_nibble(p[0]) << 4) | hex_nibble(p[1]));
+        p += 2;
+    }
+    return true;
+}
+
+static std::vector<Frame> load_log(const char* path)
+{
+    std::vector<Frame> frames;
+    FILE* f = std::fopen(path, "r");
+    if (!f) return frames;
+    char line[256];
+    Frame fr;
+    while (std::fgets(line, sizeof(line), f))
+    {
+        if (parse_candump_line(line, fr)) frames.push_back(fr);
+    }
+    std::fclose(f);
+    return frames;
+}
+
+template <typename Fn>
+static double ns_per_frame(std::size_t frames, int rounds, Fn&& fn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (static_cast<double>(frames) * rounds);
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "test/canlog.log";
+    const int rounds = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5000;
+    constexpr std::size_t kBatch = 32;
+
+    const std::vector<Frame> frames = load_log(path);
+    if (frames.empty())
+    {
+        std::printf("No frames loaded from %s\n", path);
+        return 1;
+    }
+
+    FlightData data;
+    CanIngest ingest(data);
+
+    const double single_ns = ns_per_frame(frames.size(), rounds, [&]
+    {
+        for (const Frame& f : frames) ingest.ingest(f.id, f.dlc, f.data, f.ts_ms);
+    });
+
+    const double batch_ns = ns_per_frame(frames.size(), rounds, [&]
+    {
+        std::size_t n = 0;
+        for (const Frame& f : frames)
+        {
+            ingest.on_frame(f.id, f.dlc, f.data, f.ts_ms);
+            if (++n % kBatch == 0) ingest.publish();
+        }
+        ingest.publish();
+    });
+
+    const CanIngest::Stats st = ingest.stats();
+    std::printf("log: %s, %zu frames, %d rounds per mode\n", path, frames.size(), rounds);
+    std::printf("publish per frame:    %7.1f ns/frame (%.2f Mframes/s)\n", single_ns, 1e3 / single_ns);
+    std::printf("publish per %2zu frames: %7.1f ns/frame (%.2f Mframes/s)\n", kBatch, batch_ns, 1e3 / batch_ns);
+    std::printf("stats: frames=%u consumed=%u ignored=%u short=%u type errors=%u rejected=%u publishes=%u\n",
+                st.frames, st.consumed, st.ignored, st.short_frames, st.type_errors, st.rejected, st.publishes);
+
+    const FlightSnapshot snap = data.snapshot();
+    std::printf("final: IAS=%.2f m/s, mass=%u, flap=%d\n", snap.ias, snap.dry_and_ballast_mass, snap.flapIdx);
+
+    const bool ok = st.consumed > 0 && st.frames == st.consumed + st.ignored + st.short_frames + st.type_errors + st.rejected;
+    std::printf("\n=== BENCH SUMMARY: %s ===\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../src/flight_data.hpp"
+
+// Contention benchmark: one CAN-rate writer against several 50 Hz readers.
+// Compares the former per-getter mutex access (screen4 took the lock about
+// ten times per tick) with one lock-free FlightSnapshot copy per tick.
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int kReaders = 4;
+static constexpr int kReaderHz = 50;
+static constexpr int kWriterHz = 4000; // saturated 500 kbit/s bus
+static constexpr auto kDuration = std::chrono::seconds(2);
+
+struct MutexFlightData
+{
+    mutable std::mutex mtx;
+    FlightSnapshot values;
+};
+
+struct Stats
+{
+    double total_ns = 0;
+    double max_ns = 0;
+    uint64_t count = 0;
+
+    void add(double ns)
+    {
+        total_ns += ns;
+        max_ns = std::max(max_ns, ns);
+        ++count;
+    }
+
+    void merge(const Stats& o)
+    {
+        total_ns += o.total_ns;
+        max_ns = std::max(max_ns, o.max_ns);
+        count += o.count;
+    }
+
+    double avg() const { return count ? total_ns / static_cast<double>(count) : 0.0; }
+};
+
+static double elapsed_ns(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// The writer keeps ias and tas equal within one update so readers can detect
+// incoherent reads. Separate getter locks can legitimately mix two updates;
+// the snapshot must never do so.
+template <typename WriteFn>
+static Stats run_writer(std::atomic<bool>& stop, WriteFn&& write)
+{
+    Stats st;
+    const auto period = std::chrono::nanoseconds(1'000'000'000 / kWriterHz);
+    auto next = Clock::now();
+    uint32_t n = 0;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        ++n;
+        const auto t0 = Clock::now();
+        write(static_cast<float>(n));
+        st.add(elapsed_ns(t0));
+        next += period;
+        while (Clock::now() < next && !stop.load(std::memory_order_relaxed)) std::this_thread::yield();
+    }
+    return st;
+}
+
+template <typename TickFn>
+static Stats run_reader(std::atomic<bool>& stop, std::atomic<uint64_t>& torn, TickFn&& tick)
+{
+    Stats st;
+    const auto period = std::chrono::microseconds(1'000'000 / kReaderHz);
+    auto next = Clock::now();
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        const auto t0 = Clock::now();
+        if (!tick()) torn.fetch_add(1, std::memory_order_relaxed);
+        st.add(elapsed_ns(t0));
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    return st;
+}
+
+template <typename WriteFn, typename TickFn>
+static void run_case(const char* name, WriteFn&& write, TickFn&& tick, uint64_t& torn_out)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> torn{0};
+    Stats writer_stats;
+    Stats reader_stats[kReaders];
+
+    std::thread writer([&] { writer_stats = run_writer(stop, write); });
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i)
+        readers.emplace_back([&, i] { reader_stats[i] = run_reader(stop, torn, tick); });
+
+    std::this_thread::sleep_for(kDuration);
+    stop = true;
+    writer.join();
+    for (auto& t : readers) t.join();
+
+    Stats readers_total;
+    for (const Stats& s : reader_stats) readers_total.merge(s);
+
+    std::printf("%-22s writer: %7llu updates, avg %7.1f ns, max %9.1f ns | readers: %5llu ticks, avg %7.1f ns, max %9.1f ns | incoherent: %llu\n",
+                name,
+                static_cast<unsigned long long>(writer_stats.count), writer_stats.avg(), writer_stats.max_ns,
+                static_cast<unsigned long long>(readers_total.count), readers_total.avg(), readers_total.max_ns,
+                static_cast<unsigned long long>(torn.load()));
+    torn_out = torn.load();
+}
+
+int main()
+{
+    std::printf("writer %d Hz, %d readers at %d Hz, %lld s per case\n",
+                kWriterHz, kReaders, kReaderHz, static_cast<long long>(kDuration.count()));
+
+    MutexFlightData locked;
+    uint64_t torn_mutex = 0;
+    run_case("mutex per getter",
+             [&](float v)
+             {
+                 std::lock_guard lock(locked.mtx);
+                 locked.values.ias = v;
+                 locked.values.tas = v;
+             },
+             [&]
+             {
+                 // One lock per value, as the old ui_helpers getters did.
+                 float ias, tas, sink = 0;
+                 { std::lock_guard lock(locked.mtx); ias = locked.values.ias; }
+                 { std::lock_guard lock(locked.mtx); tas = locked.values.tas; }
+                 for (int i = 0; i < 8; ++i)
+                 {
+                     std::lock_guard lock(locked.mtx);
+                     sink += locked.values.alt;
+                 }
+                 (void)sink;
+                 return ias == tas;
+             },
+             torn_mutex);
+
+    FlightData seq;
+    uint64_t torn_seq = 0;
+    run_case("seqlock snapshot",
+             [&](float v)
+             {
+                 seq.pending.ias = v;
+                 seq.pending.tas = v;
+                 seq.publish();
+             },
+             [&]
+             {
+                 const FlightSnapshot s = seq.snapshot();
+                 return s.ias == s.tas;
+             },
+             torn_seq);
+
+    std::printf("\n=== BENCH SUMMARY: %s ===\n", torn_seq == 0 ? "PASS" : "FAIL");
+    return torn_seq == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "../src/flaputils.hpp"
+#include "../src/polar_format.hpp"
+
+// Boot-time polar load: the JSON path (read, cJSON parse, build tables) against
+// mapping a precompiled .fpol and checking its header and CRC. Also counts
+// heap allocations per load; the .fpol path is meant to need none.
+
+static long g_allocs = 0;
+
+void* operator new(std::size_t n)
+{
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static const char* kJsonPath = "spiffs_data/ventus3_defaut.json";
+static const char* kFpolPath = "bench_polar_load.fpol";
+
+struct Result
+{
+    double us;
+    double allocs;
+};
+
+static Result run(const char* path, int rounds)
+{
+    flaputils::load_data(path); // warm the page cache and the mapping
+    const long allocs = g_allocs;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+        if (!flaputils::load_data(path)) return {-1, -1};
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    return {us / rounds, static_cast<double>(g_allocs - allocs) / rounds};
+}
+
+int main()
+{
+    const std::vector<uint8_t> blob = fpol::from_json_file(kJsonPath);
+    FILE* f = std::fopen(kFpolPath, "wb");
+    if (!f || blob.empty()) return 1;
+    std::fwrite(blob.data(), 1, blob.size(), f);
+    std::fclose(f);
+
+    constexpr int kRounds = 5000;
+    const Result json = run(kJsonPath, kRounds);
+    const Result fpol = run(kFpolPath, kRounds);
+    const int flap = flaputils::get_optimal_flap(500, 130).index;
+    std::remove(kFpolPath);
+
+    std::printf("JSON parse:     %8.2f us per load, %6.1f allocations\n", json.us, json.allocs);
+    std::printf(".fpol map+CRC:  %8.2f us per load, %6.1f allocations (%zu bytes)\n", fpol.us, fpol.allocs,
+                blob.size());
+    std::printf("speedup: %.1fx\n", json.us / fpol.us);
+
+    const bool pass = json.us > 0 && fpol.us > 0 && fpol.us < json.us && fpol.allocs == 0 && flap == 3;
+    std::printf("\n=== BENCH SUMMARY: %s ===\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../src/polar_format.hpp"
+
+// Converts a polar JSON file to the binary .fpol format (src/polar_format.hpp)
+// the device maps without parsing. See test/POLAR_CONVERT.md.
+//
+//   polar_convert spiffs_data/ventus3_defaut.json [out.fpol]
+//
+// Without an output path the .json extension is replaced by .fpol.
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::fprintf(stderr, "usage: %s in.json [out.fpol]\n", argv[0]);
+        return 2;
+    }
+
+    std::string out_path = argc == 3 ? argv[2] : argv[1];
+    if (argc == 2)
+    {
+        const std::size_t dot = out_path.find_last_of('.');
+        const std::size_t slash = out_path.find_last_of('/');
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) out_path.erase(dot);
+        out_path += ".fpol";
+    }
+
+    std::string error;
+    const std::vector<uint8_t> blob = fpol::from_json_file(argv[1], &error);
+    if (blob.empty())
+    {
+        std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    // Round trip through the same checks the device runs.
+    fpol::View view;
+    const fpol::Error e = fpol::open(blob.data(), blob.size(), view);
+    if (e != fpol::Error::None)
+    {
+        std::fprintf(stderr, "%s: converted blob rejected: %s\n", argv[1], fpol::error_name(e));
+        return 1;
+    }
+
+    FILE* f = std::fopen(out_path.c_str(), "wb");
+    if (!f || std::fwrite(blob.data(), 1, blob.size(), f) != blob.size())
+    {
+        std::fprintf(stderr, "%s: cannot write\n", out_path.c_str());
+        if (f) std::fclose(f);
+        return 1;
+    }
+    std::fclose(f);
+
+    std::printf("%s -> %s: %zu bytes, %zu weights, %zu flaps, %zu bands, %u symbol bytes, crc %08x\n", argv[1],
+                out_path.c_str(), blob.size(), view.weight_count(), view.flap_count(), view.band_count(),
+                static_cast<unsigned>(view.header->symbol_bytes), static_cast<unsigned>(view.header->crc32));
+    return 0;
+}
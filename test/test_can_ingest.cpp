@@ -0,0 +1,234 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "../src/can_ingest.hpp"
+#include "test_support.hpp"
+
+// CANaerospace header handling in CanIngest: data type validation, message
+// code loss/duplicate tracking, per-ID receive rate, the change mask
+// handed to FlightData on publish and the per-signal validity flags.
+
+static std::size_t index_of(uint32_t id) { return can_dispatch::index_of(can_dispatch::find(id)); }
+
+static void test_header_decode()
+{
+    std::printf("\n--- Header decode ---\n");
+    // Flap frame as documented in doc/Display-L(Vario)_CAN_output.md.
+    const uint8_t frame[6] = {1, 19, 0, 95, 131, 2};
+    const CanAerospaceHeader h = CANDecoder::decode_header(frame);
+    check(h.node_id == 1 && h.data_type == CanAerospaceType::UChar2 && h.service_code == 0 && h.message_code == 95,
+          "node 1, UCHAR2, SC0, message code 95");
+    check(CANDecoder::decode_flap_idx(frame) == 2, "flap index 2");
+}
+
+static void test_type_validation()
+{
+    std::printf("\n--- Data type validation ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    uint8_t frame[8];
+
+    make_frame(frame, CanAerospaceType::Float, 0, 25.0f);
+    check(ingest.ingest(315, 8, frame, 10), "IAS declared FLOAT is accepted");
+
+    make_frame(frame, CanAerospaceType::Long, 1, 99.0f);
+    check(!ingest.ingest(315, 8, frame, 20), "IAS declared LONG is rejected");
+    check(data.snapshot().ias == 25.0f, "rejected frame leaves the value alone");
+
+    const uint8_t flap_float[8] = {1, static_cast<uint8_t>(CanAerospaceType::Float), 0, 0, 0, 5, 0, 0};
+    check(!ingest.ingest(340, 8, flap_float, 30), "flap declared FLOAT is rejected");
+
+    const uint8_t untyped[8] = {0, 0, 0, 0, 0x41, 0xA0, 0, 0};
+    check(ingest.ingest(315, 8, untyped, 40), "zeroed header is still decoded");
+    check(data.snapshot().ias == 20.0f, "untyped value applied");
+
+    const CanIngest::IdStats ias = ingest.id_stats(index_of(315), 40);
+    const CanIngest::IdStats flap = ingest.id_stats(index_of(340), 40);
+    check(ias.frames == 2 && ias.type_errors == 1 && ias.untyped == 1, "IAS counters");
+    check(flap.type_errors == 1 && flap.frames == 0, "flap counters");
+    check(ingest.stats().type_errors == 2, "type errors in the totals");
+}
+
+static void test_message_codes()
+{
+    std::printf("\n--- Message code gaps ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    uint8_t frame[8];
+
+    // 250..255, 0..3 with 253 missing, 1 repeated and 2 dropped.
+    const uint8_t codes[] = {250, 251, 252, 254, 255, 0, 1, 1, 3};
+    uint64_t t = 0;
+    for (uint8_t c : codes)
+    {
+        make_frame(frame, CanAerospaceType::Float, c, 1.0f);
+        ingest.on_frame(354, 8, frame, t += 10);
+    }
+    const CanIngest::IdStats st = ingest.id_stats(index_of(354), t);
+    std::printf("frames=%u lost=%u dup=%u\n", st.frames, st.lost, st.duplicates);
+    check(st.frames == 9, "all frames accepted");
+    check(st.lost == 2, "two lost across the wrap");
+    check(st.duplicates == 1, "one duplicate");
+}
+
+static void test_rate()
+{
+    std::printf("\n--- Receive rate ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    uint8_t frame[8];
+
+    // 20 Hz for three seconds.
+    for (uint32_t i = 0; i <= 60; ++i)
+    {
+        make_frame(frame, CanAerospaceType::Float, static_cast<uint8_t>(i), 1.0f);
+        ingest.on_frame(322, 8, frame, 1000 + i * 50);
+    }
+    const CanIngest::IdStats st = ingest.id_stats(index_of(322), 4000);
+    std::printf("rate=%.2f Hz lost=%u\n", st.rate_mhz / 1000.0, st.lost);
+    check(st.rate_mhz == 20000, "20 Hz measured");
+    check(st.lost == 0 && st.duplicates == 0, "clean sequence");
+
+    // Then silent: the last window stays open and the rate falls with it.
+    const uint32_t late = ingest.id_stats(index_of(322), 5500).rate_mhz;
+    const uint32_t silent = ingest.id_stats(index_of(322), 6000).rate_mhz;
+    std::printf("rate 1.5 s after the last frame=%.2f Hz, 2 s after=%.2f Hz\n", late / 1000.0, silent / 1000.0);
+    check(late > 0 && late < 20000, "rate falls while the ID is quiet");
+    check(silent == 0, "silent ID reports 0");
+    check(ingest.id_stats(index_of(322), 3000).rate_mhz == 20000, "frames stamped ahead of now keep the rate");
+}
+
+static int s_listener_calls = 0;
+static void count_listener_call() { ++s_listener_calls; }
+
+static void test_change_mask()
+{
+    std::printf("\n--- Change mask ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    data.set_change_listener(count_listener_call);
+    uint8_t frame[8];
+
+    const SignalMask ias = signal_mask(FlightSignal::Ias);
+    const SignalMask alt = signal_mask(FlightSignal::Alt);
+    data.watch(ias);
+
+    make_frame(frame, CanAerospaceType::Float, 0, 80.0f);
+    ingest.on_frame(322, 8, frame, 1000);
+    ingest.publish();
+    check(data.peek_changes(kAllSignals) == alt, "altitude frame marks only Alt");
+    check(s_listener_calls == 0, "unwatched signal does not call the listener");
+
+    make_frame(frame, CanAerospaceType::Float, 0, 30.0f);
+    ingest.on_frame(315, 8, frame, 1010);
+    ingest.on_frame(315, 8, frame, 1020);
+    ingest.publish();
+    check(s_listener_calls == 1, "one listener call per publish of a watched signal");
+    check(data.take_changes(ias) == ias, "take returns IAS");
+    check(data.take_changes(ias) == 0, "take clears IAS");
+    check(data.peek_changes(kAllSignals) == alt, "Alt still pending for its consumer");
+
+    ingest.publish();
+    check(s_listener_calls == 1, "publish without new frames is a no-op");
+
+    make_frame(frame, CanAerospaceType::Long, 0, 30.0f);
+    ingest.on_frame(315, 8, frame, 1030);
+    ingest.publish();
+    check(data.take_changes(ias) == ias && s_listener_calls == 2, "first rejected frame publishes the flag");
+    ingest.on_frame(315, 8, frame, 1040);
+    ingest.publish();
+    check(data.take_changes(ias) == 0 && s_listener_calls == 2, "repeated rejection changes nothing");
+}
+
+static void test_validity()
+{
+    std::printf("\n--- Validity flags ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    uint8_t frame[8];
+    const SignalMask ias = signal_mask(FlightSignal::Ias);
+    const SignalMask mass = signal_mask(FlightSignal::Mass);
+
+    FlightSnapshot s = data.snapshot();
+    check(s.invalid_signals(ias | mass, 100) == (ias | mass), "never received is invalid at once");
+    check(s.stale_signals(ias | mass, 100) == 0, "but not stale during the boot grace");
+    check(s.field_flags(FlightSignal::Mass, 100) == FlightSnapshot::kNeverReceived, "mass flag before 1515");
+
+    make_frame(frame, CanAerospaceType::Float, 0, 30.0f);
+    ingest.ingest(315, 8, frame, 1000);
+    check(data.snapshot().is_valid(ias, 1000), "good sample is valid");
+
+    make_frame(frame, CanAerospaceType::Float, 1, std::numeric_limits<float>::quiet_NaN());
+    check(!ingest.ingest(315, 8, frame, 1010), "NaN is rejected");
+    s = data.snapshot();
+    check(s.ias == 30.0f && s.received_ms(FlightSignal::Ias) == 1000, "NaN keeps the last good value and time");
+    check(s.field_flags(FlightSignal::Ias, 1010) == FlightSnapshot::kDecodeError, "NaN sets decode error");
+    check(s.stale_signals(ias, 1010) == 0 && s.invalid_signals(ias, 1010) == ias, "invalid without being stale");
+
+    make_frame(frame, CanAerospaceType::Float, 2, 900.0f);
+    check(!ingest.ingest(315, 8, frame, 1020), "900 m/s is rejected");
+    s = data.snapshot();
+    check(s.field_flags(FlightSignal::Ias, 1020) == FlightSnapshot::kOutOfRange, "out of range replaces decode error");
+
+    make_frame(frame, CanAerospaceType::Float, 3, 31.0f);
+    check(ingest.ingest(315, 8, frame, 1030), "good sample accepted again");
+    s = data.snapshot();
+    check(s.ias == 31.0f && s.field_flags(FlightSignal::Ias, 1030) == 0, "good sample clears the flags");
+
+    check(!ingest.ingest(315, 6, frame, 1040), "short frame rejected");
+    check(data.snapshot().field_flags(FlightSignal::Ias, 1040) == FlightSnapshot::kDecodeError,
+          "short frame sets decode error");
+    check(data.snapshot().field_flags(FlightSignal::Ias, 1030 + SignalTimeouts::kPeriodicTimeoutMs) ==
+              (FlightSnapshot::kStale | FlightSnapshot::kDecodeError),
+          "bad frames alone let the value go stale");
+
+    const uint8_t light[6] = {1, static_cast<uint8_t>(CanAerospaceType::UShort), 0, 0, 0x00, 0x64}; // 10 kg
+    check(!ingest.ingest(1515, 6, light, 1050), "10 kg mass is out of range");
+    check(!data.snapshot().is_valid(mass, 1050), "mass still unusable");
+    check(ingest.stats().rejected == 3 && ingest.stats().short_frames == 1, "rejections counted");
+}
+
+// Heading, track and wind direction may come as -180..180.
+static void test_signed_angles()
+{
+    std::printf("\n--- Signed angles ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    uint8_t frame[8];
+    const SignalMask angles = signal_mask(FlightSignal::Heading, FlightSignal::GpsTrueTrack, FlightSignal::WindDirection);
+
+    make_frame(frame, CanAerospaceType::Float, 0, -90.0f);
+    check(ingest.ingest(321, 8, frame, 1000), "heading -90 accepted");
+    make_frame(frame, CanAerospaceType::Float, 0, -180.0f);
+    check(ingest.ingest(1040, 8, frame, 1000), "track -180 accepted");
+    make_frame(frame, CanAerospaceType::Float, 0, 270.0f);
+    check(ingest.ingest(334, 8, frame, 1000), "wind direction 270 accepted");
+    FlightSnapshot s = data.snapshot();
+    check(s.heading == 270.0f && s.gps_true_track == 180.0f && s.wind_direction == 270.0f, "stored as 0..360");
+    check(s.is_valid(angles, 1000), "all three valid");
+
+    make_frame(frame, CanAerospaceType::Float, 1, -0.5f);
+    check(ingest.ingest(321, 8, frame, 1010) && data.snapshot().heading == 359.5f, "just left of north");
+    make_frame(frame, CanAerospaceType::Float, 2, -181.0f);
+    check(!ingest.ingest(321, 8, frame, 1020), "-181 rejected");
+    s = data.snapshot();
+    check(s.heading == 359.5f && s.field_flags(FlightSignal::Heading, 1020) == FlightSnapshot::kOutOfRange,
+          "out of range keeps the last heading");
+    make_frame(frame, CanAerospaceType::Float, 3, 361.0f);
+    check(!ingest.ingest(321, 8, frame, 1030), "361 rejected");
+}
+
+int main()
+{
+    test_header_decode();
+    test_type_validation();
+    test_message_codes();
+    test_rate();
+    test_change_mask();
+    test_validity();
+    test_signed_angles();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
@@ -0,0 +1,234 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "../src/can_ingest.hpp"
+#include "../src/can_trace.hpp"
+#include "../src/platform/can_log_import.hpp"
+#include "test_support.hpp"
+
+// candump / Vector ASC import into the replay format and indexed seek
+// (src/platform/can_log_import.hpp, src/can_trace.hpp).
+
+using namespace can_log_import;
+
+static bool write_file(const char* path, const char* text)
+{
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+    std::fputs(text, f);
+    std::fclose(f);
+    return true;
+}
+
+static void test_candump_lines()
+{
+    std::printf("\n--- candump lines ---\n");
+    Frame f;
+    check(parse_candump_line("(1740476040.000000) can0 154#000000005E000000\n", f) &&
+              f.id == 0x154 && f.dlc == 8 && f.data[4] == 0x5E && f.time_s == 1740476040.0,
+          "log format");
+    check(parse_candump_line("(1.5) vcan0 12345678#0102\n", f) &&
+              f.id == (0x12345678 | CanIngest::kExtendedFlag) && f.dlc == 2 && f.data[1] == 0x02,
+          "extended id");
+    check(parse_candump_line("(2.0) can0 13B#R\n", f) && f.dlc == 0, "remote frame");
+    check(!parse_candump_line("(2.0) can0 13B##10011\n", f), "CAN FD skipped");
+    check(parse_candump_line(" (1740476040.250000)  can0  13B   [8]  00 00 00 00 42 9E 00 00\n", f) &&
+              f.id == 0x13B && f.dlc == 8 && f.data[4] == 0x42 && f.data[5] == 0x9E,
+          "candump -ta format");
+    check(!parse_candump_line("can0  13B   [8]  00 00 00 00 42 9E 00 00\n", f), "no timestamp, skipped");
+}
+
+static void test_asc_lines()
+{
+    std::printf("\n--- ASC lines ---\n");
+    AscState st;
+    Frame f;
+    check(!parse_asc_line("base hex  timestamps absolute\n", st, f) && st.hex_ids && !st.relative_time, "header");
+    check(parse_asc_line("   1.234567 1  13B             Rx   d 8 00 00 00 00 42 9E 00 00  Length = 0 BitCount = 0 ID = 315\n", st, f) &&
+              f.id == 0x13B && f.dlc == 8 && f.data[5] == 0x9E && f.time_s == 1.234567,
+          "data frame");
+    check(parse_asc_line("   1.300000 1  1234567x        Rx   d 2 01 02\n", st, f) &&
+              f.id == (0x1234567 | CanIngest::kExtendedFlag) && f.dlc == 2,
+          "extended id");
+    check(parse_asc_line("   1.400000 2  154             Tx   r 6\n", st, f) && f.dlc == 0, "remote frame");
+    check(!parse_asc_line("   1.500000 1  ErrorFrame\n", st, f), "error frame skipped");
+    check(!parse_asc_line("Begin Triggerblock Tue Feb 25 10:00:00.000 am 2025\n", st, f), "trigger block skipped");
+
+    AscState rel;
+    parse_asc_line("base dec  timestamps relative\n", rel, f);
+    check(parse_asc_line("   0.5 1  315 Rx d 8 00 00 00 00 42 9E 00 00\n", rel, f) && f.id == 315 && f.time_s == 0.5,
+          "decimal id");
+    check(parse_asc_line("   0.25 1  316 Rx d 8 00 00 00 00 42 9E 00 00\n", rel, f) && f.time_s == 0.75,
+          "relative timestamps accumulate");
+}
+
+static void test_asc_file()
+{
+    std::printf("\n--- ASC file ---\n");
+    const char* in = "test_import.asc";
+    const char* out = "test_import_asc.fct";
+    write_file(in,
+               "date Tue Feb 25 10:00:00.000 am 2025\n"
+               "base hex  timestamps absolute\n"
+               "internal events logged\n"
+               "Begin Triggerblock Tue Feb 25 10:00:00.000 am 2025\n"
+               "   0.000000 Start of measurement\n"
+               "   0.010000 1  13B             Rx   d 8 00 00 00 00 42 9E 00 00\n"
+               "   1.010000 1  154             Rx   d 6 01 13 00 5F 83 02\n"
+               "   2.500000 1  5EB             Rx   d 8 00 07 00 00 10 04 00 00\n"
+               "End TriggerBlock\n");
+    const Result r = import(in, out);
+    check(r.ok && r.frames == 3 && r.skipped == 6, "three frames, six other lines");
+    check(r.index_entries == 3, "one index entry per second with frames");
+
+    CanTraceReader reader;
+    CanTraceRecord rec;
+    check(reader.open(out) && reader.seek(2000) && reader.next(rec) && rec.id == 0x5EB && rec.timestamp_ms == 2490,
+          "seek to 2 s lands on the 5EB frame");
+    std::remove(in);
+    std::remove(out);
+}
+
+// Several minutes of a 500 frames/s bus as candump -l text: checks that
+// every frame survives the conversion and that seek is independent of the
+// position in the trace.
+static void test_long_log()
+{
+    std::printf("\n--- Long candump log ---\n");
+    const char* in = "test_import_long.log";
+    const char* out = "test_import_long.fct";
+    constexpr uint32_t kSeconds = 600;
+    constexpr uint32_t kPerSecond = 500;
+
+    std::FILE* f = std::fopen(in, "w");
+    if (!f)
+    {
+        check(false, "create input");
+        return;
+    }
+    for (uint32_t i = 0; i < kSeconds * kPerSecond; ++i)
+    {
+        const uint32_t ms = i * 1000 / kPerSecond;
+        std::fprintf(f, "(%u.%06u) can0 %03X#0102%02X%02X%08X\n", 1740476040u + ms / 1000, (ms % 1000) * 1000,
+                     i % 2 ? 0x13B : 0x162, i & 0xFF, (i >> 8) & 0xFF, i);
+    }
+    const long in_bytes = std::ftell(f);
+    std::fclose(f);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const Result r = import(in, out);
+    const double import_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%.1f MB, %llu frames in %.2f s (%.0f MB/s), %u index entries\n", in_bytes / 1e6,
+                static_cast<unsigned long long>(r.frames), import_s, in_bytes / 1e6 / import_s, r.index_entries);
+    check(r.ok && r.frames == kSeconds * kPerSecond && r.skipped == 0, "all frames imported");
+    check(r.index_entries == kSeconds, "one index entry per second");
+
+    CanTraceReader reader;
+    check(reader.open(out), "trace opens");
+    bool ok = true;
+    double worst_us = 0;
+    for (uint32_t minute = 0; minute < kSeconds / 60; ++minute)
+    {
+        const uint32_t target = minute * 60000 + 12345;
+        const auto s0 = std::chrono::steady_clock::now();
+        CanTraceRecord rec;
+        const bool found = reader.seek(target) && reader.next(rec);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s0).count();
+        if (us > worst_us) worst_us = us;
+        // Frames are 2 ms apart, numbered by the last four data bytes.
+        const uint32_t expected = (target + 1) / 2;
+        const uint32_t seq = (rec.data[4] << 24) | (rec.data[5] << 16) | (rec.data[6] << 8) | rec.data[7];
+        if (!found || rec.timestamp_ms < target || seq != expected) ok = false;
+    }
+    std::printf("worst seek: %.0f us\n", worst_us);
+    check(ok, "seek to every minute lands on the first frame at or after the target");
+    CanTraceRecord rec;
+    check(!reader.seek(kSeconds * 1000 + 1) && !reader.next(rec), "seek past the end finds nothing");
+
+    std::remove(in);
+    std::remove(out);
+}
+
+// A damaged index must not cost the records: the reader drops the index
+// and counts records up to the end of the file.
+static void test_damaged_index()
+{
+    std::printf("\n--- Damaged index ---\n");
+    const char* path = "test_import_damaged.fct";
+    constexpr uint32_t kRecords = 300;
+    const uint8_t data[8] = {};
+
+    struct Damage
+    {
+        const char* what;
+        bool entry_count; // patch the index entry count, else the index offset
+        uint64_t value;
+    };
+    const Damage damages[] = {
+        {"index offset inside the header", false, 10},
+        {"index offset past the end of the file", false, uint64_t{1} << 40},
+        {"entry count larger than the file", true, 0xFFFFFFFFu},
+    };
+    for (const Damage& d : damages)
+    {
+        CanTraceWriter writer;
+        if (!writer.open(path))
+        {
+            check(false, "create trace");
+            return;
+        }
+        writer.enable_index(100);
+        for (uint32_t i = 0; i < kRecords; ++i) writer.write(0x13B, 8, data, i * 10);
+        writer.close();
+
+        std::FILE* f = std::fopen(path, "r+b");
+        CanTraceHeader h{};
+        if (!f || std::fread(&h, sizeof(h), 1, f) != 1)
+        {
+            check(false, "read back trace header");
+            if (f) std::fclose(f);
+            return;
+        }
+        if (d.entry_count)
+        {
+            CanTraceIndexHeader ih{};
+            std::fseek(f, static_cast<long>(h.index_offset), SEEK_SET);
+            std::fread(&ih, sizeof(ih), 1, f);
+            ih.entry_count = static_cast<uint32_t>(d.value);
+            std::fseek(f, static_cast<long>(h.index_offset), SEEK_SET);
+            std::fwrite(&ih, sizeof(ih), 1, f);
+        }
+        else
+        {
+            h.index_offset = d.value;
+            std::fseek(f, 0, SEEK_SET);
+            std::fwrite(&h, sizeof(h), 1, f);
+        }
+        std::fseek(f, 0, SEEK_END);
+        const uint64_t file_size = static_cast<uint64_t>(std::ftell(f));
+        std::fclose(f);
+
+        CanTraceReader reader;
+        const bool opened = reader.open(path);
+        // Without a usable offset the index bytes read as trailing records.
+        const uint64_t expected =
+            d.entry_count ? kRecords : (file_size - sizeof(CanTraceHeader)) / sizeof(CanTraceRecord);
+        CanTraceRecord rec;
+        const bool seeks = reader.seek(1500) && reader.next(rec) && rec.timestamp_ms == 1500;
+        check(opened && reader.index().empty() && reader.record_count() == expected && seeks, d.what);
+    }
+    std::remove(path);
+}
+
+int main()
+{
+    test_candump_lines();
+    test_asc_lines();
+    test_asc_file();
+    test_long_log();
+    test_damaged_index();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
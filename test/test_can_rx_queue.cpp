@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "../src/can_rx_queue.hpp"
+#include "test_support.hpp"
+
+// Unit and throughput test for the receive-path hand-over (src/can_rx_queue.hpp).
+
+static void test_in_order()
+{
+    std::printf("\n--- In-order delivery ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    CanRxQueue<8> q;
+
+    uint8_t frame[8];
+    make_frame(frame, CanAerospaceType::Float, 0, 20.0f);
+    q.push(315, 8, frame, 100);
+    make_frame(frame, CanAerospaceType::Float, 0, 500.0f);
+    q.push(322, 8, frame, 101);
+    q.push(0x7FF, 8, frame, 102); // not consumed, still counted by ingest
+
+    const std::size_t n = q.drain(ingest);
+    const FlightSnapshot s = data.snapshot();
+    check(n == 3, "three frames handed to ingest");
+    check(s.ias == 20.0f && s.alt == 500.0f, "values decoded");
+    check(s.received_ms(FlightSignal::Ias) == 100, "receive timestamp preserved");
+    check(ingest.stats().ignored == 1, "foreign ID reaches ingest statistics");
+    check(q.empty() && q.counters().overruns == 0, "queue empty, no overrun");
+}
+
+static void test_overrun_keeps_latest()
+{
+    std::printf("\n--- Overrun keeps latest value ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    CanRxQueue<4> q;
+
+    uint8_t frame[8];
+    for (int i = 1; i <= 10; ++i)
+    {
+        make_frame(frame, CanAerospaceType::Float, 0, static_cast<float>(i));
+        q.push(315, 8, frame, static_cast<uint64_t>(i));
+    }
+    make_frame(frame, CanAerospaceType::Float, 0, 3.0f);
+    q.push(354, 8, frame, 11);
+
+    const CanRxQueue<4>::Counters c = q.counters();
+    check(c.pushed == 11 && c.overruns == 7, "producer never blocks, overruns counted");
+
+    q.drain(ingest);
+    const FlightSnapshot s = data.snapshot();
+    check(s.ias == 10.0f, "IAS ends at the newest value despite overrun");
+    check(s.vario == 3.0f, "vario dropped by the ring but recovered from its slot");
+    check(q.counters().recovered == 2, "two slots recovered");
+    check(ingest.stats().publishes == 1, "one publish per drain");
+
+    // Nothing new: a second drain must not re-apply anything.
+    check(q.drain(ingest) == 0, "idle drain is a no-op");
+}
+
+static void test_wraparound()
+{
+    std::printf("\n--- Index wrap-around ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    CanRxQueue<4> q;
+
+    uint8_t frame[8];
+    bool ok = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const float value = static_cast<float>(i) * 0.02f; // inside the vario range
+        make_frame(frame, CanAerospaceType::Float, 0, value);
+        q.push(322, 8, frame, static_cast<uint64_t>(i));
+        q.push(354, 8, frame, static_cast<uint64_t>(i));
+        if (q.drain(ingest) != 2) ok = false;
+        const FlightSnapshot s = data.snapshot();
+        if (s.alt != value || s.vario != value) ok = false;
+    }
+    check(ok, "1000 push/drain cycles through a 4-entry ring");
+    check(q.counters().overruns == 0 && q.counters().recovered == 0, "no overrun, no recovery");
+}
+
+// One producer thread pushing as fast as it can against one consumer thread.
+// IAS and altitude carry a running counter, scaled into the IAS range, so the
+// consumer can check that values never go backwards and that the final drain
+// lands on the last value pushed.
+static float counter_value(uint32_t i) { return static_cast<float>(i) / 32768.0f; } // exact below 2^24
+
+static void test_throughput()
+{
+    std::printf("\n--- Throughput (producer vs consumer thread) ---\n");
+    constexpr uint32_t kFrames = 4'000'000;
+    FlightData data;
+    CanIngest ingest(data);
+    static CanRxQueue<128> q;
+
+    std::atomic<bool> done{false};
+    bool monotonic = true;
+    uint64_t drains = 0;
+
+    std::thread consumer([&]
+    {
+        float last = -1.0f;
+        while (true)
+        {
+            const bool finished = done.load(std::memory_order_acquire);
+            q.drain(ingest);
+            ++drains;
+            const float ias = data.pending.ias;
+            if (ias < last) monotonic = false;
+            last = ias;
+            if (finished) break;
+        }
+    });
+
+    uint8_t frame[8];
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= kFrames; ++i)
+    {
+        make_frame(frame, CanAerospaceType::Float, 0, counter_value(i));
+        q.push(i & 1 ? 315 : 322, 8, frame, i);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / kFrames;
+    const CanRxQueue<128>::Counters c = q.counters();
+    std::printf("%u frames, %.1f ns/push (%.1f Mframes/s), %llu drains\n",
+                kFrames, ns, 1e3 / ns, static_cast<unsigned long long>(drains));
+    std::printf("overruns=%u recovered=%u superseded=%u\n", c.overruns, c.recovered, c.superseded);
+
+    const FlightSnapshot s = data.snapshot();
+    check(monotonic, "consumer never saw an older IAS after a newer one");
+    check(s.ias == counter_value(kFrames - 1), "final IAS is the last value pushed");
+    check(s.alt == counter_value(kFrames), "final altitude is the last value pushed");
+    check(c.pushed == kFrames, "all frames offered");
+}
+
+int main()
+{
+    test_in_order();
+    test_overrun_keeps_latest();
+    test_wraparound();
+    test_throughput();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "../src/can_trace.hpp"
+#include "../src/platform/can_replay.hpp"
+#include "test_support.hpp"
+
+// Trace format round trip and replay modes (src/can_trace.hpp,
+// src/platform/can_replay.hpp).
+
+static const char* kTracePath = "test_can_trace.fct";
+
+// 20 s of IAS at 50 Hz and altitude at 10 Hz, plus one extended frame.
+static uint32_t write_trace(const char* path)
+{
+    CanTraceWriter writer;
+    if (!writer.open(path)) return 0;
+
+    uint8_t frame[8];
+    const uint64_t t0 = 123456;
+    for (uint32_t ms = 0; ms < 20000; ms += 20)
+    {
+        make_frame(frame, CanAerospaceType::Float, static_cast<uint8_t>(ms / 20), 20.0f + ms / 1000.0f);
+        writer.write(315, 8, frame, t0 + ms);
+        if (ms % 100 == 0) writer.write(322, 8, frame, t0 + ms);
+    }
+    writer.write(0x1234567 | CanIngest::kExtendedFlag, 3, frame, t0 + 20000);
+    const uint32_t n = writer.records();
+    writer.close();
+    return n;
+}
+
+static void test_round_trip()
+{
+    std::printf("\n--- Record / read back ---\n");
+    const uint32_t written = write_trace(kTracePath);
+    check(written == 1201, "1201 records written");
+
+    CanTraceReader reader;
+    check(reader.open(kTracePath), "trace opens");
+    check(reader.record_count() == written, "record count from file size");
+
+    CanTraceRecord rec;
+    check(reader.next(rec) && rec.timestamp_ms == 0 && rec.id == 315 && rec.dlc == 8, "first record rebased to t=0");
+    CanTraceRecord last = rec;
+    uint64_t n = 1;
+    while (reader.next(rec))
+    {
+        last = rec;
+        ++n;
+    }
+    check(n == written, "all records read");
+    check(last.timestamp_ms == 20000 && last.id == (0x1234567 | CanIngest::kExtendedFlag) && last.dlc == 3,
+          "extended frame kept with its flag and DLC");
+
+    std::FILE* f = std::fopen(kTracePath, "rb");
+    long size = 0;
+    if (f)
+    {
+        std::fseek(f, 0, SEEK_END);
+        size = std::ftell(f);
+        std::fclose(f);
+    }
+    check(size == static_cast<long>(sizeof(CanTraceHeader) + written * sizeof(CanTraceRecord)), "20 bytes per frame");
+}
+
+struct ReplayOutcome
+{
+    CanTraceReplay::Result result;
+    FlightSnapshot snap;
+    CanIngest::Stats stats;
+};
+
+static ReplayOutcome replay(double speed)
+{
+    FlightData data;
+    CanIngest ingest(data);
+    CanTraceReplay replay;
+    ReplayOutcome out{};
+    if (!replay.open(kTracePath)) return out;
+    std::atomic<bool> running{true};
+    CanTraceReplay::Options options;
+    options.speed = speed;
+    out.result = replay.run(ingest, running, options);
+    out.snap = data.snapshot();
+    out.stats = ingest.stats();
+    return out;
+}
+
+static void test_replay_modes()
+{
+    std::printf("\n--- Replay ---\n");
+    const ReplayOutcome a = replay(CanTraceReplay::kAsFastAsPossible);
+    const ReplayOutcome b = replay(CanTraceReplay::kAsFastAsPossible);
+    std::printf("as fast as possible: %llu frames, %.1f s of trace in %.4f s, %u publishes\n",
+                static_cast<unsigned long long>(a.result.frames), a.result.trace_seconds, a.result.wall_seconds,
+                a.stats.publishes);
+    check(a.result.frames == 1201 && a.stats.consumed == 1200 && a.stats.ignored == 1, "every frame reaches ingest");
+    check(std::fabs(a.snap.ias - 39.98f) < 1e-3f, "final IAS from the last frame");
+    check(a.stats.publishes == b.stats.publishes && a.snap.ias == b.snap.ias && a.snap.alt == b.snap.alt,
+          "two flat-out replays are identical");
+    check(a.snap.rx_ms[static_cast<std::size_t>(FlightSignal::Ias)] -
+              a.snap.rx_ms[static_cast<std::size_t>(FlightSignal::Alt)] == 80,
+          "timestamps follow the trace, not the wall clock");
+
+    const double speed = 100.0;
+    const ReplayOutcome c = replay(speed);
+    std::printf("speed %.0fx: %.2f s of trace in %.3f s\n", speed, c.result.trace_seconds, c.result.wall_seconds);
+    check(c.result.wall_seconds >= 0.19 && c.result.wall_seconds < 0.5, "paced replay takes trace time / speed");
+    check(c.snap.ias == a.snap.ias, "paced replay ends in the same state");
+
+    std::remove(kTracePath);
+}
+
+int main()
+{
+    test_round_trip();
+    test_replay_modes();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "../src/circling_wind.hpp"
+#include "../src/derived_quantities.hpp"
+#include "test_support.hpp"
+
+// Circling wind estimator (src/circling_wind.hpp) on synthetic GPS traces:
+// accuracy for several winds and noise levels, straight flight, a wind
+// change between thermals, the hand-over in DerivedQuantities and the cost
+// per GPS sample.
+
+constexpr double kRad = 3.14159265358979323846 / 180.0;
+
+// Glider at constant TAS turning at turn_rate deg/s (0 = straight) in a
+// wind coming from wind_from, sampled by a GPS every dt_ms with Gaussian
+// noise on each velocity component.
+struct Trace
+{
+    float tas = 25.0f;
+    float turn_rate = 18.0f;
+    float wind_speed = 5.0f;
+    float wind_from = 270.0f;
+    float noise = 0.0f;
+    uint32_t dt_ms = 250;
+
+    double heading = 0;
+    uint32_t t_ms = 1000;
+    std::mt19937 rng{42};
+
+    void step(float& gs, float& track)
+    {
+        std::normal_distribution<float> n(0.0f, noise > 0 ? noise : 1e-9f);
+        const double north = tas * std::cos(heading * kRad) - wind_speed * std::cos(wind_from * kRad) + n(rng);
+        const double east = tas * std::sin(heading * kRad) - wind_speed * std::sin(wind_from * kRad) + n(rng);
+        gs = static_cast<float>(std::sqrt(north * north + east * east));
+        track = static_cast<float>(std::fmod(std::atan2(east, north) / kRad + 360.0, 360.0));
+        heading = std::fmod(heading + turn_rate * dt_ms / 1000.0 + 360.0, 360.0);
+        t_ms += dt_ms;
+    }
+
+    void feed(CirclingWind& w, float seconds)
+    {
+        for (uint32_t i = 0; i < seconds * 1000 / dt_ms; ++i)
+        {
+            float gs, track;
+            step(gs, track);
+            w.add(gs, track, t_ms);
+        }
+    }
+};
+
+static void test_accuracy()
+{
+    std::printf("\n--- Accuracy ---\n");
+    struct Case
+    {
+        float wind_speed, wind_from, turn_rate, noise;
+        uint32_t dt_ms;
+        const char* name;
+    };
+    const Case cases[] = {
+        {5, 270, 18, 0, 250, "5 m/s from W, clean 4 Hz"},
+        {12, 45, -15, 0, 1000, "12 m/s from NE, left turns, 1 Hz"},
+        {8, 180, 20, 0.5f, 200, "8 m/s from S, 0.5 m/s noise, 5 Hz"},
+        {2, 330, 14, 0.3f, 500, "2 m/s from NNW, 0.3 m/s noise, 2 Hz"},
+    };
+    for (const Case& c : cases)
+    {
+        Trace t;
+        t.wind_speed = c.wind_speed;
+        t.wind_from = c.wind_from;
+        t.turn_rate = c.turn_rate;
+        t.noise = c.noise;
+        t.dt_ms = c.dt_ms;
+        CirclingWind w;
+        t.feed(w, 60); // about three turns
+        const CirclingWind::Estimate e = w.estimate(t.t_ms);
+        std::printf("%s: %.2f m/s from %.1f deg, q=%u, radius %.1f\n", c.name, e.speed, e.direction, e.quality,
+                    e.radius);
+        const bool ok = e.valid && w.circling() && std::fabs(e.speed - c.wind_speed) < 0.5f &&
+                        angle_diff(e.direction, c.wind_from) < (c.wind_speed < 3 ? 15.0f : 5.0f) &&
+                        std::fabs(e.radius - t.tas) < 1.0f;
+        check(ok, c.name);
+    }
+}
+
+static void test_phases()
+{
+    std::printf("\n--- Circling phases ---\n");
+    Trace t;
+    CirclingWind w;
+    t.turn_rate = 0;
+    t.feed(w, 60);
+    check(!w.circling() && !w.estimate(t.t_ms).valid, "no estimate in straight flight");
+
+    t.turn_rate = 18;
+    t.feed(w, 15);
+    check(w.circling() && !w.estimate(t.t_ms).valid, "no estimate before a full turn");
+    t.feed(w, 10);
+    const CirclingWind::Estimate one = w.estimate(t.t_ms);
+    const float one_turned = w.turned_deg();
+    t.feed(w, 20);
+    const CirclingWind::Estimate two = w.estimate(t.t_ms);
+    std::printf("quality after %.0f deg: %u, after %.0f deg: %u\n", one_turned, one.quality, w.turned_deg(),
+                two.quality);
+    check(one.valid && two.valid && two.quality > one.quality && two.quality >= 90, "quality grows with turns");
+
+    t.turn_rate = 0;
+    t.feed(w, 30);
+    const CirclingWind::Estimate held = w.estimate(t.t_ms);
+    check(!w.circling() && held.valid && held.quality < two.quality && std::fabs(held.speed - 5) < 0.5f,
+          "estimate held and decaying after leaving the thermal");
+    check(!w.estimate(t.t_ms + CirclingWind::kHoldMs).valid, "held estimate expires");
+
+    // Next thermal, different wind.
+    t.wind_speed = 10;
+    t.wind_from = 300;
+    t.turn_rate = -18;
+    t.feed(w, 50);
+    const CirclingWind::Estimate next = w.estimate(t.t_ms);
+    check(next.valid && std::fabs(next.speed - 10) < 0.5f && angle_diff(next.direction, 300) < 5,
+          "new thermal gives the new wind");
+}
+
+static void test_derived_hand_over()
+{
+    std::printf("\n--- DerivedQuantities ---\n");
+    DerivedQuantities d;
+    FlightSnapshot s;
+    Trace t;
+    constexpr SignalMask kGps = signal_mask(FlightSignal::GpsGroundSpeed, FlightSignal::GpsTrueTrack);
+    SignalMask out = 0;
+    for (int i = 0; i < 240; ++i)
+    {
+        t.step(s.gps_ground_speed, s.gps_true_track);
+        s.rx_ms[static_cast<std::size_t>(FlightSignal::GpsGroundSpeed)] = t.t_ms;
+        s.rx_ms[static_cast<std::size_t>(FlightSignal::GpsTrueTrack)] = t.t_ms;
+        out = d.update(s, kGps, t.t_ms);
+    }
+    check((out & signal_mask(FlightSignal::WindSpeed)) && s.wind_source == WindSource::Circling &&
+              std::fabs(s.wind_speed - 5) < 0.5f && angle_diff(s.wind_direction, 270) < 5 && s.wind_quality > 50,
+          "circling wind published without heading or TAS");
+}
+
+static void bench()
+{
+    std::printf("\n--- Cost per GPS sample ---\n");
+    Trace t;
+    t.noise = 0.3f;
+    constexpr int kSamples = 400000;
+    static float gs[kSamples], track[kSamples];
+    static uint32_t ms[kSamples];
+    for (int i = 0; i < kSamples; ++i)
+    {
+        t.step(gs[i], track[i]);
+        ms[i] = t.t_ms;
+    }
+    CirclingWind w;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kSamples; ++i) w.add(gs[i], track[i], ms[i]);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kSamples;
+    const CirclingWind::Estimate e = w.estimate(t.t_ms);
+    std::printf("%.0f ns per sample, %zu bytes of state, final %.2f m/s from %.1f deg\n", ns, sizeof(CirclingWind),
+                e.speed, e.direction);
+    check(ns < 1000, "constant, small cost per sample");
+    check(e.valid && std::fabs(e.speed - 5) < 0.5f, "still accurate after a long run");
+}
+
+int main()
+{
+    test_accuracy();
+    test_phases();
+    test_derived_hand_over();
+    bench();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
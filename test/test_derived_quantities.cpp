@@ -0,0 +1,218 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "../src/can_ingest.hpp"
+#include "../src/derived_quantities.hpp"
+#include "../src/fast_trig.hpp"
+#include "test_support.hpp"
+
+// Derived flight values (src/derived_quantities.hpp): table trig, TAS from
+// IAS and altitude, the wind triangle, which rules run for which frames when
+// wired into CanIngest, and the per-sample IAS trend.
+
+static void test_trig()
+{
+    std::printf("\n--- Table trig ---\n");
+    constexpr double kRad = 3.14159265358979323846 / 180.0;
+    double sin_err = 0, atan_err = 0;
+    for (int i = -7200; i <= 7200; ++i)
+    {
+        const float deg = i * 0.137f;
+        sin_err = std::fmax(sin_err, std::fabs(fast_trig::sin_deg(deg) - std::sin(deg * kRad)));
+        sin_err = std::fmax(sin_err, std::fabs(fast_trig::cos_deg(deg) - std::cos(deg * kRad)));
+        const float x = std::cos(deg * kRad) * 3;
+        const float y = std::sin(deg * kRad) * 3;
+        atan_err = std::fmax(atan_err, angle_diff(fast_trig::atan2_deg(y, x), fast_trig::wrap_deg(deg)));
+    }
+    std::printf("max error: sin/cos %.2g, atan2 %.2g deg\n", sin_err, atan_err);
+    check(sin_err < 2e-5, "sin/cos within 2e-5");
+    check(atan_err < 1e-3, "atan2 within 0.001 deg");
+    check(fast_trig::atan2_deg(0, 1) == 0 && fast_trig::atan2_deg(1, 0) == 90 && fast_trig::atan2_deg(0, -1) == 180 &&
+              fast_trig::atan2_deg(-1, 0) == 270,
+          "axes exact");
+}
+
+static void test_tas()
+{
+    std::printf("\n--- TAS factor ---\n");
+    check(std::fabs(DerivedQuantities::tas_factor(0) - 1.0f) < 1e-5f, "sea level 1.0");
+    // ISA density ratio 0.7421 at 3000 m, 0.3369 at 10000 m.
+    check(std::fabs(DerivedQuantities::tas_factor(3000) - 1.0f / std::sqrt(0.7421f)) < 1e-3f, "3000 m");
+    check(std::fabs(DerivedQuantities::tas_factor(10000) - 1.0f / std::sqrt(0.3369f)) < 2e-3f, "10000 m");
+    check(std::fabs(DerivedQuantities::tas_factor(1125) - 1.0564f) < 1e-3f, "interpolated between table steps");
+    check(DerivedQuantities::tas_factor(40000) == DerivedQuantities::tas_factor(15000), "clamped above the table");
+}
+
+static void test_wind_triangle()
+{
+    std::printf("\n--- Wind triangle ---\n");
+    // Heading north at 30 m/s while the ground track is due east at 30 m/s.
+    DerivedQuantities::Wind w = DerivedQuantities::wind_triangle(30, 0, 30, 90);
+    check(std::fabs(w.speed - 42.426f) < 0.01f && angle_diff(w.direction, 315) < 0.01f, "wind from the north-west");
+    w = DerivedQuantities::wind_triangle(30, 90, 20, 90);
+    check(std::fabs(w.speed - 10) < 0.01f && angle_diff(w.direction, 90) < 0.01f, "headwind from the east");
+    w = DerivedQuantities::wind_triangle(30, 200, 30, 200);
+    check(w.speed < 0.01f, "calm");
+}
+
+struct Rig
+{
+    FlightData data;
+    CanIngest ingest{data};
+    DerivedQuantities derived;
+    uint8_t code = 0;
+    Rig() { ingest.set_derived(&derived); }
+
+    void send(uint32_t id, float value, uint64_t ms)
+    {
+        uint8_t frame[8];
+        make_frame(frame, CanAerospaceType::Float, code++, value);
+        ingest.on_frame(id, 8, frame, ms);
+    }
+    SignalMask publish()
+    {
+        data.take_changes(kAllSignals);
+        ingest.publish();
+        return data.take_changes(kAllSignals);
+    }
+};
+
+static void test_graph()
+{
+    std::printf("\n--- Dependency graph ---\n");
+    constexpr SignalMask kWind = signal_mask(FlightSignal::WindSpeed, FlightSignal::WindDirection);
+    Rig r;
+    r.send(315, 30.0f, 1000); // IAS
+    check(r.publish() == signal_mask(FlightSignal::Ias), "IAS alone derives nothing");
+
+    r.send(322, 3000.0f, 1010); // altitude
+    SignalMask m = r.publish();
+    FlightSnapshot s = r.data.snapshot();
+    check(m == signal_mask(FlightSignal::Alt, FlightSignal::Tas), "altitude completes TAS");
+    check(std::fabs(s.tas - 30.0f * DerivedQuantities::tas_factor(3000)) < 1e-4f && s.received_ms(FlightSignal::Tas) == 1010,
+          "TAS value and receive time");
+
+    r.send(354, 1.5f, 1020); // vario
+    check(r.publish() == signal_mask(FlightSignal::Vario), "unrelated signal runs no rule");
+
+    r.send(321, 0.0f, 1030);   // heading north
+    r.send(1039, 40.0f, 1030); // GS
+    r.send(1040, 90.0f, 1030); // track east
+    m = r.publish();
+    s = r.data.snapshot();
+    check((m & kWind) == kWind, "GPS and heading derive wind");
+    DerivedQuantities::Wind w = DerivedQuantities::wind_triangle(s.tas, 0, 40, 90);
+    check(std::fabs(s.wind_speed - w.speed) < 1e-3f && angle_diff(s.wind_direction, w.direction) < 0.01f,
+          "first estimate is the raw triangle");
+    check(r.derived.active() == (kWind | signal_mask(FlightSignal::Tas)), "active outputs");
+
+    r.send(316, 35.0f, 1040); // TAS from the bus
+    m = r.publish();
+    check(r.data.snapshot().tas == 35.0f && (m & kWind) == kWind, "bus TAS wins and feeds the wind rule");
+    r.send(315, 31.0f, 1050);
+    r.publish();
+    check(r.data.snapshot().tas == 35.0f, "fresh bus TAS is not overwritten");
+    check(!(r.derived.active() & signal_mask(FlightSignal::Tas)), "TAS no longer derived");
+
+    r.send(333, 5.0f, 1060);
+    r.send(334, 270.0f, 1060);
+    r.publish();
+    r.send(1039, 41.0f, 1070);
+    m = r.publish();
+    s = r.data.snapshot();
+    check(!(m & kWind) && s.wind_speed == 5.0f && s.wind_direction == 270.0f, "wind frames suppress the estimate");
+
+    r.send(1039, 42.0f, 12000); // bus wind, bus TAS and heading now stale
+    m = r.publish();
+    check(!(m & kWind), "stale inputs derive nothing");
+    r.send(315, 30.0f, 12010);
+    r.send(322, 3000.0f, 12010);
+    r.send(321, 0.0f, 12010);
+    r.send(1040, 90.0f, 12010);
+    m = r.publish();
+    check((m & kWind) == kWind && (m & signal_mask(FlightSignal::Tas)), "estimate resumes once bus wind times out");
+}
+
+static void test_ias_trend()
+{
+    std::printf("\n--- IAS trend ---\n");
+    Rig r;
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    // 10 s steady at 25 m/s, then 8 s accelerating at 1 m/s^2, IAS at 20 Hz.
+    uint64_t ms = 1000;
+    for (int i = 0; i < 200; ++i, ms += 50) r.send(315, 25.0f + noise(rng), ms);
+    r.publish();
+    const float steady = r.data.snapshot().ias_rate;
+    float ias = 25.0f;
+    for (int i = 0; i < 160; ++i, ms += 50)
+    {
+        ias += 0.05f;
+        r.send(315, ias + noise(rng), ms);
+    }
+    r.publish();
+    const float accel = r.data.snapshot().ias_rate;
+    std::printf("steady %.3f m/s^2, accelerating %.3f m/s^2\n", steady, accel);
+    check(std::fabs(steady) < 0.15f, "steady flight shows no trend");
+    check(std::fabs(accel - 1.0f) < 0.15f, "constant acceleration tracked");
+
+    // Every sample counts, not only the one visible at publish time.
+    Rig batched;
+    ms = 1000;
+    ias = 25.0f;
+    for (int i = 0; i < 200; ++i, ms += 50)
+    {
+        ias += 0.05f;
+        batched.send(315, ias, ms);
+        if (i % 10 == 9) batched.publish();
+    }
+    check(std::fabs(batched.data.snapshot().ias_rate - 1.0f) < 0.05f, "publishing every 10th sample loses nothing");
+
+    batched.send(315, 40.0f, ms + 5000);
+    batched.publish();
+    check(batched.data.snapshot().ias_rate == 0.0f, "gap in IAS restarts the trend");
+}
+
+static void bench()
+{
+    std::printf("\n--- Cost per publish ---\n");
+    Rig r;
+    uint8_t ias[8], alt[8], hdg[8], gs[8], trk[8];
+    make_frame(ias, CanAerospaceType::Float, 0, 30.0f);
+    make_frame(alt, CanAerospaceType::Float, 0, 1500.0f);
+    make_frame(hdg, CanAerospaceType::Float, 0, 10.0f);
+    make_frame(gs, CanAerospaceType::Float, 0, 35.0f);
+    make_frame(trk, CanAerospaceType::Float, 0, 20.0f);
+    constexpr uint32_t kRounds = 1000000;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kRounds; ++i)
+    {
+        const uint64_t ms = 1000 + i / 10;
+        r.ingest.on_frame(315, 8, ias, ms);
+        r.ingest.on_frame(322, 8, alt, ms);
+        r.ingest.on_frame(321, 8, hdg, ms);
+        r.ingest.on_frame(1039, 8, gs, ms);
+        r.ingest.on_frame(1040, 8, trk, ms);
+        r.ingest.publish();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kRounds;
+    std::printf("%.0f ns per five frames + publish with TAS and wind derived (wind %.1f m/s)\n", ns,
+                r.data.snapshot().wind_speed);
+    check(ns < 5000, "derivation stays cheap");
+}
+
+int main()
+{
+    test_trig();
+    test_tas();
+    test_wind_triangle();
+    test_graph();
+    test_ias_trend();
+    bench();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
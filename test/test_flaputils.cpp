@@ -1,8 +1,35 @@
+#include <array>
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <new>
 #include <vector>
 #include "../src/flaputils.hpp"
+#include "../src/units.hpp"
+
+#ifdef NATIVE_TEST_BUILD
+// Heap tracing: every operator new is counted, so a test can show that a
+// call path allocates nothing.
+static long g_allocs = 0;
+
+void* operator new(std::size_t n)
+{
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+// get_flap_speed_ranges() as a vector, for checks that compare them.
+static std::vector<flaputils::FlapSpeedRange> ranges_at(float weight)
+{
+    std::array<flaputils::FlapSpeedRange, flaputils::kMaxFlapBands> buf;
+    return {buf.begin(), buf.begin() + flaputils::get_flap_speed_ranges(weight, buf)};
+}
 
 static int run_tests()
 {
@@ -52,15 +79,34 @@ static int run_tests()
         for (int idx : test_indices)
         {
             FlapSymbolResult res = get_flap_symbol(idx);
-            const char* sym = get_flap_symbol_name(res.index);
+            char buf[kSymbolSize];
+            const char* sym = get_flap_symbol_name(res.index, buf, sizeof(buf)) ? buf : nullptr;
             std::printf("Index %d -> Symbol: %s, Result Index: %d\n",
                         idx, sym ? sym : "None", res.index);
         }
     }
 
+    std::printf("\n--- Testing symbol name copies ---\n");
+    {
+        // Names are copied out of the polar, cut to the buffer given.
+        char buf[kSymbolSize] = "x";
+        const bool missing = !get_flap_symbol_name(-1, buf, sizeof(buf)) && buf[0] == '\0' &&
+                             !get_range_symbol_name(kMaxFlapBands, buf, sizeof(buf)) && buf[0] == '\0';
+        char full[kSymbolSize], cut[2];
+        int longest = -1;
+        for (int i = 0; get_flap_symbol_name(i, full, sizeof(full)); ++i)
+            if (std::strlen(full) >= 2) longest = i;
+        get_flap_symbol_name(longest, full, sizeof(full));
+        const bool truncated = longest >= 0 && get_flap_symbol_name(longest, cut, sizeof(cut)) &&
+                               cut[0] == full[0] && cut[1] == '\0';
+        const bool ok = missing && truncated;
+        if (!ok) ++fails;
+        std::printf("Unknown index empty, \"%s\" cut to \"%s\" %s\n", full, cut, ok ? "OK" : "NOK");
+    }
+
     std::printf("\n--- Testing get_flap_speed_ranges ---\n");
     {
-        auto params = get_flap_speed_ranges(get_empty_mass());
+        auto params = ranges_at(get_empty_mass());
 
         if (!loaded)
         {
@@ -86,7 +132,8 @@ static int run_tests()
 
             for (std::size_t i = 0; i < params.size(); ++i)
             {
-                const char* sym = get_range_symbol_name(params[i].index);
+                char buf[kSymbolSize];
+                const char* sym = get_range_symbol_name(params[i].index, buf, sizeof(buf)) ? buf : nullptr;
                 const bool entry_ok = (sym != nullptr) && (params[i].index >= 0);
                 if (!entry_ok) ok = false;
 
@@ -127,7 +174,8 @@ static int run_tests()
         for (const auto& tc : test_cases)
         {
             FlapSymbolResult res = get_optimal_flap(tc.w, tc.v);
-            const char* sym = get_range_symbol_name(res.index);
+            char buf[kSymbolSize];
+            const char* sym = get_range_symbol_name(res.index, buf, sizeof(buf)) ? buf : nullptr;
 
             bool ok = false;
             if (tc.expected)
@@ -155,7 +203,7 @@ static int run_tests()
     {
         if (!loaded)
         {
-            auto ranges = get_flap_speed_ranges(450.0f);
+            auto ranges = ranges_at(450.0f);
             if (!ranges.empty())
             {
                 ++fails;
@@ -187,11 +235,12 @@ static int run_tests()
 
             for (float test_weight : unique_weights)
             {
-                auto ranges = get_flap_speed_ranges(test_weight);
+                auto ranges = ranges_at(test_weight);
                 std::printf("Weight %.1f kg:\n", test_weight);
                 for (const auto& r : ranges)
                 {
-                    const char* sym = get_range_symbol_name(r.index);
+                    char buf[kSymbolSize];
+                    const char* sym = get_range_symbol_name(r.index, buf, sizeof(buf)) ? buf : nullptr;
                     std::printf("  Symbol: %4s, Index: %d, Range: [%6.1f, %6.1f]\n",
                                 sym ? sym : "None", r.index, r.lower_speed, r.upper_speed);
                 }
@@ -210,6 +259,137 @@ static int run_tests()
         }
     }
 
+    std::printf("\n--- Testing the band cache against a band scan ---\n");
+    if (loaded)
+    {
+        // The rule get_optimal_flap implemented before the cache: the
+        // low-speed band [0, 40] (flap "-1") first, then the first band of
+        // get_flap_speed_ranges() that contains the speed, ends included.
+        int lowspeed_flap = -1;
+        char sym[kSymbolSize];
+        for (int i = 0; get_flap_symbol_name(i, sym, sizeof(sym)); ++i)
+            if (std::strcmp(sym, "-1") == 0 && lowspeed_flap < 0) lowspeed_flap = i;
+        auto scan = [&](const std::vector<FlapSpeedRange>& ranges, float v)
+        {
+            if (v >= 0.0f && v <= 40.0f) return lowspeed_flap;
+            for (const auto& r : ranges)
+                if (r.lower_speed >= 0.0f && v >= r.lower_speed && v <= r.upper_speed) return r.index;
+            return -1;
+        };
+
+        int checked = 0, mismatches = 0;
+        for (float w = 350.0f; w <= 650.0f; w += 0.5f)
+        {
+            const auto ranges = ranges_at(w);
+            std::vector<float> speeds = {-1.0f, 0.0f, 300.0f, 1000.0f, NAN};
+            for (const auto& r : ranges)
+                for (float end : {r.lower_speed, r.upper_speed})
+                    speeds.insert(speeds.end(), {std::nextafter(end, -INFINITY), end, std::nextafter(end, INFINITY)});
+            for (float v = 20.0f; v <= 290.0f; v += 0.37f) speeds.push_back(v);
+            for (float v : speeds)
+            {
+                ++checked;
+                if (get_optimal_flap(w, v).index != scan(ranges, v)) ++mismatches;
+            }
+        }
+
+        // Weights within one 0.5 kg quantum share their bands.
+        const auto a = ranges_at(500.0f), b = ranges_at(500.2f);
+        bool shared = a.size() == b.size();
+        for (std::size_t i = 0; shared && i < a.size(); ++i)
+            shared = a[i].lower_speed == b[i].lower_speed && a[i].upper_speed == b[i].upper_speed;
+
+        // A reload replaces the cached bands: 130 km/h at 520 kg is "0" in
+        // this polar and "-1" (band 4, 123..136) in ventus3_3T_SE.
+        const bool cached = get_optimal_flap(520.0f, 130.0f).index == 3;
+        const bool other = load_data("spiffs_data/ventus3_3T_SE.json") && get_optimal_flap(520.0f, 130.0f).index == 4 &&
+                           ranges_at(520.0f).at(4).lower_speed == 123.0f;
+        const bool reloaded = cached && other && load_data("spiffs_data/ventus3_defaut.json") &&
+                              get_optimal_flap(520.0f, 130.0f).index == 3;
+
+        if (mismatches == 0 && shared && reloaded)
+        {
+            std::printf("OK: %d lookups match the band scan\n", checked);
+        }
+        else
+        {
+            ++fails;
+            std::printf("NOK: band cache: %d of %d lookups differ, shared=%d, reloaded=%d\n", mismatches, checked,
+                        shared, reloaded);
+        }
+    }
+
+#ifdef NATIVE_TEST_BUILD
+    std::printf("\n--- Testing allocations on the lookup path ---\n");
+    if (loaded)
+    {
+        // What screen2 and screen4 do per tick, with a ballast dump every
+        // step so the band cache is rebuilt each time.
+        std::array<FlapSpeedRange, 31> screen2;
+        std::array<FlapSpeedRange, 3> shortbuf;
+        (void)get_flap_speed_ranges(450.0f, screen2);
+        (void)get_optimal_flap(450.0f, 100.0f);
+
+        const long before = g_allocs;
+        std::size_t total = 0, clamped = 0;
+        int flaps = 0;
+        for (float w = 600.0f; w >= 350.0f; w -= 0.25f)
+        {
+            total += get_flap_speed_ranges(w, screen2);
+            clamped += get_flap_speed_ranges(w, shortbuf);
+            for (float v = 40.0f; v <= 280.0f; v += 10.0f) flaps += get_optimal_flap(w, v).index >= 0;
+            char sym[kSymbolSize];
+            flaps += get_range_symbol_name(get_optimal_flap(w, 120.0f).index, sym, sizeof(sym));
+        }
+        const long allocs = g_allocs - before;
+
+        const bool first_bands = shortbuf[0].index == screen2[0].index && shortbuf[2].upper_speed == screen2[2].upper_speed;
+        if (allocs == 0 && total == 1001 * 8 && clamped == 1001 * 3 && first_bands && flaps > 0)
+        {
+            std::printf("OK: %zu ranges and %d flaps over 1001 weights, 0 allocations\n", total, flaps);
+        }
+        else
+        {
+            ++fails;
+            std::printf("NOK: %ld allocations, %zu ranges, %zu clamped, first bands %d\n", allocs, total, clamped,
+                        first_bands);
+        }
+    }
+#endif
+
+    std::printf("\n--- Testing get_display_speed_limits ---\n");
+    {
+        const SpeedLimits kmh = get_speed_limits();
+        const SpeedLimits same = get_display_speed_limits();
+        const uint32_t gen = units::generation();
+
+        units::set(units::SpeedUnit::Knots, units::AltitudeUnit::Feet);
+        const SpeedLimits& kt = get_display_speed_limits();
+        std::printf("Vne %.1f km/h = %.1f kt\n", kmh.vne, kt.vne);
+        const bool converted = std::fabs(kt.vne - kmh.vne / 1.852f) < 0.01f &&
+                               std::fabs(kt.vso - kmh.vso / 1.852f) < 0.01f;
+        const bool cached = &get_display_speed_limits() == &kt && kt.vne == get_display_speed_limits().vne;
+        units::set(units::SpeedUnit::Kmh, units::AltitudeUnit::Meter);
+        const bool restored = get_display_speed_limits().vne == kmh.vne && units::generation() != gen;
+
+        if (same.vne == kmh.vne && converted && cached && restored)
+        {
+            std::printf("OK: limits converted once per unit change\n");
+        }
+        else
+        {
+            ++fails;
+            std::printf("NOK: display speed limits\n");
+        }
+
+        static_assert(units::speed_from_ms<units::SpeedUnit::Knots>(10.0f) > 19.43f &&
+                      units::speed_from_ms<units::SpeedUnit::Knots>(10.0f) < 19.44f);
+        static_assert(units::speed_from_kmh<units::SpeedUnit::Mph>(160.9344f) > 99.99f &&
+                      units::speed_from_kmh<units::SpeedUnit::Mph>(160.9344f) < 100.01f);
+        static_assert(units::altitude_from_m<units::AltitudeUnit::Feet>(1000.0f) > 3280.8f &&
+                      units::altitude_from_m<units::AltitudeUnit::Feet>(1000.0f) < 3280.9f);
+    }
+
     std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
     return fails;
 }
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "../src/can_dispatch.hpp"
+#include "../src/flight_codec.hpp"
+#include "test_support.hpp"
+
+// FLIGHT_SIGNALS schema (src/flight_schema.hpp): the generated decoder
+// table and timeouts, binary log record round trip, telemetry lines, the
+// debug printer and the cost of encoding.
+
+static FlightSnapshot sample()
+{
+    FlightSnapshot s;
+    s.ias = 27.5f;
+    s.tas = 29.25f;
+    s.heading = 123.4f;
+    s.alt = 1500.5f;
+    s.alt_corr = -12.0f;
+    s.vario = 1.75f;
+    s.flapIdx = 4;
+    s.gps_ground_speed = 31.0f;
+    s.gps_true_track = 270.0f;
+    s.wind_speed = 5.5f;
+    s.wind_direction = 315.0f;
+    s.enl = 120;
+    s.dry_and_ballast_mass = 5255;
+    s.rx_ms[static_cast<std::size_t>(FlightSignal::Ias)] = 100;
+    s.rx_ms[static_cast<std::size_t>(FlightSignal::Mass)] = 200;
+    s.out_of_range = signal_mask(FlightSignal::Vario);
+    return s;
+}
+
+static void test_tables()
+{
+    std::printf("\n--- Generated tables ---\n");
+    check(can_dispatch::kSignals.size() == kFlightSignalCount, "one decoder entry per signal");
+
+    bool sorted = true;
+    for (std::size_t i = 1; i < can_dispatch::kSignals.size(); ++i)
+        sorted = sorted && can_dispatch::kSignals[i - 1].id < can_dispatch::kSignals[i].id;
+    check(sorted, "decoder table sorted by id");
+
+    const CanSignal* mass = can_dispatch::find(1515);
+    const CanSignal* flap = can_dispatch::find(340);
+    const CanSignal* ias = can_dispatch::find(315);
+    check(mass && mass->signal == FlightSignal::Mass && mass->min_dlc == 6 &&
+              mass->data_type == CanAerospaceType::UShort,
+          "1515 -> Mass, UShort, DLC 6");
+    check(flap && flap->signal == FlightSignal::Flap && flap->min_dlc == 6, "340 -> Flap, DLC 6");
+    check(ias && ias->signal == FlightSignal::Ias && ias->min_dlc == 8, "315 -> Ias, DLC 8");
+
+    uint8_t frame[8] = {1, static_cast<uint8_t>(CanAerospaceType::UShort), 0, 0, 0x14, 0x87, 0, 0};
+    FlightSnapshot s;
+    check(mass->apply(s, frame) == SampleCheck::Ok && s.dry_and_ballast_mass == 0x1487,
+          "generated store writes the schema field");
+    frame[4] = 0;
+    check(mass->apply(s, frame) == SampleCheck::OutOfRange && s.dry_and_ballast_mass == 0x1487,
+          "out-of-range sample leaves the field alone");
+
+    check(kDefaultSignalTimeouts.ms[static_cast<std::size_t>(FlightSignal::Mass)] == SignalTimeouts::kNoTimeout &&
+              kDefaultSignalTimeouts.ms[static_cast<std::size_t>(FlightSignal::AltCorr)] == SignalTimeouts::kNoTimeout &&
+              kDefaultSignalTimeouts.ms[static_cast<std::size_t>(FlightSignal::Vario)] ==
+                  SignalTimeouts::kPeriodicTimeoutMs,
+          "staleness classes map to timeouts");
+}
+
+static void test_record()
+{
+    std::printf("\n--- Log records ---\n");
+    std::printf("record: %zu bytes, schema %08lx\n", flight_codec::kRecordSize,
+                static_cast<unsigned long>(flight_codec::kRecordSchema));
+    check(flight_codec::kRecordSize == 16 + 10 * 4 + 4 + 2 * 2 + 2 * 4, "record size from the field types");
+
+    const FlightSnapshot in = sample();
+    uint8_t buf[flight_codec::kRecordSize];
+    flight_codec::encode_record(in, 4242, buf);
+
+    FlightSnapshot out;
+    uint32_t t = 0;
+    const SignalMask received = flight_codec::decode_record(buf, out, t);
+    check(t == 4242 && received == signal_mask(FlightSignal::Ias, FlightSignal::Mass) &&
+              out.out_of_range == in.out_of_range && out.decode_error == 0,
+          "header round trip");
+    check(out.ias == in.ias && out.tas == in.tas && out.heading == in.heading && out.alt == in.alt &&
+              out.alt_corr == in.alt_corr && out.vario == in.vario && out.flapIdx == in.flapIdx &&
+              out.gps_ground_speed == in.gps_ground_speed && out.gps_true_track == in.gps_true_track &&
+              out.wind_speed == in.wind_speed && out.wind_direction == in.wind_direction && out.enl == in.enl &&
+              out.dry_and_ballast_mass == in.dry_and_ballast_mass,
+          "every schema field round trips");
+}
+
+static void test_telemetry()
+{
+    std::printf("\n--- Telemetry ---\n");
+    const FlightSnapshot s = sample();
+    char line[256];
+    std::size_t n = flight_codec::encode_telemetry(s, signal_mask(FlightSignal::Ias, FlightSignal::Mass,
+                                                                  FlightSignal::Flap),
+                                                   1000, line, sizeof(line));
+    std::printf("%s", line);
+    check(n == std::strlen(line) && std::strncmp(line, "$FSD,1000,ias=27.50,flapIdx=4,dry_and_ballast_mass=525.5*", 56) == 0,
+          "only the requested signals, scaled, in schema order");
+    uint8_t x = 0;
+    const char* star = std::strchr(line, '*');
+    for (const char* c = line + 1; c < star; ++c) x ^= static_cast<uint8_t>(*c);
+    unsigned sent = 0;
+    check(star && std::sscanf(star + 1, "%2X", &sent) == 1 && sent == x && line[n - 2] == '\r' && line[n - 1] == '\n',
+          "checksum and line end");
+
+    n = flight_codec::encode_telemetry(s, kAllSignals, 1000, line, sizeof(line));
+    check(n > 0 && std::strstr(line, "wind_direction=315.0,enl=120,"), "full line fits 256 bytes");
+    check(flight_codec::encode_telemetry(s, kAllSignals, 1000, line, 40) == 0, "too small a buffer gives 0");
+}
+
+static void test_printer()
+{
+    std::printf("\n--- Debug printer ---\n");
+    std::FILE* f = std::tmpfile();
+    flight_codec::print_values(sample(), f);
+    char text[512] = {};
+    std::rewind(f);
+    const std::size_t len = std::fread(text, 1, sizeof(text) - 1, f);
+    std::fclose(f);
+    std::printf("%.*s\n", static_cast<int>(len), text);
+    check(std::strstr(text, "ias=27.50 m/s ") && std::strstr(text, "vario=1.75 m/s ") &&
+              std::strstr(text, "dry_and_ballast_mass=525.5 kg ") && std::strstr(text, "flapIdx=4 "),
+          "every field with unit and scale");
+}
+
+static void bench()
+{
+    std::printf("\n--- Cost ---\n");
+    FlightSnapshot s = sample();
+    uint8_t buf[flight_codec::kRecordSize];
+    char line[256];
+    constexpr int kRounds = 1000000;
+    uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRounds; ++i)
+    {
+        s.ias = static_cast<float>(i);
+        flight_codec::encode_record(s, static_cast<uint32_t>(i), buf);
+        sink += buf[flight_codec::kRecordHeaderSize];
+    }
+    const double record_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kRounds;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRounds / 10; ++i)
+    {
+        s.ias = static_cast<float>(i);
+        sink += static_cast<uint32_t>(flight_codec::encode_telemetry(s, signal_mask(FlightSignal::Ias), i, line, sizeof(line)));
+    }
+    const double line_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (kRounds / 10);
+    std::printf("%.0f ns per record, %.0f ns per one-signal telemetry line (%u)\n", record_ns, line_ns, sink & 1);
+    check(record_ns < 200, "record encoding is a handful of copies");
+}
+
+int main()
+{
+    test_tables();
+    test_record();
+    test_telemetry();
+    test_printer();
+    bench();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "../src/can_ingest.hpp"
+#include "../src/derived_quantities.hpp"
+#include "../src/geo.hpp"
+#include "test_support.hpp"
+
+// GPS position path: great-circle distance and bearing on fixed-point
+// positions (src/geo.hpp) against a double-precision reference, the position
+// IDs decoded by CanIngest, the ground vector and home fix derived from them,
+// circling wind from positions alone, and the cost per call.
+
+constexpr double kRad = 3.14159265358979323846 / 180.0;
+
+static geo::Position pos(double lat, double lon)
+{
+    return {static_cast<int32_t>(std::lround(lat * 1e7)), static_cast<int32_t>(std::lround(lon * 1e7))};
+}
+
+// Haversine and initial bearing in double, same radius.
+static void reference(geo::Position a, geo::Position b, double& distance, double& bearing)
+{
+    const double lat1 = a.lat_e7 * 1e-7 * kRad, lat2 = b.lat_e7 * 1e-7 * kRad;
+    const double dlat = lat2 - lat1;
+    const double dlon = (static_cast<double>(b.lon_e7) - a.lon_e7) * 1e-7 * kRad;
+    const double h = std::pow(std::sin(dlat / 2), 2) + std::cos(lat1) * std::cos(lat2) * std::pow(std::sin(dlon / 2), 2);
+    distance = 2 * geo::kEarthRadiusM * std::asin(std::sqrt(h));
+    bearing = std::atan2(std::sin(dlon) * std::cos(lat2),
+                         std::cos(lat1) * std::sin(lat2) - std::sin(lat1) * std::cos(lat2) * std::cos(dlon)) / kRad;
+    if (bearing < 0) bearing += 360;
+}
+
+static void test_distance_bearing()
+{
+    std::printf("\n--- Distance and bearing ---\n");
+    const geo::Position paris = pos(48.8566, 2.3522);
+    const geo::Position london = pos(51.5074, -0.1278);
+    const geo::Vector v = geo::distance_bearing(paris, london);
+    std::printf("Paris -> London: %.1f km, %.2f deg\n", v.distance_m / 1000, v.bearing_deg);
+    check(std::fabs(v.distance_m - 343560) < 200 && angle_diff(v.bearing_deg, 330.0f) < 0.5f, "Paris -> London");
+
+    const geo::Position home = pos(47.3769, 8.5417);
+    check(std::fabs(geo::distance_bearing(home, pos(47.3769 + 100 / 111195.0, 8.5417)).distance_m - 100) < 0.1f &&
+              angle_diff(geo::distance_bearing(home, pos(47.3769 + 100 / 111195.0, 8.5417)).bearing_deg, 0) < 0.1f,
+          "100 m north");
+    const geo::Vector east = geo::distance_bearing(home, pos(47.3769, 8.5417 + 1e-5));
+    check(std::fabs(east.distance_m - 0.7535f) < 0.002f && angle_diff(east.bearing_deg, 90) < 0.1f,
+          "0.75 m east, one float ulp of the latitude");
+    check(geo::distance_bearing(home, home).distance_m == 0, "same point");
+
+    const geo::Vector dateline = geo::distance_bearing(pos(-17.0, 179.9), pos(-17.0, -179.9));
+    check(std::fabs(dateline.distance_m - 21270) < 20 && angle_diff(dateline.bearing_deg, 90) < 0.1f,
+          "short leg across the date line");
+    check(geo::delta_lon_e7(1799999999, -1799999999) == 2 && geo::delta_lon_e7(-1799999999, 1799999999) == -2,
+          "longitude difference wraps");
+
+    // Random legs from 10 m to 2000 km against the double reference.
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> lat(-70, 70), lon(-180, 180), dir(0, 360), len(1, 6.3);
+    double worst_rel = 0, worst_bearing = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double la = lat(rng), lo = lon(rng), d = std::pow(10.0, len(rng)), b = dir(rng) * kRad;
+        const geo::Position a = pos(la, lo);
+        double lo2 = lo + d * std::sin(b) / (111195.0 * std::cos(la * kRad));
+        if (lo2 >= 180) lo2 -= 360;
+        if (lo2 < -180) lo2 += 360;
+        const geo::Position c = pos(la + d * std::cos(b) / 111195.0, lo2);
+        double ref_d, ref_b;
+        reference(a, c, ref_d, ref_b);
+        const geo::Vector g = geo::distance_bearing(a, c);
+        worst_rel = std::fmax(worst_rel, std::fabs(g.distance_m - ref_d) / ref_d);
+        worst_bearing = std::fmax(worst_bearing, angle_diff(g.bearing_deg, static_cast<float>(ref_b)));
+    }
+    std::printf("10 m .. 2000 km: worst distance error %.2g relative, bearing %.3f deg\n", worst_rel, worst_bearing);
+    check(worst_rel < 1e-3 && worst_bearing < 0.1, "float haversine tracks the double reference");
+}
+
+struct Rig
+{
+    FlightData data;
+    CanIngest ingest{data};
+    DerivedQuantities derived;
+    uint8_t code = 0;
+    Rig() { ingest.set_derived(&derived); }
+
+    void send_position(geo::Position p, uint64_t ms)
+    {
+        for (const auto& [id, value] : {std::pair<uint32_t, int32_t>{1036, p.lat_e7}, {1037, p.lon_e7}})
+        {
+            const uint32_t raw = static_cast<uint32_t>(value);
+            const uint8_t frame[8] = {1, static_cast<uint8_t>(CanAerospaceType::DoubleL), 0, code++,
+                                      static_cast<uint8_t>(raw >> 24), static_cast<uint8_t>(raw >> 16),
+                                      static_cast<uint8_t>(raw >> 8), static_cast<uint8_t>(raw)};
+            ingest.on_frame(id, 8, frame, ms);
+        }
+        ingest.publish();
+    }
+};
+
+// Position after flying north/east metres from p (flat, for short steps).
+static geo::Position move(geo::Position p, double north, double east)
+{
+    const double lat = p.lat_e7 * 1e-7;
+    return pos(lat + north / 111195.0, p.lon_e7 * 1e-7 + east / (111195.0 * std::cos(lat * kRad)));
+}
+
+static void test_position_path()
+{
+    std::printf("\n--- Position through CanIngest ---\n");
+    Rig r;
+    geo::Position p = pos(47.3769, 8.5417);
+    r.send_position(pos(0, 0), 500);
+    check(!r.data.snapshot().has_home, "0/0 (no fix) is not taken as home");
+
+    r.send_position(p, 1000);
+    FlightSnapshot s = r.data.snapshot();
+    check(s.lat == p.lat_e7 && s.lon == p.lon_e7, "1036/1037 decoded in 1e-7 deg");
+    check(s.has_home && s.home_lat == p.lat_e7 && s.home_lon == p.lon_e7, "first fix is home");
+
+    // Straight east at 30 m/s, 2 Hz fixes.
+    for (uint32_t t = 1500; t <= 10000; t += 500)
+    {
+        p = move(p, 0, 15);
+        r.send_position(p, t);
+    }
+    s = r.data.snapshot();
+    std::printf("GS %.2f m/s, track %.2f deg\n", s.gps_ground_speed, s.gps_true_track);
+    check(std::fabs(s.gps_ground_speed - 30) < 0.1f && angle_diff(s.gps_true_track, 90) < 0.2f,
+          "ground vector from positions");
+    check(s.received_ms(FlightSignal::GpsGroundSpeed) == 10000 && s.home_lat == pos(47.3769, 8.5417).lat_e7,
+          "derived GS is fresh, home stays");
+    const geo::Vector back = geo::distance_bearing({s.lat, s.lon}, {s.home_lat, s.home_lon});
+    check(std::fabs(back.distance_m - 270) < 1 && angle_diff(back.bearing_deg, 270) < 0.5f, "home is 270 m west");
+
+    // Circling at 25 m/s TAS, 30 s per turn, wind 5 m/s from 270.
+    double heading = 0;
+    for (uint32_t t = 10500; t <= 200000; t += 500)
+    {
+        heading += 6.0;
+        p = move(p, 12.5 * std::cos(heading * kRad), 12.5 * std::sin(heading * kRad) + 2.5);
+        r.send_position(p, t);
+    }
+    s = r.data.snapshot();
+    std::printf("wind %.2f m/s from %.1f deg, source %u, quality %u\n", s.wind_speed, s.wind_direction,
+                static_cast<unsigned>(s.wind_source), s.wind_quality);
+    check(s.wind_source == WindSource::Circling && std::fabs(s.wind_speed - 5) < 0.5f &&
+              angle_diff(s.wind_direction, 270) < 5,
+          "circling wind from positions alone");
+}
+
+static void bench()
+{
+    std::printf("\n--- Cost ---\n");
+    const geo::Position home = pos(47.3769, 8.5417);
+    constexpr int kRounds = 1000000;
+    float sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRounds; ++i)
+    {
+        const geo::Position p{home.lat_e7 + i * 37, home.lon_e7 - i * 53};
+        sink += geo::distance_bearing(p, home).distance_m;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kRounds;
+    std::printf("%.1f ns per distance/bearing (%.0f)\n", ns, sink / kRounds);
+    check(ns < 500, "cheap enough for every frame");
+}
+
+int main()
+{
+    test_distance_bearing();
+    test_position_path();
+    bench();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
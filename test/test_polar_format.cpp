@@ -0,0 +1,251 @@
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/flaputils.hpp"
+#include "../src/polar_format.hpp"
+#include "test_support.hpp"
+
+// Binary polar format: every polar in spiffs_data answers the same through a
+// mapped .fpol as through its JSON, and open() turns away damaged or foreign
+// files before anything reads them. Lookups running during reloads see
+// either polar whole, never a mix.
+
+static const char* kFpolPath = "test_polar_format.fpol";
+
+static const char* kPolars[] = {
+    "spiffs_data/ventus3_defaut.json",
+    "spiffs_data/ventus3_3T_SE.json",
+    "spiffs_data/ventus3_test.json",
+};
+
+static bool write_file(const char* path, const std::vector<uint8_t>& bytes)
+{
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    std::fclose(f);
+    return ok;
+}
+
+// Everything flaputils answers about the loaded polar, as text.
+static std::string answers()
+{
+    using namespace flaputils;
+    std::string out;
+    char line[160];
+    const SpeedLimits sl = get_speed_limits();
+    std::snprintf(line, sizeof(line), "%s mass %.3f limits %.1f %.1f %.1f %.1f %.1f\n", get_polar().c_str(), get_empty_mass(),
+                  sl.vso, sl.vfe, sl.vs1, sl.vno, sl.vne);
+    out += line;
+    for (int i = -1; i < 12; ++i)
+    {
+        char flap[kSymbolSize], band[kSymbolSize];
+        const bool has_flap = get_flap_symbol_name(i, flap, sizeof(flap));
+        const bool has_band = get_range_symbol_name(i, band, sizeof(band));
+        std::snprintf(line, sizeof(line), "%d %d %s %s\n", i, get_flap_symbol(i).index, has_flap ? flap : "-",
+                      has_band ? band : "-");
+        out += line;
+    }
+    std::array<FlapSpeedRange, kMaxFlapBands> ranges;
+    for (float w = 300; w <= 700; w += 7.3f)
+    {
+        for (const FlapSpeedRange& r : std::span(ranges.data(), get_flap_speed_ranges(w, ranges)))
+        {
+            std::snprintf(line, sizeof(line), "%.1f: %d %.6f %.6f\n", w, r.index, r.lower_speed, r.upper_speed);
+            out += line;
+        }
+        for (float v = 40; v <= 300; v += 1.3f)
+        {
+            std::snprintf(line, sizeof(line), "%d ", get_optimal_flap(w, v).index);
+            out += line;
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+static void test_same_answers()
+{
+    std::printf("\n--- JSON and .fpol answer the same ---\n");
+    for (const char* json : kPolars)
+    {
+        std::string error;
+        const std::vector<uint8_t> blob = fpol::from_json_file(json, &error);
+        check(!blob.empty() && write_file(kFpolPath, blob), json);
+
+        check(flaputils::load_data(json), "JSON loads");
+        std::string from_json = answers();
+        check(flaputils::load_data(kFpolPath), ".fpol maps");
+        std::string from_fpol = answers();
+
+        // Only the file name differs.
+        const std::size_t a = from_json.find(' '), b = from_fpol.find(' ');
+        check(from_json.substr(a) == from_fpol.substr(b) && from_json.size() > 10000, "identical lookups");
+        check(flaputils::get_polar() == kFpolPath, "name of the loaded file");
+        check(blob == fpol::from_json_file(json), "conversion is deterministic");
+    }
+}
+
+static void test_rejected()
+{
+    std::printf("\n--- Damaged and foreign files ---\n");
+    const std::vector<uint8_t> good = fpol::from_json_file(kPolars[0]);
+    fpol::View view;
+    check(fpol::open(good.data(), good.size(), view) == fpol::Error::None && view.valid(), "good blob opens");
+    check(std::strcmp(view.name(), "ventus3_defaut.json") == 0, "source name interned");
+
+    const uint8_t digits[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    check(fpol::crc32(digits, sizeof(digits)) == 0xCBF43926u, "CRC-32 check value");
+    check(fpol::crc32(digits + 4, 5, fpol::crc32(digits, 4)) == 0xCBF43926u, "CRC-32 in pieces");
+
+    struct Case
+    {
+        const char* what;
+        std::size_t offset; // byte to change, or size to cut to
+        bool truncate;
+        fpol::Error expected;
+    };
+    const Case cases[] = {
+        {"flipped range byte", good.size() / 2, false, fpol::Error::BadChecksum},
+        {"flipped last byte", good.size() - 1, false, fpol::Error::BadChecksum},
+        {"truncated", good.size() - 4, true, fpol::Error::BadSize},
+        {"header only", sizeof(fpol::Header) - 1, true, fpol::Error::TooSmall},
+        {"magic", offsetof(fpol::Header, magic), false, fpol::Error::BadMagic},
+        {"version", offsetof(fpol::Header, version), false, fpol::Error::BadVersion},
+        {"file size", offsetof(fpol::Header, file_size) + 1, false, fpol::Error::BadSize},
+        {"checksum", offsetof(fpol::Header, crc32), false, fpol::Error::BadChecksum},
+    };
+    for (const Case& c : cases)
+    {
+        std::vector<uint8_t> bad = good;
+        if (c.truncate) bad.resize(c.offset);
+        else bad[c.offset] ^= 0x5A;
+        const fpol::Error e = fpol::open(bad.data(), bad.size(), view);
+        std::printf("%s: %s\n", c.what, fpol::error_name(e));
+        check(e == c.expected && !view.valid(), c.what);
+    }
+
+    // A header whose sections point outside the file, with a valid CRC.
+    std::vector<uint8_t> layout = good;
+    fpol::Header h;
+    std::memcpy(&h, layout.data(), sizeof(h));
+    h.ranges_offset = h.file_size - 4;
+    std::memcpy(layout.data(), &h, sizeof(h));
+    check(fpol::open(layout.data(), layout.size(), view) == fpol::Error::BadLayout, "section past the end");
+
+    // A damaged file does not replace the polar in use.
+    check(flaputils::load_data(kPolars[0]), "JSON loads");
+    std::vector<uint8_t> bad = good;
+    bad[good.size() / 2] ^= 1;
+    write_file(kFpolPath, bad);
+    check(!flaputils::load_data(kFpolPath), "damaged .fpol refused");
+    check(flaputils::get_polar() == "ventus3_defaut.json" &&
+              flaputils::get_optimal_flap(500, 130).index == 3,
+          "previous polar still active");
+    check(!flaputils::load_data("spiffs_data/missing.fpol"), "missing .fpol refused");
+    check(fpol::from_json("{\"weights\": [", "x").empty(), "broken JSON refused");
+}
+
+// The bands at 520 kg as one string; a lookup that mixed two polars would
+// match neither.
+static std::string bands_520()
+{
+    std::array<flaputils::FlapSpeedRange, flaputils::kMaxFlapBands> ranges;
+    std::string out;
+    char line[64];
+    for (const flaputils::FlapSpeedRange& r : std::span(ranges.data(), flaputils::get_flap_speed_ranges(520, ranges)))
+    {
+        std::snprintf(line, sizeof(line), "%d %.3f %.3f;", r.index, r.lower_speed, r.upper_speed);
+        out += line;
+    }
+    return out;
+}
+
+// The fingerprint a flash copy is matched against at boot.
+static void test_source_fingerprint()
+{
+    std::printf("\n--- Source fingerprint ---\n");
+    const std::vector<uint8_t> blob = fpol::from_json_file(kPolars[0]);
+    fpol::View view;
+    check(fpol::open(blob.data(), blob.size(), view) == fpol::Error::None, "blob opens");
+    uint32_t size = 0, crc = 0;
+    check(fpol::source_fingerprint(kPolars[0], size, crc), "fingerprint read");
+    check(view.header->source_size == size && view.header->source_crc32 == crc && size > 0,
+          "blob records the source size and CRC");
+    check(view.header->install == 0, "converter leaves the install number at 0");
+
+    // The same name with other contents, as after uploading a revised polar.
+    const char* copy = "test_polar_format.json";
+    std::vector<uint8_t> text;
+    if (FILE* f = std::fopen(kPolars[0], "rb"))
+    {
+        uint8_t chunk[256];
+        std::size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) text.insert(text.end(), chunk, chunk + n);
+        std::fclose(f);
+    }
+    text.push_back('\n');
+    write_file(copy, text);
+    uint32_t size2 = 0, crc2 = 0;
+    check(fpol::source_fingerprint(copy, size2, crc2) && size2 == size + 1 && crc2 != crc,
+          "edited source has another fingerprint");
+    std::remove(copy);
+    check(!fpol::source_fingerprint("spiffs_data/missing.json", size2, crc2), "missing source");
+}
+
+static void test_concurrent_reload()
+{
+    std::printf("\n--- Lookups during reloads ---\n");
+    const char* defaut = kPolars[0];
+    write_file(kFpolPath, fpol::from_json_file(kPolars[1]));
+
+    check(flaputils::load_data(kFpolPath), "3T_SE .fpol loads");
+    const std::string bands_3t = bands_520();
+    check(flaputils::load_data(defaut), "defaut JSON loads");
+    const std::string bands_defaut = bands_520();
+    check(bands_3t != bands_defaut, "the two polars differ at 520 kg");
+
+    // 130 km/h at 520 kg is flap 3 in defaut and 4 in 3T_SE.
+    std::atomic<bool> done{false};
+    std::atomic<long> lookups{0}, torn{0};
+    auto reader = [&]
+    {
+        while (!done.load())
+        {
+            const int flap = flaputils::get_optimal_flap(520, 130).index;
+            const std::string bands = bands_520();
+            if ((flap != 3 && flap != 4) || (bands != bands_defaut && bands != bands_3t)) ++torn;
+            ++lookups;
+        }
+    };
+    std::thread readers[3] = {std::thread(reader), std::thread(reader), std::thread(reader)};
+
+    int reloads = 0;
+    for (int i = 0; i < 400; ++i) reloads += flaputils::load_data(i % 2 ? defaut : kFpolPath);
+    done = true;
+    for (std::thread& t : readers) t.join();
+
+    std::printf("%d reloads, %ld lookups, %ld torn\n", reloads, lookups.load(), torn.load());
+    check(reloads == 400 && torn == 0 && lookups > 0, "every lookup saw one whole polar");
+    check(flaputils::get_polar() == "ventus3_defaut.json" &&
+              flaputils::get_optimal_flap(520, 130).index == 3,
+          "last load is active");
+}
+
+int main()
+{
+    test_same_answers();
+    test_rejected();
+    test_source_fingerprint();
+    test_concurrent_reload();
+    std::remove(kFpolPath);
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
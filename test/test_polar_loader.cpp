@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/flaputils.hpp"
+#include "../src/polar_loader.hpp"
+#include "test_support.hpp"
+
+// Background polar loading: a request returns at once, the loader thread
+// loads and persists the polar, a failed load keeps the previous one, and a
+// burst of requests ends on the last polar asked for.
+
+static const char* kNvsFile = ".nvs_simulation";
+static const char* kDefaut = "spiffs_data/ventus3_defaut.json";
+static const char* kOther = "spiffs_data/ventus3_3T_SE.json";
+
+static std::string read_file(const char* path)
+{
+    std::string text;
+    if (FILE* f = std::fopen(path, "rb"))
+    {
+        char chunk[256];
+        std::size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) text.append(chunk, n);
+        std::fclose(f);
+    }
+    return text;
+}
+
+// Waits for request to finish; Idle if it does not within two seconds.
+static polar_loader::State wait_for(uint32_t request)
+{
+    const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < until)
+    {
+        const polar_loader::Status st = polar_loader::status();
+        if (st.request == request && (st.state == polar_loader::State::Loaded || st.state == polar_loader::State::Failed))
+            return st.state;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return polar_loader::State::Idle;
+}
+
+static double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+int main()
+{
+    using polar_loader::State;
+    // The loader persists what it loads; keep the simulator's choice.
+    const std::string saved_nvs = read_file(kNvsFile);
+
+    check(polar_loader::request(kDefaut) == 0, "no request before start()");
+    polar_loader::start();
+    check(polar_loader::status().state == State::Idle, "idle after start()");
+
+    std::printf("\n--- Load and persist ---\n");
+    const uint32_t first = polar_loader::request(kOther);
+    check(first != 0 && wait_for(first) == State::Loaded, "3T_SE loaded");
+    check(flaputils::get_polar() == "ventus3_3T_SE.json" &&
+              flaputils::get_optimal_flap(520, 130).index == 4,
+          "3T_SE is the active polar");
+    check(read_file(kNvsFile) == kOther, "path persisted by the loader");
+
+    std::printf("\n--- Failed load ---\n");
+    const uint32_t missing = polar_loader::request("spiffs_data/missing.json");
+    check(wait_for(missing) == State::Failed, "missing file fails");
+    check(flaputils::get_polar() == "ventus3_3T_SE.json", "previous polar still active");
+    check(read_file(kNvsFile) == kOther, "failed load not persisted");
+    const std::string long_path(200, 'x');
+    check(polar_loader::request(long_path.c_str()) == 0, "overlong path refused");
+
+    std::printf("\n--- Burst of requests ---\n");
+    uint32_t last = 0;
+    for (int i = 0; i < 50; ++i) last = polar_loader::request(i % 2 ? kDefaut : kOther);
+    check(wait_for(last) == State::Loaded, "last request loaded");
+    check(flaputils::get_polar() == "ventus3_defaut.json" &&
+              flaputils::get_optimal_flap(520, 130).index == 3,
+          "last polar asked for is active");
+
+    std::printf("\n--- Cost on the UI side ---\n");
+    // What the select handler used to do, against what it does now.
+    std::vector<double> sync_us, request_us;
+    for (int i = 0; i < 51; ++i)
+    {
+        const char* path = i % 2 ? kDefaut : kOther;
+        auto t0 = std::chrono::steady_clock::now();
+        flaputils::load_data(path);
+        flaputils::save_polar_path(path);
+        sync_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+
+        t0 = std::chrono::steady_clock::now();
+        const uint32_t r = polar_loader::request(path);
+        request_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+        wait_for(r);
+    }
+    std::printf("load_data + save_polar_path: %.1f us, request(): %.1f us (medians)\n", median(sync_us),
+                median(request_us));
+    check(median(request_us) < median(sync_us), "queuing is cheaper than loading");
+
+    polar_loader::stop();
+    check(polar_loader::request(kDefaut) == 0, "no request after stop()");
+
+    if (FILE* f = std::fopen(kNvsFile, "wb"))
+    {
+        std::fwrite(saved_nvs.data(), 1, saved_nvs.size(), f);
+        std::fclose(f);
+    }
+    if (saved_nvs.empty()) std::remove(kNvsFile);
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
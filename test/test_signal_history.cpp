@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "../src/can_ingest.hpp"
+#include "../src/signal_history.hpp"
+#include "test_support.hpp"
+
+// Windowed history statistics (src/signal_history.hpp), checked against a
+// brute-force recomputation over the same window.
+
+static bool near(double a, double b, double tol)
+{
+    return std::fabs(a - b) <= tol * (1.0 + std::fabs(b));
+}
+
+// Reference: least squares over the entries currently in the history.
+template <std::size_t N>
+static bool matches_brute_force(const SignalHistory<N>& h)
+{
+    const SignalStats s = h.stats();
+    const std::size_t n = h.size();
+    if (s.count != n) return false;
+    if (n == 0) return true;
+    double st = 0, sv = 0, stt = 0, stv = 0;
+    float mn = h.at(0).value, mx = mn;
+    const double t0 = h.at(0).t_ms;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double t = h.at(i).t_ms - t0;
+        const double v = h.at(i).value;
+        st += t;
+        sv += v;
+        stt += t * t;
+        stv += t * v;
+        mn = std::min(mn, h.at(i).value);
+        mx = std::max(mx, h.at(i).value);
+    }
+    const double denom = n * stt - st * st;
+    const double slope = (n >= 2 && denom > 0) ? (n * stv - st * sv) / denom * 1000.0 : 0.0;
+    return s.min == mn && s.max == mx && near(s.mean, sv / n, 1e-5) && near(s.slope, slope, 1e-4) &&
+           s.last == h.newest().value && s.span_ms == h.newest().t_ms - h.at(0).t_ms;
+}
+
+static void test_intervals()
+{
+    std::printf("\n--- Interval averaging ---\n");
+    SignalHistory<8> h(1000);
+    check(h.stats().count == 0, "empty history has no stats");
+    check(!h.add(10, 100) && !h.add(20, 600), "samples within one interval stay pending");
+    check(h.add(40, 1100) && h.size() == 1 && h.at(0).value == 15 && h.at(0).t_ms == 350,
+          "next interval commits the mean at the middle of the interval");
+    h.flush();
+    check(h.size() == 2 && h.newest().value == 40, "flush commits the running interval");
+
+    const SignalStats s = h.stats();
+    check(s.min == 15 && s.max == 40 && s.mean == 27.5f, "min, max and mean");
+    check(near(s.slope, 25.0 / 0.75, 1e-6), "slope in units per second");
+}
+
+static void test_window()
+{
+    std::printf("\n--- Window limits ---\n");
+    SignalHistory<5> h(1000);
+    for (uint32_t i = 0; i < 12; ++i) h.add(static_cast<float>(i), i * 1000);
+    check(h.size() == 5 && h.at(0).value == 6 && h.newest().value == 10, "capacity keeps the newest entries");
+    check(h.stats().min == 6 && h.stats().max == 10, "evicted extremes leave the window");
+
+    h.add(50, 30000); // 19 s gap
+    h.flush();
+    check(h.size() == 1 && h.stats().mean == 50, "entries older than the window dropped after a gap");
+
+    h.clear();
+    check(h.empty() && h.stats().count == 0, "clear");
+}
+
+static void test_random_walk()
+{
+    std::printf("\n--- Random walk against brute force ---\n");
+    std::mt19937 rng(7);
+    std::normal_distribution<float> step(0.0f, 0.8f);
+    std::uniform_int_distribution<uint32_t> dt(20, 80);
+    std::uniform_int_distribution<int> gap(0, 400);
+
+    SignalHistory<60> h(500);
+    float v = 1200;
+    uint32_t t = 3000000000u; // crosses the 32-bit wrap of the millisecond clock
+    bool ok = true;
+    uint32_t commits = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        v += step(rng);
+        t += dt(rng);
+        if (gap(rng) == 0) t += 20000;
+        if (h.add(v, t))
+        {
+            ++commits;
+            if (!matches_brute_force(h)) ok = false;
+        }
+    }
+    std::printf("%u commits\n", commits);
+    check(ok, "every commit matches the recomputed window");
+}
+
+static void test_linear_trend()
+{
+    std::printf("\n--- Linear trend ---\n");
+    SignalHistory<300> h(1000);
+    for (uint32_t ms = 0; ms < 600000; ms += 50) h.add(100.0f + 2.5f * ms / 1000.0f, ms);
+    h.flush();
+    const SignalStats s = h.stats();
+    check(h.size() == 300 && near(s.slope, 2.5, 1e-4), "constant climb gives its rate as slope");
+    check(s.span_ms >= 298000 && s.span_ms < 300000, "window spans five minutes");
+}
+
+static void test_flight_history()
+{
+    std::printf("\n--- FlightHistory ---\n");
+    FlightData data;
+    CanIngest ingest(data);
+    static FlightHistory history;
+    ingest.set_history(&history);
+
+    // ID 354 (vario), FLOAT, 1.5 m/s then 2.5 m/s.
+    const uint8_t v15[8] = {0, 2, 0, 0, 0x3F, 0xC0, 0, 0};
+    const uint8_t v25[8] = {0, 2, 0, 1, 0x40, 0x20, 0, 0};
+    ingest.ingest(354, 8, v15, 1000);
+    check(history.stats(FlightSignal::Vario).count == 0, "nothing published inside the first interval");
+    ingest.ingest(354, 8, v25, 2000);
+    ingest.ingest(354, 8, v25, 3000);
+    const SignalStats s = history.stats(FlightSignal::Vario);
+    check(s.count == 2 && s.min == 1.5f && s.max == 2.5f && s.mean == 2.0f, "vario samples reach the history");
+    check(near(s.slope, 1.0, 1e-6), "vario trend");
+    check(history.stats(FlightSignal::Tas).count == 0 && !history.history(FlightSignal::Tas), "TAS is not tracked");
+    std::printf("FlightHistory: %zu bytes\n", sizeof(FlightHistory));
+    check(sizeof(FlightHistory) < 24 * 1024, "fits the internal RAM budget");
+}
+
+static void bench()
+{
+    std::printf("\n--- Cost per sample ---\n");
+    static SignalHistory<300> h(1000);
+    constexpr uint32_t kSamples = 5000000;
+    float v = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kSamples; ++i)
+    {
+        v += (i & 1) ? 0.25f : -0.2f;
+        h.add(v, i * 40); // 25 Hz
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kSamples;
+
+    constexpr int kReads = 100000;
+    float sink = 0;
+    const auto r0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kReads; ++i) sink += h.stats().slope;
+    const double read_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - r0).count() / kReads;
+    std::printf("%.1f ns per sample, %.1f ns per stats() read (%g)\n", ns, read_ns, sink);
+    check(ns < 200, "add() stays cheap with a full window");
+}
+
+int main()
+{
+    test_intervals();
+    test_window();
+    test_random_walk();
+    test_linear_trend();
+    test_flight_history();
+    bench();
+
+    std::printf("\n=== TEST SUMMARY: %s (fails=%d) ===\n", (fails == 0) ? "PASS" : "FAIL", fails);
+    return fails;
+}
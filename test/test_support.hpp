@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "../src/can_decoder.hpp"
+
+// Helpers shared by the test programs in this directory. Each test is its
+// own executable: `fails` counts the failed checks of that program, which
+// prints it in its TEST SUMMARY line and returns it.
+
+inline int fails = 0;
+
+inline void check(bool ok, const char* what)
+{
+    if (!ok) ++fails;
+    std::printf("%s: %s\n", ok ? "OK" : "NOK", what);
+}
+
+// Difference between two directions in degrees, 0..180.
+inline float angle_diff(float a, float b)
+{
+    const float d = std::fabs(a - b);
+    return d > 180 ? 360 - d : d;
+}
+
+// CANaerospace frame from node 1, service code 0: 4 header bytes, then the
+// value big-endian in bytes 4..7.
+inline void make_frame(uint8_t* frame, CanAerospaceType type, uint8_t code, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    frame[0] = 1; // node id
+    frame[1] = static_cast<uint8_t>(type);
+    frame[2] = 0; // service code
+    frame[3] = code;
+    frame[4] = static_cast<uint8_t>(bits >> 24);
+    frame[5] = static_cast<uint8_t>(bits >> 16);
+    frame[6] = static_cast<uint8_t>(bits >> 8);
+    frame[7] = static_cast<uint8_t>(bits);
+}